@@ -21,15 +21,128 @@ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
-
 #include "allocator.h"
 
+#include <intrin.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+#define ALLOCATOR_CLASS_COUNT       7
+#define ALLOCATOR_MIN_CLASS_SIZE    32
+#define ALLOCATOR_MAX_CLASS_SIZE    (ALLOCATOR_MIN_CLASS_SIZE << (ALLOCATOR_CLASS_COUNT - 1))
+
+#define ALLOCATOR_CLASS_LARGE       ALLOCATOR_CLASS_COUNT
+
+#define ALLOCATOR_SLAB_SIZE         (64 * 1024)
+#define ALLOCATOR_CACHE_SIZE        32
+
+#define ALLOCATOR_DUMP_TAG_COUNT    64
+#define ALLOCATOR_DUMP_LINE_LENGTH  256
+
+#define CELLSIZE(CLASS)             (sizeof(chunk) + (ALLOCATOR_MIN_CLASS_SIZE << (CLASS)))
+#define CELLCOUNT(CLASS)            ((DWORD)((ALLOCATOR_SLAB_SIZE - SLABHEADER) / CELLSIZE(CLASS)))
+
+#define SLABHEADER                  ((sizeof(slab) + sizeof(chunk) - 1) / sizeof(chunk) * sizeof(chunk))
+#define SLAB(X)                     ((slab*)((size_t)(X) & ~((size_t)ALLOCATOR_SLAB_SIZE - 1)))
+
+#define CHUNK(X)                    ((chunk*)((size_t)(X) - sizeof(chunk)))
+#define CHUNKDATA(X)                ((LPVOID)((size_t)(X) + sizeof(chunk)))
+
+#define RECORD(X)                   ((record*)((size_t)(X) - sizeof(record)))
+#define RECORDDATA(X)               ((LPVOID)((size_t)(X) + sizeof(record)))
+
+#define ALIGNED(X, ALIGNMENT)       (((size_t)(X) + (ALIGNMENT) - 1) & ~((size_t)(ALIGNMENT) - 1))
+#define ALIGNEDBASE(X)              (((LPVOID*)(X))[-1])
+
+// Every allocation is preceded by a chunk header, which records where the memory came from.
+// The header doubles as the free list entry once the memory is released to its size class.
+typedef union chunk {
+    SLIST_ENTRY     Entry;
+    struct {
+        DWORD       Class;
+        DWORD       Bytes;
+    };
+    BYTE            Alignment[MEMORY_ALLOCATION_ALIGNMENT];
+} chunk;
+
+// When tracking is enabled, every allocation is additionally preceded by a record,
+// which links it into the list of outstanding allocations together with its call site.
+typedef union record {
+    struct {
+        union record*   Next;
+        union record*   Previous;
+        LPVOID          Tag;
+        DWORD           Bytes;
+    };
+    BYTE                Alignment[2 * MEMORY_ALLOCATION_ALIGNMENT];
+} record;
+
+// Slabs are allocated at the allocation granularity of the system,
+// so the slab of a cell is found by masking the address of the cell.
+typedef struct slab {
+    struct slab*    Next;
+    DWORD           Class;
+    DWORD           Free;
+} slab;
+
+typedef struct sizeclass {
+    SLIST_HEADER    Free;
+} sizeclass;
+
+typedef struct tag {
+    LPVOID          Tag;
+    DWORD           Count;
+    DWORD64         Bytes;
+} tag;
+
+// Small objects are served from per-class slabs.
+// Each thread keeps a few released cells of the allocator it used last, so that
+// the common create and release churn neither takes a lock nor touches the shared free lists.
 struct allocator {
-    HANDLE Heap;
-    // TODO Collect statistics such as allocation count, and allocation info
+    sizeclass           Classes[ALLOCATOR_CLASS_COUNT];
+
+    HANDLE              Heap;
+    DWORD               Flags;
+    LONG                ID;
+
+    CRITICAL_SECTION    Lock;
+    slab*               Slabs;
+    record*             Records;
+
+    // The counters are only ever read for reporting, so they are updated without ordering.
+    volatile LONG64     LiveBytes;
+    volatile LONG64     PeakBytes;
+    volatile LONG64     Allocations;
+    volatile LONG64     Frees;
+    volatile LONG64     Histogram[ALLOCATOR_HISTOGRAM_SIZE];
 };
 
-HRESULT DELTACALL allocator_create(allocator** ppAlloc) {
+typedef struct cache {
+    LONG            Owner;
+    DWORD           Count;
+    DWORD           Counts[ALLOCATOR_CLASS_COUNT];
+    chunk*          Items[ALLOCATOR_CLASS_COUNT][ALLOCATOR_CACHE_SIZE];
+} cache;
+
+static volatile LONG Allocators;
+static __declspec(thread) cache Cache;
+
+HRESULT DELTACALL allocator_allocate_tagged(allocator* pAlloc, DWORD dwBytes, LPVOID pTag, LPVOID* ppMem);
+HRESULT DELTACALL allocator_get_class(DWORD dwBytes, LPDWORD pdwClass);
+HRESULT DELTACALL allocator_allocate_cell(allocator* pAlloc, DWORD dwClass, chunk** ppChunk);
+HRESULT DELTACALL allocator_free_cell(allocator* pAlloc, chunk* pChunk);
+HRESULT DELTACALL allocator_allocate_slab(allocator* pAlloc, DWORD dwClass);
+HRESULT DELTACALL allocator_allocate_memory(allocator* pAlloc, DWORD dwBytes, LPVOID* ppMem);
+HRESULT DELTACALL allocator_reallocate_memory(allocator* pAlloc, LPVOID pMem, DWORD dwBytes, LPVOID* ppMem);
+HRESULT DELTACALL allocator_free_memory(allocator* pAlloc, LPVOID pMem);
+HRESULT DELTACALL allocator_get_size(allocator* pAlloc, LPVOID pMem, LPDWORD pdwBytes);
+VOID DELTACALL allocator_link_record(allocator* pAlloc, record* pRecord);
+VOID DELTACALL allocator_unlink_record(allocator* pAlloc, record* pRecord);
+VOID DELTACALL allocator_count_allocation(allocator* pAlloc, DWORD dwBytes);
+VOID DELTACALL allocator_count_bytes(allocator* pAlloc, LONG64 llBytes);
+VOID DELTACALL allocator_print(LPCSTR pszFormat, ...);
+
+HRESULT DELTACALL allocator_create(DWORD dwFlags, allocator** ppAlloc) {
     if (ppAlloc == NULL) {
         return E_INVALIDARG;
     }
@@ -49,6 +162,25 @@ HRESULT DELTACALL allocator_create(allocator** ppAlloc) {
     ZeroMemory(alloc, sizeof(allocator));
 
     alloc->Heap = heap;
+    alloc->Flags = dwFlags;
+    alloc->ID = InterlockedIncrement(&Allocators);
+
+    // The large sample storage lives in a private heap,
+    // so it does not contend with the allocations of the application.
+    if (dwFlags & ALLOCATOR_CREATE_SLAB) {
+        alloc->Heap = HeapCreate(0, 0, 0);
+
+        if (alloc->Heap == NULL) {
+            HeapFree(heap, 0, alloc);
+            return E_OUTOFMEMORY;
+        }
+
+        for (DWORD i = 0; i < ALLOCATOR_CLASS_COUNT; i++) {
+            InitializeSListHead(&alloc->Classes[i].Free);
+        }
+    }
+
+    InitializeCriticalSection(&alloc->Lock);
 
     *ppAlloc = alloc;
 
@@ -58,9 +190,29 @@ HRESULT DELTACALL allocator_create(allocator** ppAlloc) {
 VOID DELTACALL allocator_release(allocator* self) {
     if (self == NULL) { return; }
 
-    // TODO LOG Memory leaks
+    if (ReadNoFence64(&self->Allocations) != ReadNoFence64(&self->Frees)) {
+        allocator_dump(self);
+    }
+
+    if (self->Flags & ALLOCATOR_CREATE_SLAB) {
+        if (Cache.Owner == self->ID) {
+            ZeroMemory(&Cache, sizeof(cache));
+        }
+
+        while (self->Slabs != NULL) {
+            slab* item = self->Slabs;
+            self->Slabs = item->Next;
+
+            VirtualFree(item, 0, MEM_RELEASE);
+        }
+
+        // The large allocations are all released with the heap.
+        HeapDestroy(self->Heap);
+    }
+
+    DeleteCriticalSection(&self->Lock);
 
-    HeapFree(self->Heap, 0, self);
+    HeapFree(GetProcessHeap(), 0, self);
 }
 
 HRESULT DELTACALL allocator_allocate(allocator* self, DWORD dwBytes, LPVOID* ppMem) {
@@ -72,44 +224,134 @@ HRESULT DELTACALL allocator_allocate(allocator* self, DWORD dwBytes, LPVOID* ppM
         return E_INVALIDARG;
     }
 
-    // TODO Collect allocation stats
+    return allocator_allocate_tagged(self, dwBytes, _ReturnAddress(), ppMem);
+}
 
-    LPVOID memory = HeapAlloc(self->Heap, 0, dwBytes);
+HRESULT DELTACALL allocator_reallocate(allocator* self, LPVOID pMem, DWORD dwBytes, LPVOID* ppMem) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
 
-    if (memory == NULL) {
-        return E_OUTOFMEMORY;
+    if (pMem == NULL || ppMem == NULL) {
+        return E_INVALIDARG;
     }
 
-    ZeroMemory(memory, dwBytes);
+    rtc_check("Reallocation", _ReturnAddress());
+
+    HRESULT hr = S_OK;
+    LPVOID memory = NULL;
+    DWORD bytes = 0;
+
+    if (self->Flags & ALLOCATOR_CREATE_TRACK) {
+        if (MAXDWORD - sizeof(record) < dwBytes) {
+            return E_OUTOFMEMORY;
+        }
+
+        record* item = RECORD(pMem);
+
+        bytes = item->Bytes;
+
+        // The record may move, so it leaves the list for the duration of the reallocation.
+        EnterCriticalSection(&self->Lock);
+
+        allocator_unlink_record(self, item);
+
+        if (SUCCEEDED(hr = allocator_reallocate_memory(self, item, sizeof(record) + dwBytes, &memory))) {
+            item = (record*)memory;
+            item->Bytes = dwBytes;
+        }
+
+        allocator_link_record(self, item);
+
+        LeaveCriticalSection(&self->Lock);
+
+        if (FAILED(hr)) {
+            return hr;
+        }
+
+        memory = RECORDDATA(item);
+    }
+    else {
+        allocator_get_size(self, pMem, &bytes);
+
+        if (FAILED(hr = allocator_reallocate_memory(self, pMem, dwBytes, &memory))) {
+            return hr;
+        }
+    }
+
+    allocator_count_bytes(self, (LONG64)dwBytes - (LONG64)bytes);
 
     *ppMem = memory;
 
     return S_OK;
 }
 
-HRESULT DELTACALL allocator_reallocate(allocator* self, LPVOID pMem, DWORD dwBytes, LPVOID* ppMem) {
+HRESULT DELTACALL allocator_free(allocator* self, LPVOID pMem) {
     if (self == NULL) {
         return E_POINTER;
     }
 
-    if (pMem == NULL || ppMem == NULL) {
+    if (pMem == NULL) {
         return E_INVALIDARG;
     }
 
-    // TODO Collect allocation stats
+    rtc_check("Free", _ReturnAddress());
+
+    DWORD bytes = 0;
+
+    if (self->Flags & ALLOCATOR_CREATE_TRACK) {
+        record* item = RECORD(pMem);
+
+        bytes = item->Bytes;
+
+        EnterCriticalSection(&self->Lock);
+        allocator_unlink_record(self, item);
+        LeaveCriticalSection(&self->Lock);
+
+        pMem = item;
+    }
+    else {
+        allocator_get_size(self, pMem, &bytes);
+    }
+
+    InterlockedIncrementNoFence64(&self->Frees);
+
+    allocator_count_bytes(self, -(LONG64)bytes);
 
-    LPVOID memory = HeapReAlloc(self->Heap, 0, pMem, dwBytes);
+    return allocator_free_memory(self, pMem);
+}
 
-    if (memory == NULL) {
+HRESULT DELTACALL allocator_allocate_aligned(allocator* self, DWORD dwBytes, DWORD dwAlignment, LPVOID* ppMem) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (dwAlignment == 0 || (dwAlignment & (dwAlignment - 1)) != 0 || ppMem == NULL) {
+        return E_INVALIDARG;
+    }
+
+    // The address of the underlying allocation is kept right in front of the aligned memory.
+    const DWORD padding = dwAlignment - 1 + sizeof(LPVOID);
+
+    if (MAXDWORD - padding < dwBytes) {
         return E_OUTOFMEMORY;
     }
 
-    *ppMem = memory;
+    HRESULT hr = S_OK;
+    LPVOID memory = NULL;
 
-    return S_OK;
+    if (SUCCEEDED(hr = allocator_allocate_tagged(self, padding + dwBytes, _ReturnAddress(), &memory))) {
+        LPVOID aligned = (LPVOID)ALIGNED((size_t)memory + sizeof(LPVOID), dwAlignment);
+
+        ALIGNEDBASE(aligned) = memory;
+
+        *ppMem = aligned;
+    }
+
+    return hr;
 }
 
-HRESULT DELTACALL allocator_free(allocator* self, LPVOID pMem) {
+HRESULT DELTACALL allocator_free_aligned(allocator* self, LPVOID pMem) {
     if (self == NULL) {
         return E_POINTER;
     }
@@ -118,7 +360,536 @@ HRESULT DELTACALL allocator_free(allocator* self, LPVOID pMem) {
         return E_INVALIDARG;
     }
 
-    // TODO Collect release stats
+    return allocator_free(self, ALIGNEDBASE(pMem));
+}
+
+HRESULT DELTACALL allocator_trim(allocator* self, LPDWORD pdwBytes) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    DWORD bytes = 0;
+
+    if (self->Flags & ALLOCATOR_CREATE_SLAB) {
+        EnterCriticalSection(&self->Lock);
+
+        // The cells cached by this thread go back to their classes, so that their slabs can be released too.
+        if (Cache.Owner == self->ID) {
+            for (DWORD i = 0; i < ALLOCATOR_CLASS_COUNT; i++) {
+                for (DWORD k = 0; k < Cache.Counts[i]; k++) {
+                    InterlockedPushEntrySList(&self->Classes[i].Free, &Cache.Items[i][k]->Entry);
+                }
+
+                Cache.Counts[i] = 0;
+            }
+
+            Cache.Count = 0;
+        }
+
+        for (slab* item = self->Slabs; item != NULL; item = item->Next) {
+            item->Free = 0;
+        }
+
+        // The free lists are taken over while the lock is held, threads that run out of cells wait for the lock.
+        PSLIST_ENTRY cells[ALLOCATOR_CLASS_COUNT];
+
+        for (DWORD i = 0; i < ALLOCATOR_CLASS_COUNT; i++) {
+            cells[i] = InterlockedFlushSList(&self->Classes[i].Free);
+
+            for (PSLIST_ENTRY item = cells[i]; item != NULL; item = item->Next) {
+                SLAB(item)->Free++;
+            }
+        }
+
+        for (DWORD i = 0; i < ALLOCATOR_CLASS_COUNT; i++) {
+            PSLIST_ENTRY item = cells[i];
+
+            while (item != NULL) {
+                PSLIST_ENTRY next = item->Next;
+
+                if (SLAB(item)->Free != CELLCOUNT(i)) {
+                    InterlockedPushEntrySList(&self->Classes[i].Free, item);
+                }
+
+                item = next;
+            }
+        }
+
+        // Slabs with all of their cells free are returned to the system.
+        // A concurrent pop may still read the link of a released cell, the system recovers such pops and retries them.
+        slab** link = &self->Slabs;
+
+        while (*link != NULL) {
+            slab* item = *link;
+
+            if (item->Free == CELLCOUNT(item->Class)) {
+                *link = item->Next;
+
+                VirtualFree(item, 0, MEM_RELEASE);
+
+                bytes += ALLOCATOR_SLAB_SIZE;
+            }
+            else {
+                link = &item->Next;
+            }
+        }
+
+        LeaveCriticalSection(&self->Lock);
+
+        HeapCompact(self->Heap, 0);
+    }
+
+    if (pdwBytes != NULL) {
+        *pdwBytes = bytes;
+    }
+
+    return S_OK;
+}
+
+HRESULT DELTACALL allocator_get_stats(allocator* self, allocator_stats* pStats) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (pStats == NULL) {
+        return E_INVALIDARG;
+    }
+
+    pStats->LiveBytes = (DWORD64)ReadNoFence64(&self->LiveBytes);
+    pStats->PeakBytes = (DWORD64)ReadNoFence64(&self->PeakBytes);
+    pStats->Allocations = (DWORD64)ReadNoFence64(&self->Allocations);
+    pStats->Frees = (DWORD64)ReadNoFence64(&self->Frees);
+
+    for (DWORD i = 0; i < ALLOCATOR_HISTOGRAM_SIZE; i++) {
+        pStats->Histogram[i] = (DWORD64)ReadNoFence64(&self->Histogram[i]);
+    }
+
+    return S_OK;
+}
+
+HRESULT DELTACALL allocator_dump(allocator* self) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    allocator_stats stats;
+    allocator_get_stats(self, &stats);
+
+    allocator_print("DeltaSound: %llu byte(s) outstanding in %lld allocation(s), peak %llu byte(s).\r\n",
+        stats.LiveBytes, (LONG64)(stats.Allocations - stats.Frees), stats.PeakBytes);
+
+    allocator_print("DeltaSound: %llu allocation(s), %llu free(s), sizes "
+        "32: %llu, 64: %llu, 128: %llu, 256: %llu, 512: %llu, 1024: %llu, 2048: %llu, larger: %llu.\r\n",
+        stats.Allocations, stats.Frees, stats.Histogram[0], stats.Histogram[1], stats.Histogram[2],
+        stats.Histogram[3], stats.Histogram[4], stats.Histogram[5], stats.Histogram[6], stats.Histogram[7]);
+
+    if (!(self->Flags & ALLOCATOR_CREATE_TRACK)) {
+        return S_OK;
+    }
+
+    // The dump may run while the process is terminating, when a thread that held the lock is already gone.
+    if (!TryEnterCriticalSection(&self->Lock)) {
+        return S_FALSE;
+    }
+
+    // Outstanding allocations are grouped by call site, the ones that do not fit are reported together.
+    tag tags[ALLOCATOR_DUMP_TAG_COUNT + 1];
+    ZeroMemory(tags, sizeof(tags));
+
+    DWORD count = 0;
+
+    for (record* item = self->Records; item != NULL; item = item->Next) {
+        DWORD index = 0;
+
+        while (index < count && tags[index].Tag != item->Tag) {
+            index++;
+        }
+
+        if (index == count) {
+            if (count < ALLOCATOR_DUMP_TAG_COUNT) {
+                tags[index].Tag = item->Tag;
+                count++;
+            }
+            else {
+                index = ALLOCATOR_DUMP_TAG_COUNT;
+            }
+        }
+
+        tags[index].Count++;
+        tags[index].Bytes += item->Bytes;
+    }
+
+    LeaveCriticalSection(&self->Lock);
+
+    for (DWORD i = 0; i <= ALLOCATOR_DUMP_TAG_COUNT; i++) {
+        if (tags[i].Count == 0) {
+            continue;
+        }
+
+        CHAR name[MAX_PATH] = "unknown";
+        HMODULE module = NULL;
+
+        if (tags[i].Tag != NULL && GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS
+            | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, (LPCSTR)tags[i].Tag, &module)) {
+            GetModuleFileNameA(module, name, MAX_PATH);
+        }
+
+        LPCSTR file = name;
+
+        for (LPCSTR c = name; *c != '\0'; c++) {
+            if (*c == '\\' || *c == '/') {
+                file = c + 1;
+            }
+        }
+
+        if (tags[i].Tag == NULL) {
+            allocator_print("DeltaSound: %llu byte(s) in %u allocation(s) at other call sites.\r\n",
+                tags[i].Bytes, tags[i].Count);
+        }
+        else {
+            allocator_print("DeltaSound: %llu byte(s) in %u allocation(s) at %s+0x%llX.\r\n",
+                tags[i].Bytes, tags[i].Count, file, (DWORD64)((size_t)tags[i].Tag - (size_t)module));
+        }
+    }
+
+    return S_OK;
+}
+
+/* ---------------------------------------------------------------------- */
+
+HRESULT DELTACALL allocator_allocate_tagged(allocator* self, DWORD dwBytes, LPVOID pTag, LPVOID* ppMem) {
+    HRESULT hr = S_OK;
+    LPVOID memory = NULL;
+
+    rtc_check("Allocation", pTag);
+
+    if (self->Flags & ALLOCATOR_CREATE_TRACK) {
+        if (MAXDWORD - sizeof(record) < dwBytes) {
+            return E_OUTOFMEMORY;
+        }
+
+        if (FAILED(hr = allocator_allocate_memory(self, sizeof(record) + dwBytes, &memory))) {
+            return hr;
+        }
+
+        record* item = (record*)memory;
+
+        item->Tag = pTag;
+        item->Bytes = dwBytes;
+
+        EnterCriticalSection(&self->Lock);
+        allocator_link_record(self, item);
+        LeaveCriticalSection(&self->Lock);
+
+        memory = RECORDDATA(item);
+    }
+    else if (FAILED(hr = allocator_allocate_memory(self, dwBytes, &memory))) {
+        return hr;
+    }
+
+    allocator_count_allocation(self, dwBytes);
+
+    *ppMem = memory;
+
+    return S_OK;
+}
+
+HRESULT DELTACALL allocator_get_class(DWORD dwBytes, LPDWORD pdwClass) {
+    if (ALLOCATOR_MAX_CLASS_SIZE < dwBytes) {
+        *pdwClass = ALLOCATOR_CLASS_LARGE;
+        return S_FALSE;
+    }
+
+    if (dwBytes <= ALLOCATOR_MIN_CLASS_SIZE) {
+        *pdwClass = 0;
+        return S_OK;
+    }
+
+    DWORD index = 0;
+    _BitScanReverse(&index, dwBytes - 1);
+
+    *pdwClass = index - 4;
+
+    return S_OK;
+}
+
+HRESULT DELTACALL allocator_allocate_cell(allocator* self, DWORD dwClass, chunk** ppChunk) {
+    if (Cache.Owner == self->ID && Cache.Counts[dwClass] != 0) {
+        Cache.Count--;
+        Cache.Counts[dwClass]--;
+
+        *ppChunk = Cache.Items[dwClass][Cache.Counts[dwClass]];
+
+        return S_OK;
+    }
+
+    HRESULT hr = S_OK;
+
+    while (TRUE) {
+        chunk* item = (chunk*)InterlockedPopEntrySList(&self->Classes[dwClass].Free);
+
+        if (item != NULL) {
+            *ppChunk = item;
+            return S_OK;
+        }
+
+        if (FAILED(hr = allocator_allocate_slab(self, dwClass))) {
+            return hr;
+        }
+    }
+}
+
+HRESULT DELTACALL allocator_free_cell(allocator* self, chunk* pChunk) {
+    const DWORD type = pChunk->Class;
+
+    // A thread with an empty cache starts caching for the allocator it releases to.
+    if (Cache.Owner != self->ID && Cache.Count == 0) {
+        Cache.Owner = self->ID;
+    }
+
+    if (Cache.Owner == self->ID) {
+        if (Cache.Counts[type] == ALLOCATOR_CACHE_SIZE) {
+            for (DWORD i = ALLOCATOR_CACHE_SIZE / 2; i < ALLOCATOR_CACHE_SIZE; i++) {
+                InterlockedPushEntrySList(&self->Classes[type].Free, &Cache.Items[type][i]->Entry);
+            }
+
+            Cache.Count -= ALLOCATOR_CACHE_SIZE / 2;
+            Cache.Counts[type] = ALLOCATOR_CACHE_SIZE / 2;
+        }
+
+        Cache.Items[type][Cache.Counts[type]] = pChunk;
+
+        Cache.Count++;
+        Cache.Counts[type]++;
+
+        return S_OK;
+    }
+
+    InterlockedPushEntrySList(&self->Classes[type].Free, &pChunk->Entry);
+
+    return S_OK;
+}
+
+HRESULT DELTACALL allocator_allocate_slab(allocator* self, DWORD dwClass) {
+    EnterCriticalSection(&self->Lock);
+
+    // Another thread may have refilled the class while this one was waiting.
+    if (QueryDepthSList(&self->Classes[dwClass].Free) != 0) {
+        LeaveCriticalSection(&self->Lock);
+        return S_OK;
+    }
+
+    slab* instance = VirtualAlloc(NULL, ALLOCATOR_SLAB_SIZE, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+
+    if (instance == NULL) {
+        LeaveCriticalSection(&self->Lock);
+        return E_OUTOFMEMORY;
+    }
+
+    instance->Next = self->Slabs;
+    instance->Class = dwClass;
+
+    self->Slabs = instance;
+
+    const size_t size = CELLSIZE(dwClass);
+    const size_t start = (size_t)instance + SLABHEADER;
+
+    for (DWORD i = 0; i < CELLCOUNT(dwClass); i++) {
+        InterlockedPushEntrySList(&self->Classes[dwClass].Free, (PSLIST_ENTRY)(start + i * size));
+    }
+
+    LeaveCriticalSection(&self->Lock);
+
+    return S_OK;
+}
+
+HRESULT DELTACALL allocator_allocate_memory(allocator* self, DWORD dwBytes, LPVOID* ppMem) {
+    if (!(self->Flags & ALLOCATOR_CREATE_SLAB)) {
+        LPVOID memory = HeapAlloc(self->Heap, 0, dwBytes);
+
+        if (memory == NULL) {
+            return E_OUTOFMEMORY;
+        }
+
+        ZeroMemory(memory, dwBytes);
+
+        *ppMem = memory;
+
+        return S_OK;
+    }
+
+    HRESULT hr = S_OK;
+    DWORD type = ALLOCATOR_CLASS_LARGE;
+    chunk* memory = NULL;
+
+    allocator_get_class(dwBytes, &type);
+
+    if (type == ALLOCATOR_CLASS_LARGE) {
+        memory = HeapAlloc(self->Heap, HEAP_ZERO_MEMORY, sizeof(chunk) + dwBytes);
+
+        if (memory == NULL) {
+            return E_OUTOFMEMORY;
+        }
+    }
+    else {
+        if (FAILED(hr = allocator_allocate_cell(self, type, &memory))) {
+            return hr;
+        }
+
+        ZeroMemory(CHUNKDATA(memory), dwBytes);
+    }
+
+    memory->Class = type;
+    memory->Bytes = dwBytes;
+
+    *ppMem = CHUNKDATA(memory);
+
+    return S_OK;
+}
+
+HRESULT DELTACALL allocator_reallocate_memory(allocator* self, LPVOID pMem, DWORD dwBytes, LPVOID* ppMem) {
+    if (!(self->Flags & ALLOCATOR_CREATE_SLAB)) {
+        LPVOID memory = HeapReAlloc(self->Heap, 0, pMem, dwBytes);
+
+        if (memory == NULL) {
+            return E_OUTOFMEMORY;
+        }
+
+        *ppMem = memory;
+
+        return S_OK;
+    }
+
+    chunk* item = CHUNK(pMem);
+
+    if (item->Class == ALLOCATOR_CLASS_LARGE) {
+        chunk* memory = HeapReAlloc(self->Heap, 0, item, sizeof(chunk) + dwBytes);
+
+        if (memory == NULL) {
+            return E_OUTOFMEMORY;
+        }
+
+        memory->Bytes = dwBytes;
+
+        *ppMem = CHUNKDATA(memory);
+
+        return S_OK;
+    }
+
+    if (dwBytes <= (ALLOCATOR_MIN_CLASS_SIZE << item->Class)) {
+        item->Bytes = dwBytes;
+
+        *ppMem = pMem;
+
+        return S_OK;
+    }
+
+    HRESULT hr = S_OK;
+    LPVOID memory = NULL;
+
+    if (SUCCEEDED(hr = allocator_allocate_memory(self, dwBytes, &memory))) {
+        CopyMemory(memory, pMem, min(item->Bytes, dwBytes));
+
+        allocator_free_cell(self, item);
+
+        *ppMem = memory;
+    }
+
+    return hr;
+}
+
+HRESULT DELTACALL allocator_free_memory(allocator* self, LPVOID pMem) {
+    if (!(self->Flags & ALLOCATOR_CREATE_SLAB)) {
+        return HeapFree(self->Heap, 0, pMem) ? S_OK : E_FAIL;
+    }
+
+    chunk* item = CHUNK(pMem);
+
+    if (item->Class == ALLOCATOR_CLASS_LARGE) {
+        return HeapFree(self->Heap, 0, item) ? S_OK : E_FAIL;
+    }
+
+    return allocator_free_cell(self, item);
+}
+
+HRESULT DELTACALL allocator_get_size(allocator* self, LPVOID pMem, LPDWORD pdwBytes) {
+    if (self->Flags & ALLOCATOR_CREATE_SLAB) {
+        *pdwBytes = CHUNK(pMem)->Bytes;
+        return S_OK;
+    }
+
+    const SIZE_T size = HeapSize(self->Heap, 0, pMem);
+
+    if (size == (SIZE_T)-1) {
+        *pdwBytes = 0;
+        return E_FAIL;
+    }
+
+    *pdwBytes = (DWORD)size;
+
+    return S_OK;
+}
+
+VOID DELTACALL allocator_link_record(allocator* self, record* pRecord) {
+    pRecord->Previous = NULL;
+    pRecord->Next = self->Records;
+
+    if (self->Records != NULL) {
+        self->Records->Previous = pRecord;
+    }
+
+    self->Records = pRecord;
+}
+
+VOID DELTACALL allocator_unlink_record(allocator* self, record* pRecord) {
+    if (pRecord->Previous != NULL) {
+        pRecord->Previous->Next = pRecord->Next;
+    }
+    else {
+        self->Records = pRecord->Next;
+    }
+
+    if (pRecord->Next != NULL) {
+        pRecord->Next->Previous = pRecord->Previous;
+    }
+}
+
+VOID DELTACALL allocator_count_allocation(allocator* self, DWORD dwBytes) {
+    DWORD type = ALLOCATOR_CLASS_LARGE;
+    allocator_get_class(dwBytes, &type);
+
+    InterlockedIncrementNoFence64(&self->Allocations);
+    InterlockedIncrementNoFence64(&self->Histogram[type]);
+
+    allocator_count_bytes(self, dwBytes);
+}
+
+VOID DELTACALL allocator_count_bytes(allocator* self, LONG64 llBytes) {
+    const LONG64 live = InterlockedExchangeAddNoFence64(&self->LiveBytes, llBytes) + llBytes;
+
+    LONG64 peak = ReadNoFence64(&self->PeakBytes);
+
+    while (peak < live) {
+        const LONG64 value = InterlockedCompareExchangeNoFence64(&self->PeakBytes, live, peak);
+
+        if (value == peak) {
+            break;
+        }
+
+        peak = value;
+    }
+}
+
+VOID DELTACALL allocator_print(LPCSTR pszFormat, ...) {
+    CHAR line[ALLOCATOR_DUMP_LINE_LENGTH];
+
+    va_list args;
+    va_start(args, pszFormat);
+
+    vsnprintf(line, ALLOCATOR_DUMP_LINE_LENGTH, pszFormat, args);
+    line[ALLOCATOR_DUMP_LINE_LENGTH - 1] = '\0';
+
+    va_end(args);
 
-    return HeapFree(self->Heap, 0, pMem) ? S_OK : E_FAIL;
+    OutputDebugStringA(line);
 }
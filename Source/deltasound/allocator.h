@@ -25,12 +25,42 @@ SOFTWARE.
 #pragma once
 
 #include "base.h"
+#include "rtc.h"
+
+#define ALLOCATOR_CREATE_NONE   0
+#define ALLOCATOR_CREATE_SLAB   1
+#define ALLOCATOR_CREATE_TRACK  2
+
+#define ALLOCATOR_CACHE_LINE_SIZE   64
+
+// Sample storage is aligned to a cache line, which also covers the widest vector loads of the kernels.
+#define ALLOCATOR_SAMPLE_ALIGNMENT  ALLOCATOR_CACHE_LINE_SIZE
+
+// Allocation sizes are counted in power-of-two buckets of 32 up to 2048 bytes,
+// the last bucket counts the allocations larger than that.
+#define ALLOCATOR_HISTOGRAM_SIZE    8
 
 typedef struct allocator allocator;
 
-HRESULT DELTACALL allocator_create(allocator** ppOut);
+typedef struct allocator_stats {
+    DWORD64     LiveBytes;
+    DWORD64     PeakBytes;
+    DWORD64     Allocations;
+    DWORD64     Frees;
+    DWORD64     Histogram[ALLOCATOR_HISTOGRAM_SIZE];
+} allocator_stats;
+
+HRESULT DELTACALL allocator_create(DWORD dwFlags, allocator** ppOut);
 VOID DELTACALL allocator_release(allocator* pAlloc);
 
 HRESULT DELTACALL allocator_allocate(allocator* pAlloc, DWORD dwBytes, LPVOID* ppMem);
 HRESULT DELTACALL allocator_reallocate(allocator* pAlloc, LPVOID pMem, DWORD dwBytes, LPVOID* ppMem);
-HRESULT DELTACALL allocator_free(allocator* pAlloc, LPVOID pMem);
\ No newline at end of file
+HRESULT DELTACALL allocator_free(allocator* pAlloc, LPVOID pMem);
+
+HRESULT DELTACALL allocator_allocate_aligned(allocator* pAlloc, DWORD dwBytes, DWORD dwAlignment, LPVOID* ppMem);
+HRESULT DELTACALL allocator_free_aligned(allocator* pAlloc, LPVOID pMem);
+
+HRESULT DELTACALL allocator_trim(allocator* pAlloc, LPDWORD pdwBytes);
+
+HRESULT DELTACALL allocator_get_stats(allocator* pAlloc, allocator_stats* pStats);
+HRESULT DELTACALL allocator_dump(allocator* pAlloc);
\ No newline at end of file
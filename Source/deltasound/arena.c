@@ -23,29 +23,37 @@ SOFTWARE.
 */
 
 #include "arena.h"
-#include "arr.h"
 
 #define DEFAULT_BLOCK_SIZE      (256 * 1024)
 
-#define ALIGNMENT               64
+#define ALIGNMENT               ALLOCATOR_SAMPLE_ALIGNMENT
 
 #define ALIGN(X)                (((X) + ALIGNMENT - 1) & ~((ALIGNMENT) - 1))
 
+#define BLOCKDATA(X)            ((LPVOID)((size_t)(X) + ALIGN(sizeof(block))))
+
+// The memory of the block follows its header, the block is aligned so that every allocation is aligned too.
 typedef struct block {
-    allocator*  Allocator;
-    LPVOID      Block;
-    DWORD       Size;
-    DWORD       Capacity;
+    struct block*   Next;
+    DWORD           Size;
+    DWORD           Capacity;
 } block;
 
+// The arena is owned by a single thread, allocations only advance the offset in the current block.
+// When the block is exhausted, a new one is chained in front of it, and on clear
+// the chain is merged into a single block large enough for everything allocated since the last clear.
+// The peak is the most memory used between two clears since the last trim,
+// and the reserved size is the capacity the block never trims below.
 typedef struct arena {
-    allocator*          Allocator;
-    CRITICAL_SECTION    Lock;
-    arr*                Blocks;
+    allocator*  Allocator;
+    block*      Current;
+    DWORD       Peak;
+    DWORD       Reserved;
 } arena;
 
+HRESULT DELTACALL arena_allocate_block(arena* pArena, DWORD dwBytes, LPVOID* ppMem);
 HRESULT DELTACALL block_create(allocator* pAlloc, DWORD dwBytes, block** ppOut);
-VOID DELTACALL block_release(block* pBlock);
+VOID DELTACALL block_release(allocator* pAlloc, block* pBlock);
 
 HRESULT DELTACALL arena_create(allocator* pAlloc, arena** ppOut) {
     if (pAlloc == NULL || ppOut == NULL) {
@@ -58,15 +66,7 @@ HRESULT DELTACALL arena_create(allocator* pAlloc, arena** ppOut) {
     if (SUCCEEDED(hr = allocator_allocate(pAlloc, sizeof(arena), &instance))) {
         instance->Allocator = pAlloc;
 
-        if (SUCCEEDED(hr = arr_create(pAlloc, &instance->Blocks))) {
-            InitializeCriticalSection(&instance->Lock);
-
-            *ppOut = instance;
-
-            return S_OK;
-        }
-
-        allocator_free(pAlloc, instance);
+        *ppOut = instance;
     }
 
     return hr;
@@ -75,23 +75,22 @@ HRESULT DELTACALL arena_create(allocator* pAlloc, arena** ppOut) {
 VOID DELTACALL arena_release(arena* self) {
     if (self == NULL) { return; }
 
-    DeleteCriticalSection(&self->Lock);
+    block_release(self->Allocator, self->Current);
 
-    const DWORD count = arr_get_count(self->Blocks);
+    allocator_free(self->Allocator, self);
+}
 
-    for (DWORD i = 0; i < count; i++) {
-        block* region = NULL;
+HRESULT DELTACALL arena_allocate(arena* self, DWORD dwBytes, LPVOID* ppMem) {
+    HRESULT hr = S_OK;
 
-        if (SUCCEEDED(arr_get_item(self->Blocks, i, &region))) {
-            block_release(region);
-        }
+    if (SUCCEEDED(hr = arena_allocate_uninitialized(self, dwBytes, ppMem))) {
+        ZeroMemory(*ppMem, dwBytes);
     }
 
-    allocator_free(self->Allocator, self->Blocks);
-    allocator_free(self->Allocator, self);
+    return hr;
 }
 
-HRESULT DELTACALL arena_allocate(arena* self, DWORD dwBytes, LPVOID* ppMem) {
+HRESULT DELTACALL arena_allocate_uninitialized(arena* self, DWORD dwBytes, LPVOID* ppMem) {
     if (self == NULL) {
         return E_POINTER;
     }
@@ -100,77 +99,208 @@ HRESULT DELTACALL arena_allocate(arena* self, DWORD dwBytes, LPVOID* ppMem) {
         return E_INVALIDARG;
     }
 
-    HRESULT hr = S_OK;
-    block* region = NULL;
+    dwBytes = ALIGN(dwBytes);
 
-    EnterCriticalSection(&self->Lock);
+    block* current = self->Current;
 
-    dwBytes = ALIGN(dwBytes);
+    if (current != NULL && dwBytes <= current->Capacity - current->Size) {
+        *ppMem = (LPVOID)((size_t)BLOCKDATA(current) + current->Size);
+
+        current->Size += dwBytes;
+
+        return S_OK;
+    }
+
+    return arena_allocate_block(self, dwBytes, ppMem);
+}
 
-    const DWORD count = arr_get_count(self->Blocks);
+HRESULT DELTACALL arena_clear(arena* self) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
 
-    for (DWORD i = 0; i < count; i++) {
-        if (SUCCEEDED(hr = arr_get_item(self->Blocks, i, &region))) {
-            if (dwBytes < region->Capacity - region->Size) {
-                LPVOID pointer =
-                    (LPVOID)((size_t)region->Block + region->Size);
+    block* current = self->Current;
 
-                ZeroMemory(pointer, dwBytes);
+    if (current == NULL) {
+        return S_OK;
+    }
 
-                region->Size += dwBytes;
+    DWORD size = 0;
 
-                *ppMem = pointer;
+    for (block* item = current; item != NULL; item = item->Next) {
+        size += item->Size;
+    }
 
-                goto exit;
+    self->Peak = max(self->Peak, size);
+
+    if (current->Next != NULL) {
+        block_release(self->Allocator, current);
+
+        self->Current = NULL;
+
+        return block_create(self->Allocator, max(size, DEFAULT_BLOCK_SIZE), &self->Current);
+    }
+
+    current->Size = 0;
+
+    return S_OK;
+}
+
+HRESULT DELTACALL arena_trim(arena* self, LPDWORD pdwBytes) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    HRESULT hr = S_OK;
+
+    if (FAILED(hr = arena_clear(self))) {
+        return hr;
+    }
+
+    DWORD bytes = 0;
+    block* current = self->Current;
+
+    // The block shrinks to the high-water mark, an arena that was not used since the last trim gives up its block.
+    if (current != NULL) {
+        const DWORD size = max(self->Peak == 0 ? 0 : max(ALIGN(self->Peak), DEFAULT_BLOCK_SIZE), self->Reserved);
+
+        if (size < current->Capacity) {
+            bytes = current->Capacity - size;
+
+            block_release(self->Allocator, current);
+
+            self->Current = NULL;
+
+            if (size != 0) {
+                hr = block_create(self->Allocator, size, &self->Current);
             }
         }
     }
 
-    if (SUCCEEDED(hr = block_create(self->Allocator, max(dwBytes, DEFAULT_BLOCK_SIZE), &region))) {
-        region->Size = dwBytes;
+    self->Peak = 0;
 
-        if (SUCCEEDED(hr = arr_add_item(self->Blocks, region))) {
-            ZeroMemory(region->Block, dwBytes);
+    if (pdwBytes != NULL) {
+        *pdwBytes = SUCCEEDED(hr) ? bytes : 0;
+    }
 
-            *ppMem = region->Block;
+    return hr;
+}
 
-            goto exit;
-        }
+HRESULT DELTACALL arena_reserve(arena* self, DWORD dwBytes) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (MAXDWORD - ALIGNMENT < dwBytes) {
+        return E_OUTOFMEMORY;
+    }
+
+    HRESULT hr = S_OK;
+
+    if (FAILED(hr = arena_clear(self))) {
+        return hr;
+    }
+
+    const DWORD size = max(ALIGN(dwBytes), DEFAULT_BLOCK_SIZE);
+
+    self->Reserved = max(self->Reserved, size);
+
+    // The block is replaced up front, so that allocations up to the reserved size never need a new one.
+    block* current = self->Current;
+
+    if (current != NULL && self->Reserved <= current->Capacity) {
+        return S_OK;
+    }
+
+    block_release(self->Allocator, current);
+
+    self->Current = NULL;
 
-        block_release(region);
+    return block_create(self->Allocator, self->Reserved, &self->Current);
+}
+
+HRESULT DELTACALL arena_prepare(arena* self, DWORD dwBytes, LPVOID* ppBlock) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (ppBlock == NULL) {
+        return E_INVALIDARG;
     }
 
-exit:
+    if (MAXDWORD - ALIGNMENT < dwBytes) {
+        return E_OUTOFMEMORY;
+    }
+
+    HRESULT hr = S_OK;
+    block* instance = NULL;
 
-    LeaveCriticalSection(&self->Lock);
+    if (SUCCEEDED(hr = block_create(self->Allocator, max(ALIGN(dwBytes), DEFAULT_BLOCK_SIZE), &instance))) {
+        instance->Next = NULL;
+        instance->Size = 0;
+
+        *ppBlock = instance;
+    }
 
     return hr;
 }
 
-HRESULT DELTACALL arena_clear(arena* self) {
+HRESULT DELTACALL arena_swap(arena* self, LPVOID* ppBlock) {
     if (self == NULL) {
         return E_POINTER;
     }
 
-    EnterCriticalSection(&self->Lock);
+    if (ppBlock == NULL || *ppBlock == NULL) {
+        return E_INVALIDARG;
+    }
 
-    const DWORD count = arr_get_count(self->Blocks);
+    block* prepared = *ppBlock;
+    block* current = self->Current;
 
-    for (DWORD i = 0; i < count; i++) {
-        block* region = NULL;
+    if (current != NULL && current->Next == NULL && prepared->Capacity <= current->Capacity) {
+        return S_FALSE;
+    }
 
-        if (SUCCEEDED(arr_get_item(self->Blocks, i, &region))) {
-            region->Size = 0;
-        }
+    DWORD size = 0;
+
+    for (block* item = current; item != NULL; item = item->Next) {
+        size += item->Size;
     }
 
-    LeaveCriticalSection(&self->Lock);
+    self->Peak = max(self->Peak, size);
+    self->Reserved = max(self->Reserved, prepared->Capacity);
+
+    self->Current = prepared;
+
+    *ppBlock = current;
 
     return S_OK;
 }
 
+VOID DELTACALL arena_discard(arena* self, LPVOID pBlock) {
+    if (self == NULL) { return; }
+
+    block_release(self->Allocator, pBlock);
+}
+
 /* ---------------------------------------------------------------------- */
 
+HRESULT DELTACALL arena_allocate_block(arena* self, DWORD dwBytes, LPVOID* ppMem) {
+    HRESULT hr = S_OK;
+    block* instance = NULL;
+
+    if (SUCCEEDED(hr = block_create(self->Allocator, max(dwBytes, DEFAULT_BLOCK_SIZE), &instance))) {
+        instance->Next = self->Current;
+        instance->Size = dwBytes;
+
+        self->Current = instance;
+
+        *ppMem = BLOCKDATA(instance);
+    }
+
+    return hr;
+}
+
 HRESULT DELTACALL block_create(allocator* pAlloc, DWORD dwBytes, block** ppOut) {
     if (pAlloc == NULL || dwBytes == 0 || ppOut == NULL) {
         return E_INVALIDARG;
@@ -179,25 +309,21 @@ HRESULT DELTACALL block_create(allocator* pAlloc, DWORD dwBytes, block** ppOut)
     HRESULT hr = S_OK;
     block* instance = NULL;
 
-    if (SUCCEEDED(hr = allocator_allocate(pAlloc, sizeof(block), &instance))) {
-        if (SUCCEEDED(hr = allocator_allocate(pAlloc, dwBytes, &instance->Block))) {
-            instance->Allocator = pAlloc;
-            instance->Capacity = dwBytes;
+    if (SUCCEEDED(hr = allocator_allocate_aligned(pAlloc, ALIGN(sizeof(block)) + dwBytes, ALIGNMENT, &instance))) {
+        instance->Capacity = dwBytes;
 
-            *ppOut = instance;
-
-            return S_OK;
-        }
-
-        allocator_free(pAlloc, instance);
+        *ppOut = instance;
     }
 
     return hr;
 }
 
-VOID DELTACALL block_release(block* self) {
-    if (self == NULL) { return; }
+VOID DELTACALL block_release(allocator* pAlloc, block* self) {
+    while (self != NULL) {
+        block* next = self->Next;
 
-    allocator_free(self->Allocator, self->Block);
-    allocator_free(self->Allocator, self);
+        allocator_free_aligned(pAlloc, self);
+
+        self = next;
+    }
 }
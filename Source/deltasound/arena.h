@@ -32,4 +32,14 @@ HRESULT DELTACALL arena_create(allocator* pAlloc, arena** ppOut);
 VOID DELTACALL arena_release(arena* pArena);
 
 HRESULT DELTACALL arena_allocate(arena* pArena, DWORD dwBytes, LPVOID* ppMem);
+HRESULT DELTACALL arena_allocate_uninitialized(arena* pArena, DWORD dwBytes, LPVOID* ppMem);
 HRESULT DELTACALL arena_clear(arena* pArena);
+HRESULT DELTACALL arena_trim(arena* pArena, LPDWORD pdwBytes);
+HRESULT DELTACALL arena_reserve(arena* pArena, DWORD dwBytes);
+
+// A larger block is prepared by another thread and swapped in by the owner of the arena between two clears,
+// so that the reservation grows without allocating on the owning thread. The swap hands back the replaced
+// blocks, or the prepared one when it is not larger, and the preparing thread discards them.
+HRESULT DELTACALL arena_prepare(arena* pArena, DWORD dwBytes, LPVOID* ppBlock);
+HRESULT DELTACALL arena_swap(arena* pArena, LPVOID* ppBlock);
+VOID DELTACALL arena_discard(arena* pArena, LPVOID pBlock);
@@ -0,0 +1,173 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "backend.h"
+
+HRESULT DELTACALL backend_create(allocator* pAlloc, config* pConfig, backend** ppOut) {
+    if (pAlloc == NULL || pConfig == NULL || ppOut == NULL) {
+        return E_INVALIDARG;
+    }
+
+    if (pConfig->Backend == CONFIG_BACKEND_NULL) {
+        return backend_null_create(pAlloc, pConfig->VirtualClock, ppOut);
+    }
+
+    if (pConfig->Backend == CONFIG_BACKEND_WAV) {
+        return backend_wav_create(pAlloc, pConfig->BackendFile, pConfig->VirtualClock, ppOut);
+    }
+
+    return backend_wasapi_create(pAlloc, pConfig->LowLatency, pConfig->Exclusive, ppOut);
+}
+
+VOID DELTACALL backend_release(backend* self) {
+    if (self == NULL) { return; }
+
+    self->Self->Release(self);
+}
+
+HRESULT DELTACALL backend_open(backend* self, device_info* pInfo) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (pInfo == NULL) {
+        return E_INVALIDARG;
+    }
+
+    return self->Self->Open(self, pInfo);
+}
+
+VOID DELTACALL backend_close(backend* self) {
+    if (self == NULL) { return; }
+
+    self->Self->Close(self);
+}
+
+HRESULT DELTACALL backend_get_format(backend* self, PWAVEFORMATEXTENSIBLE* ppFormat) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (ppFormat == NULL) {
+        return E_INVALIDARG;
+    }
+
+    return self->Self->GetFormat(self, ppFormat);
+}
+
+HRESULT DELTACALL backend_get_buffer_size(backend* self, LPDWORD pdwFrames) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (pdwFrames == NULL) {
+        return E_INVALIDARG;
+    }
+
+    return self->Self->GetBufferSize(self, pdwFrames);
+}
+
+HRESULT DELTACALL backend_get_period(backend* self, LPDWORD pdwFrames) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (pdwFrames == NULL) {
+        return E_INVALIDARG;
+    }
+
+    return self->Self->GetPeriod(self, pdwFrames);
+}
+
+HRESULT DELTACALL backend_get_min_latency(backend* self, LPDWORD pdwFrames) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (pdwFrames == NULL) {
+        return E_INVALIDARG;
+    }
+
+    return self->Self->GetMinLatency(self, pdwFrames);
+}
+
+HRESULT DELTACALL backend_get_padding(backend* self, LPDWORD pdwFrames) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (pdwFrames == NULL) {
+        return E_INVALIDARG;
+    }
+
+    return self->Self->GetPadding(self, pdwFrames);
+}
+
+HRESULT DELTACALL backend_acquire_buffer(backend* self, DWORD dwFrames, LPBYTE* ppBuffer) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (dwFrames == 0 || ppBuffer == NULL) {
+        return E_INVALIDARG;
+    }
+
+    return self->Self->AcquireBuffer(self, dwFrames, ppBuffer);
+}
+
+HRESULT DELTACALL backend_release_buffer(backend* self, DWORD dwFrames, DWORD dwFlags) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    return self->Self->ReleaseBuffer(self, dwFrames, dwFlags);
+}
+
+HRESULT DELTACALL backend_wait(backend* self, HANDLE hClose) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (hClose == NULL) {
+        return E_INVALIDARG;
+    }
+
+    return self->Self->Wait(self, hClose);
+}
+
+HRESULT DELTACALL backend_suspend(backend* self) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    return self->Self->Suspend(self);
+}
+
+HRESULT DELTACALL backend_resume(backend* self) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    return self->Self->Resume(self);
+}
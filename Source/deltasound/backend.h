@@ -0,0 +1,102 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "allocator.h"
+#include "config.h"
+#include "device_info.h"
+
+#define BACKEND_RELEASE_NONE    0
+#define BACKEND_RELEASE_SILENT  1
+
+typedef struct backend_vft backend_vft;
+
+// The endpoint the device thread renders the mix to. All the calls but create and release
+// are made by the device thread, between open and close.
+typedef struct backend {
+    const backend_vft*  Self;
+    allocator*          Allocator;
+} backend;
+
+typedef VOID(DELTACALL* LPBACKENDRELEASE)(backend*);
+typedef HRESULT(DELTACALL* LPBACKENDOPEN)(backend*, device_info* pInfo);
+typedef VOID(DELTACALL* LPBACKENDCLOSE)(backend*);
+typedef HRESULT(DELTACALL* LPBACKENDGETFORMAT)(backend*, PWAVEFORMATEXTENSIBLE* ppFormat);
+typedef HRESULT(DELTACALL* LPBACKENDGETBUFFERSIZE)(backend*, LPDWORD pdwFrames);
+typedef HRESULT(DELTACALL* LPBACKENDGETPERIOD)(backend*, LPDWORD pdwFrames);
+typedef HRESULT(DELTACALL* LPBACKENDGETMINLATENCY)(backend*, LPDWORD pdwFrames);
+typedef HRESULT(DELTACALL* LPBACKENDGETPADDING)(backend*, LPDWORD pdwFrames);
+typedef HRESULT(DELTACALL* LPBACKENDACQUIREBUFFER)(backend*, DWORD dwFrames, LPBYTE* ppBuffer);
+typedef HRESULT(DELTACALL* LPBACKENDRELEASEBUFFER)(backend*, DWORD dwFrames, DWORD dwFlags);
+typedef HRESULT(DELTACALL* LPBACKENDWAIT)(backend*, HANDLE hClose);
+typedef HRESULT(DELTACALL* LPBACKENDSUSPEND)(backend*);
+typedef HRESULT(DELTACALL* LPBACKENDRESUME)(backend*);
+
+struct backend_vft {
+    LPBACKENDRELEASE        Release;
+    LPBACKENDOPEN           Open;
+    LPBACKENDCLOSE          Close;
+    LPBACKENDGETFORMAT      GetFormat;
+    LPBACKENDGETBUFFERSIZE  GetBufferSize;
+    LPBACKENDGETPERIOD      GetPeriod;
+    LPBACKENDGETMINLATENCY  GetMinLatency;
+    LPBACKENDGETPADDING     GetPadding;
+    LPBACKENDACQUIREBUFFER  AcquireBuffer;
+    LPBACKENDRELEASEBUFFER  ReleaseBuffer;
+    LPBACKENDWAIT           Wait;
+    LPBACKENDSUSPEND        Suspend;
+    LPBACKENDRESUME         Resume;
+};
+
+HRESULT DELTACALL backend_create(allocator* pAlloc, config* pConfig, backend** ppOut);
+VOID DELTACALL backend_release(backend* pBackend);
+
+HRESULT DELTACALL backend_open(backend* pBackend, device_info* pInfo);
+VOID DELTACALL backend_close(backend* pBackend);
+
+// The format is owned by the backend, and stays valid until it is closed.
+HRESULT DELTACALL backend_get_format(backend* pBackend, PWAVEFORMATEXTENSIBLE* ppFormat);
+HRESULT DELTACALL backend_get_buffer_size(backend* pBackend, LPDWORD pdwFrames);
+HRESULT DELTACALL backend_get_period(backend* pBackend, LPDWORD pdwFrames);
+
+// The fewest frames the endpoint needs queued ahead of what it plays, none unless it swaps whole buffers.
+HRESULT DELTACALL backend_get_min_latency(backend* pBackend, LPDWORD pdwFrames);
+
+HRESULT DELTACALL backend_get_padding(backend* pBackend, LPDWORD pdwFrames);
+
+HRESULT DELTACALL backend_acquire_buffer(backend* pBackend, DWORD dwFrames, LPBYTE* ppBuffer);
+HRESULT DELTACALL backend_release_buffer(backend* pBackend, DWORD dwFrames, DWORD dwFlags);
+
+// Returns S_OK once the endpoint is ready for more frames, and S_FALSE when hClose is signaled instead.
+HRESULT DELTACALL backend_wait(backend* pBackend, HANDLE hClose);
+
+// Stops the endpoint and drops the frames queued to it, the device thread does not wait on a suspended backend.
+// Resuming starts it again with an empty buffer.
+HRESULT DELTACALL backend_suspend(backend* pBackend);
+HRESULT DELTACALL backend_resume(backend* pBackend);
+
+HRESULT DELTACALL backend_wasapi_create(allocator* pAlloc, BOOL bLowLatency, BOOL bExclusive, backend** ppOut);
+HRESULT DELTACALL backend_null_create(allocator* pAlloc, BOOL bVirtual, backend** ppOut);
+HRESULT DELTACALL backend_wav_create(allocator* pAlloc, LPCSTR pszPath, BOOL bVirtual, backend** ppOut);
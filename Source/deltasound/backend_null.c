@@ -0,0 +1,283 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "backend.h"
+#include "uuid.h"
+
+#include <stdio.h>
+
+#define NULL_FREQUENCY          48000
+#define NULL_CHANNELS           2
+#define NULL_BUFFER_SIZE        NULL_FREQUENCY              // In frames, a second as the shared mode endpoints
+#define NULL_PERIOD             10                          // In milliseconds, the default period of the audio engine
+#define NULL_PERIOD_FRAMES      (NULL_FREQUENCY * NULL_PERIOD / 1000)
+
+#define MAX_REPORT_LENGTH       256
+
+// Consumes the mix at the rate of its format without playing it. The frames are played out
+// by a simulated clock, a buffer that is not refilled in time underruns as an endpoint would.
+// On the virtual clock every wait plays out exactly one period and returns at once,
+// so the device thread renders as fast as it can and the positions advance deterministically.
+typedef struct backend_null {
+    backend                 Base;
+    BOOL                    Virtual;
+
+    WAVEFORMATEXTENSIBLE    Format;
+    LPBYTE                  Buffer;
+
+    LARGE_INTEGER           Frequency;
+    LARGE_INTEGER           Start;
+    LARGE_INTEGER           Resumed;    // The clock plays out the frames since then
+    DWORD64                 Written;    // In frames, since the clock was resumed
+    DWORD64                 Rendered;   // In frames, the ones that were not lost to an underrun
+    DWORD64                 Periods;    // Played out by the virtual clock
+} backend_null;
+
+VOID DELTACALL backend_null_release(backend_null* self);
+HRESULT DELTACALL backend_null_open(backend_null* self, device_info* pInfo);
+VOID DELTACALL backend_null_close(backend_null* self);
+HRESULT DELTACALL backend_null_get_format(backend_null* self, PWAVEFORMATEXTENSIBLE* ppFormat);
+HRESULT DELTACALL backend_null_get_buffer_size(backend_null* self, LPDWORD pdwFrames);
+HRESULT DELTACALL backend_null_get_period(backend_null* self, LPDWORD pdwFrames);
+HRESULT DELTACALL backend_null_get_min_latency(backend_null* self, LPDWORD pdwFrames);
+HRESULT DELTACALL backend_null_get_padding(backend_null* self, LPDWORD pdwFrames);
+HRESULT DELTACALL backend_null_acquire_buffer(backend_null* self, DWORD dwFrames, LPBYTE* ppBuffer);
+HRESULT DELTACALL backend_null_release_buffer(backend_null* self, DWORD dwFrames, DWORD dwFlags);
+HRESULT DELTACALL backend_null_wait(backend_null* self, HANDLE hClose);
+HRESULT DELTACALL backend_null_suspend(backend_null* self);
+HRESULT DELTACALL backend_null_resume(backend_null* self);
+
+DWORD64 DELTACALL backend_null_get_played_frames(backend_null* self);
+VOID DELTACALL backend_null_report(backend_null* self);
+
+const static backend_vft backend_null_self = {
+    (LPBACKENDRELEASE)backend_null_release,
+    (LPBACKENDOPEN)backend_null_open,
+    (LPBACKENDCLOSE)backend_null_close,
+    (LPBACKENDGETFORMAT)backend_null_get_format,
+    (LPBACKENDGETBUFFERSIZE)backend_null_get_buffer_size,
+    (LPBACKENDGETPERIOD)backend_null_get_period,
+    (LPBACKENDGETMINLATENCY)backend_null_get_min_latency,
+    (LPBACKENDGETPADDING)backend_null_get_padding,
+    (LPBACKENDACQUIREBUFFER)backend_null_acquire_buffer,
+    (LPBACKENDRELEASEBUFFER)backend_null_release_buffer,
+    (LPBACKENDWAIT)backend_null_wait,
+    (LPBACKENDSUSPEND)backend_null_suspend,
+    (LPBACKENDRESUME)backend_null_resume
+};
+
+HRESULT DELTACALL backend_null_create(allocator* pAlloc, BOOL bVirtual, backend** ppOut) {
+    if (pAlloc == NULL || ppOut == NULL) {
+        return E_INVALIDARG;
+    }
+
+    HRESULT hr = S_OK;
+    backend_null* instance = NULL;
+
+    if (SUCCEEDED(hr = allocator_allocate(pAlloc, sizeof(backend_null), &instance))) {
+        instance->Base.Self = &backend_null_self;
+        instance->Base.Allocator = pAlloc;
+        instance->Virtual = bVirtual;
+
+        // The format is the usual mix format of a shared mode endpoint.
+        instance->Format.Format.wFormatTag = WAVE_FORMAT_EXTENSIBLE;
+        instance->Format.Format.nChannels = NULL_CHANNELS;
+        instance->Format.Format.nSamplesPerSec = NULL_FREQUENCY;
+        instance->Format.Format.wBitsPerSample = 32;
+        instance->Format.Format.nBlockAlign = NULL_CHANNELS * sizeof(FLOAT);
+        instance->Format.Format.nAvgBytesPerSec = NULL_FREQUENCY * NULL_CHANNELS * sizeof(FLOAT);
+        instance->Format.Format.cbSize = sizeof(WAVEFORMATEXTENSIBLE) - sizeof(WAVEFORMATEX);
+        instance->Format.Samples.wValidBitsPerSample = 32;
+        instance->Format.dwChannelMask = SPEAKER_FRONT_LEFT | SPEAKER_FRONT_RIGHT;
+
+        CopyMemory(&instance->Format.SubFormat, &KSDATAFORMAT_SUBTYPE_IEEE_FLOAT, sizeof(GUID));
+
+        *ppOut = &instance->Base;
+    }
+
+    return hr;
+}
+
+/* ---------------------------------------------------------------------- */
+
+VOID DELTACALL backend_null_release(backend_null* self) {
+    backend_null_close(self);
+
+    allocator_free(self->Base.Allocator, self);
+}
+
+HRESULT DELTACALL backend_null_open(backend_null* self, device_info* pInfo) {
+    UNUSED(pInfo);
+
+    HRESULT hr = S_OK;
+
+    if (SUCCEEDED(hr = allocator_allocate(self->Base.Allocator,
+        NULL_BUFFER_SIZE * self->Format.Format.nBlockAlign, &self->Buffer))) {
+        QueryPerformanceFrequency(&self->Frequency);
+        QueryPerformanceCounter(&self->Start);
+
+        self->Resumed = self->Start;
+        self->Written = 0;
+        self->Rendered = 0;
+        self->Periods = 0;
+    }
+
+    return hr;
+}
+
+VOID DELTACALL backend_null_close(backend_null* self) {
+    if (self->Buffer != NULL) {
+        if (self->Virtual) {
+            backend_null_report(self);
+        }
+
+        allocator_free(self->Base.Allocator, self->Buffer);
+        self->Buffer = NULL;
+    }
+}
+
+HRESULT DELTACALL backend_null_get_format(backend_null* self, PWAVEFORMATEXTENSIBLE* ppFormat) {
+    *ppFormat = &self->Format;
+
+    return S_OK;
+}
+
+HRESULT DELTACALL backend_null_get_buffer_size(backend_null* self, LPDWORD pdwFrames) {
+    *pdwFrames = NULL_BUFFER_SIZE;
+
+    return S_OK;
+}
+
+HRESULT DELTACALL backend_null_get_period(backend_null* self, LPDWORD pdwFrames) {
+    *pdwFrames = NULL_PERIOD_FRAMES;
+
+    return S_OK;
+}
+
+HRESULT DELTACALL backend_null_get_min_latency(backend_null* self, LPDWORD pdwFrames) {
+    *pdwFrames = 0;
+
+    return S_OK;
+}
+
+HRESULT DELTACALL backend_null_get_padding(backend_null* self, LPDWORD pdwFrames) {
+    const DWORD64 played = backend_null_get_played_frames(self);
+
+    // The frames that were not written in time are lost, the endpoint plays silence in their place.
+    if (self->Written < played) {
+        self->Written = played;
+    }
+
+    *pdwFrames = (DWORD)(self->Written - played);
+
+    return S_OK;
+}
+
+HRESULT DELTACALL backend_null_acquire_buffer(backend_null* self, DWORD dwFrames, LPBYTE* ppBuffer) {
+    HRESULT hr = S_OK;
+    DWORD padding = 0;
+
+    if (FAILED(hr = backend_null_get_padding(self, &padding))) {
+        return hr;
+    }
+
+    if (NULL_BUFFER_SIZE - padding < dwFrames) {
+        return E_INVALIDARG;
+    }
+
+    *ppBuffer = self->Buffer;
+
+    return S_OK;
+}
+
+HRESULT DELTACALL backend_null_release_buffer(backend_null* self, DWORD dwFrames, DWORD dwFlags) {
+    UNUSED(dwFlags);
+
+    self->Written += dwFrames;
+    self->Rendered += dwFrames;
+
+    return S_OK;
+}
+
+HRESULT DELTACALL backend_null_wait(backend_null* self, HANDLE hClose) {
+    const DWORD result = WaitForSingleObject(hClose, self->Virtual ? 0 : NULL_PERIOD);
+
+    if (result == WAIT_TIMEOUT) {
+        if (self->Virtual) {
+            self->Periods++;
+        }
+
+        return S_OK;
+    }
+
+    return result == WAIT_OBJECT_0 ? S_FALSE : E_FAIL;
+}
+
+HRESULT DELTACALL backend_null_suspend(backend_null* self) {
+    UNUSED(self);
+
+    return S_OK;
+}
+
+HRESULT DELTACALL backend_null_resume(backend_null* self) {
+    QueryPerformanceCounter(&self->Resumed);
+
+    self->Written = 0;
+    self->Periods = 0;
+
+    return S_OK;
+}
+
+DWORD64 DELTACALL backend_null_get_played_frames(backend_null* self) {
+    if (self->Virtual) {
+        return self->Periods * NULL_PERIOD_FRAMES;
+    }
+
+    LARGE_INTEGER now;
+
+    QueryPerformanceCounter(&now);
+
+    const DWORD64 ticks = (DWORD64)(now.QuadPart - self->Resumed.QuadPart);
+    const DWORD64 frequency = (DWORD64)self->Frequency.QuadPart;
+
+    // Whole seconds and the remainder are scaled apart, so that the product does not overflow.
+    return (ticks / frequency) * NULL_FREQUENCY + (ticks % frequency) * NULL_FREQUENCY / frequency;
+}
+
+VOID DELTACALL backend_null_report(backend_null* self) {
+    LARGE_INTEGER now;
+
+    QueryPerformanceCounter(&now);
+
+    const DOUBLE seconds = (DOUBLE)(now.QuadPart - self->Start.QuadPart) / (DOUBLE)self->Frequency.QuadPart;
+    const DOUBLE rate = seconds > 0.0 ? (DOUBLE)self->Rendered / seconds : 0.0;
+
+    CHAR line[MAX_REPORT_LENGTH];
+
+    snprintf(line, MAX_REPORT_LENGTH,
+        "DeltaSound: rendered %llu frames in %.3f seconds, %.0f frames per second, %.1fx real time\n",
+        self->Rendered, seconds, rate, rate / NULL_FREQUENCY);
+
+    OutputDebugStringA(line);
+}
@@ -0,0 +1,570 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "backend.h"
+#include "uuid.h"
+#include "wave.h"
+
+#define REFTIMES_PER_SEC            10000000
+
+#define AUDCLNT_BUFFERFLAGS_NONE    0
+
+#define AUDCLNT_STREAMFLAGS_DEFAULT  (AUDCLNT_STREAMFLAGS_NOPERSIST | AUDCLNT_STREAMFLAGS_EVENTCALLBACK)
+
+#define RELEASE(X) if ((X) != NULL) { (X)->lpVtbl->Release(X); (X) = NULL; }
+
+#define AUDIO_EVENT_INDEX           0
+#define CLOSE_EVENT_INDEX           1
+
+#define MAX_EVENT_COUNT             2
+
+// An invalidated endpoint stops signaling the event, the wait then times out and the client reports the loss.
+#define WAIT_TIMEOUT_MILLISECONDS   1000
+
+typedef struct backend_wasapi_format {
+    WORD        Bits;
+    WORD        ValidBits;
+    const GUID* SubFormat;
+} backend_wasapi_format;
+
+// The formats an exclusive stream is offered to the device in, in the order of preference.
+const static backend_wasapi_format backend_wasapi_formats[] = {
+    { 32, 32, &KSDATAFORMAT_SUBTYPE_IEEE_FLOAT },
+    { 32, 32, &KSDATAFORMAT_SUBTYPE_PCM },
+    { 32, 24, &KSDATAFORMAT_SUBTYPE_PCM },
+    { 24, 24, &KSDATAFORMAT_SUBTYPE_PCM },
+    { 16, 16, &KSDATAFORMAT_SUBTYPE_PCM }
+};
+
+// Renders to a shared mode WASAPI endpoint, the audio engine signals the event every period.
+// With low latency the stream asks the engine for its smallest period, where the system supports it.
+// An exclusive stream bypasses the engine, the device signals the event every time it swaps the halves
+// of its buffer and the whole of the other half is written. It falls back to a shared one when refused.
+typedef struct backend_wasapi {
+    backend                 Base;
+    BOOL                    LowLatency;
+    BOOL                    Exclusive;
+    BOOL                    Swap;           // The open stream is exclusive
+    BOOL                    Filled;         // Since the last swap
+
+    IMMDevice*              Device;
+    IAudioClient*           AudioClient;
+    IAudioRenderClient*     AudioRenderer;
+
+    PWAVEFORMATEXTENSIBLE   Format;
+    UINT32                  BufferSize;     // In frames
+    UINT32                  Period;         // In frames, none when the engine period is used
+    UINT32                  Acquired;       // In frames
+    LPBYTE                  Buffer;
+
+    HANDLE                  Event;
+} backend_wasapi;
+
+VOID DELTACALL backend_wasapi_release(backend_wasapi* self);
+HRESULT DELTACALL backend_wasapi_open(backend_wasapi* self, device_info* pInfo);
+VOID DELTACALL backend_wasapi_close(backend_wasapi* self);
+HRESULT DELTACALL backend_wasapi_get_format(backend_wasapi* self, PWAVEFORMATEXTENSIBLE* ppFormat);
+HRESULT DELTACALL backend_wasapi_get_buffer_size(backend_wasapi* self, LPDWORD pdwFrames);
+HRESULT DELTACALL backend_wasapi_get_period(backend_wasapi* self, LPDWORD pdwFrames);
+HRESULT DELTACALL backend_wasapi_get_min_latency(backend_wasapi* self, LPDWORD pdwFrames);
+HRESULT DELTACALL backend_wasapi_get_padding(backend_wasapi* self, LPDWORD pdwFrames);
+HRESULT DELTACALL backend_wasapi_acquire_buffer(backend_wasapi* self, DWORD dwFrames, LPBYTE* ppBuffer);
+HRESULT DELTACALL backend_wasapi_release_buffer(backend_wasapi* self, DWORD dwFrames, DWORD dwFlags);
+HRESULT DELTACALL backend_wasapi_wait(backend_wasapi* self, HANDLE hClose);
+HRESULT DELTACALL backend_wasapi_suspend(backend_wasapi* self);
+HRESULT DELTACALL backend_wasapi_resume(backend_wasapi* self);
+
+HRESULT DELTACALL backend_wasapi_activate(backend_wasapi* self);
+HRESULT DELTACALL backend_wasapi_prime(backend_wasapi* self);
+HRESULT DELTACALL backend_wasapi_initialize_low_latency(backend_wasapi* self, LPWAVEFORMATEX pwfxFormat);
+HRESULT DELTACALL backend_wasapi_initialize_exclusive(backend_wasapi* self, LPWAVEFORMATEX pwfxMixFormat);
+HRESULT DELTACALL backend_wasapi_get_exclusive_format(backend_wasapi* self,
+    LPWAVEFORMATEX pwfxMixFormat, PWAVEFORMATEXTENSIBLE pwfxFormat);
+
+const static backend_vft backend_wasapi_self = {
+    (LPBACKENDRELEASE)backend_wasapi_release,
+    (LPBACKENDOPEN)backend_wasapi_open,
+    (LPBACKENDCLOSE)backend_wasapi_close,
+    (LPBACKENDGETFORMAT)backend_wasapi_get_format,
+    (LPBACKENDGETBUFFERSIZE)backend_wasapi_get_buffer_size,
+    (LPBACKENDGETPERIOD)backend_wasapi_get_period,
+    (LPBACKENDGETMINLATENCY)backend_wasapi_get_min_latency,
+    (LPBACKENDGETPADDING)backend_wasapi_get_padding,
+    (LPBACKENDACQUIREBUFFER)backend_wasapi_acquire_buffer,
+    (LPBACKENDRELEASEBUFFER)backend_wasapi_release_buffer,
+    (LPBACKENDWAIT)backend_wasapi_wait,
+    (LPBACKENDSUSPEND)backend_wasapi_suspend,
+    (LPBACKENDRESUME)backend_wasapi_resume
+};
+
+HRESULT DELTACALL backend_wasapi_create(allocator* pAlloc, BOOL bLowLatency, BOOL bExclusive, backend** ppOut) {
+    if (pAlloc == NULL || ppOut == NULL) {
+        return E_INVALIDARG;
+    }
+
+    HRESULT hr = S_OK;
+    backend_wasapi* instance = NULL;
+
+    if (SUCCEEDED(hr = allocator_allocate(pAlloc, sizeof(backend_wasapi), &instance))) {
+        instance->Base.Self = &backend_wasapi_self;
+        instance->Base.Allocator = pAlloc;
+        instance->LowLatency = bLowLatency;
+        instance->Exclusive = bExclusive;
+
+        instance->Event = CreateEventA(NULL, FALSE, FALSE, NULL);
+
+        if (instance->Event != NULL) {
+            *ppOut = &instance->Base;
+
+            return S_OK;
+        }
+
+        hr = E_FAIL;
+
+        allocator_free(pAlloc, instance);
+    }
+
+    return hr;
+}
+
+/* ---------------------------------------------------------------------- */
+
+VOID DELTACALL backend_wasapi_release(backend_wasapi* self) {
+    backend_wasapi_close(self);
+
+    CloseHandle(self->Event);
+
+    allocator_free(self->Base.Allocator, self);
+}
+
+HRESULT DELTACALL backend_wasapi_open(backend_wasapi* self, device_info* pInfo) {
+    HRESULT hr = S_OK;
+    IMMDeviceEnumerator* enumerator = NULL;
+    LPWAVEFORMATEX wfx = NULL;
+
+    if (FAILED(hr = CoCreateInstance(&CLSID_IMMDeviceEnumerator,
+        NULL, CLSCTX_ALL, &IID_IMMDeviceEnumerator, &enumerator))) {
+        goto exit;
+    }
+
+    if (FAILED(hr = IMMDeviceEnumerator_GetDevice(enumerator,
+        pInfo->Module, &self->Device))) {
+        goto exit;
+    }
+
+    if (FAILED(hr = backend_wasapi_activate(self))) {
+        goto exit;
+    }
+
+    if (FAILED(hr = IAudioClient_GetMixFormat(self->AudioClient, &wfx))) {
+        goto exit;
+    }
+
+    self->Swap = FALSE;
+    self->Period = 0;
+
+    // The device is used by another application, or does not support any of the formats.
+    // A client that failed to initialize cannot be initialized again, a new one is activated for the shared stream.
+    if (self->Exclusive && backend_wasapi_initialize_exclusive(self, wfx) != S_OK) {
+        RELEASE(self->AudioClient);
+
+        if (FAILED(hr = backend_wasapi_activate(self))) {
+            goto exit;
+        }
+    }
+
+    if (!self->Swap) {
+        // Older systems, and endpoints that do not support smaller periods, get the engine period.
+        if (!self->LowLatency || backend_wasapi_initialize_low_latency(self, wfx) != S_OK) {
+            self->Period = 0;
+
+            // As above, the client that failed to initialize is replaced.
+            if (self->LowLatency) {
+                RELEASE(self->AudioClient);
+
+                if (FAILED(hr = backend_wasapi_activate(self))) {
+                    goto exit;
+                }
+            }
+
+            if (FAILED(hr = IAudioClient_Initialize(self->AudioClient,
+                AUDCLNT_SHAREMODE_SHARED, AUDCLNT_STREAMFLAGS_DEFAULT, REFTIMES_PER_SEC, 0, wfx, NULL))) {
+                goto exit;
+            }
+        }
+
+        if (FAILED(hr = allocator_allocate(self->Base.Allocator, SIZEOFFORMATEX(wfx), &self->Format))) {
+            goto exit;
+        }
+
+        CopyMemory(self->Format, wfx, SIZEOFFORMATEX(wfx));
+    }
+
+    if (FAILED(hr = IAudioClient_SetEventHandle(self->AudioClient, self->Event))) {
+        goto exit;
+    }
+
+    if (FAILED(hr = IAudioClient_GetService(self->AudioClient,
+        &IID_IAudioRenderClient, &self->AudioRenderer))) {
+        goto exit;
+    }
+
+    if (FAILED(hr = IAudioClient_GetBufferSize(self->AudioClient, &self->BufferSize))) {
+        goto exit;
+    }
+
+    if (self->Swap) {
+        self->Period = self->BufferSize;
+    }
+
+    if (FAILED(hr = backend_wasapi_prime(self))) {
+        goto exit;
+    }
+
+    if (FAILED(hr = IAudioClient_Start(self->AudioClient))) {
+        goto exit;
+    }
+
+    CoTaskMemFree(wfx);
+
+    RELEASE(enumerator);
+
+    return S_OK;
+
+exit:
+
+    if (wfx != NULL) {
+        CoTaskMemFree(wfx);
+    }
+
+    backend_wasapi_close(self);
+
+    RELEASE(enumerator);
+
+    return hr;
+}
+
+VOID DELTACALL backend_wasapi_close(backend_wasapi* self) {
+    if (self->AudioClient != NULL) {
+        IAudioClient_Stop(self->AudioClient);
+    }
+
+    if (self->Format != NULL) {
+        allocator_free(self->Base.Allocator, self->Format);
+        self->Format = NULL;
+    }
+
+    RELEASE(self->AudioRenderer);
+    RELEASE(self->AudioClient);
+    RELEASE(self->Device);
+}
+
+HRESULT DELTACALL backend_wasapi_get_format(backend_wasapi* self, PWAVEFORMATEXTENSIBLE* ppFormat) {
+    *ppFormat = self->Format;
+
+    return self->Format != NULL ? S_OK : E_FAIL;
+}
+
+HRESULT DELTACALL backend_wasapi_get_buffer_size(backend_wasapi* self, LPDWORD pdwFrames) {
+    *pdwFrames = self->Swap ? 2 * self->BufferSize : self->BufferSize;
+
+    return S_OK;
+}
+
+HRESULT DELTACALL backend_wasapi_get_period(backend_wasapi* self, LPDWORD pdwFrames) {
+    if (self->Period != 0) {
+        *pdwFrames = self->Period;
+
+        return S_OK;
+    }
+
+    HRESULT hr = S_OK;
+    REFERENCE_TIME period = 0;
+
+    if (SUCCEEDED(hr = IAudioClient_GetDevicePeriod(self->AudioClient, &period, NULL))) {
+        *pdwFrames = (DWORD)((period * self->Format->Format.nSamplesPerSec + REFTIMES_PER_SEC - 1) / REFTIMES_PER_SEC);
+    }
+
+    return hr;
+}
+
+HRESULT DELTACALL backend_wasapi_get_min_latency(backend_wasapi* self, LPDWORD pdwFrames) {
+    // The half the device plays, and the one written while it does.
+    *pdwFrames = self->Swap ? 2 * self->BufferSize : 0;
+
+    return S_OK;
+}
+
+HRESULT DELTACALL backend_wasapi_get_padding(backend_wasapi* self, LPDWORD pdwFrames) {
+    if (self->Swap) {
+        *pdwFrames = self->BufferSize;
+
+        return S_OK;
+    }
+
+    HRESULT hr = S_OK;
+    UINT32 padding = 0;
+
+    if (SUCCEEDED(hr = IAudioClient_GetCurrentPadding(self->AudioClient, &padding))) {
+        *pdwFrames = padding;
+    }
+
+    return hr;
+}
+
+HRESULT DELTACALL backend_wasapi_acquire_buffer(backend_wasapi* self, DWORD dwFrames, LPBYTE* ppBuffer) {
+    HRESULT hr = S_OK;
+
+    if (SUCCEEDED(hr = IAudioRenderClient_GetBuffer(self->AudioRenderer, dwFrames, ppBuffer))) {
+        self->Acquired = dwFrames;
+        self->Buffer = *ppBuffer;
+    }
+
+    return hr;
+}
+
+HRESULT DELTACALL backend_wasapi_release_buffer(backend_wasapi* self, DWORD dwFrames, DWORD dwFlags) {
+    // The device swaps whole halves, the frames the mix did not fill are silent.
+    if (self->Swap) {
+        if (!(dwFlags & BACKEND_RELEASE_SILENT) && dwFrames < self->Acquired) {
+            const DWORD alignment = self->Format->Format.nBlockAlign;
+
+            ZeroMemory(self->Buffer + dwFrames * alignment, (self->Acquired - dwFrames) * alignment);
+        }
+
+        self->Filled = TRUE;
+
+        dwFrames = self->Acquired;
+    }
+
+    return IAudioRenderClient_ReleaseBuffer(self->AudioRenderer, dwFrames,
+        (dwFlags & BACKEND_RELEASE_SILENT) ? AUDCLNT_BUFFERFLAGS_SILENT : AUDCLNT_BUFFERFLAGS_NONE);
+}
+
+HRESULT DELTACALL backend_wasapi_wait(backend_wasapi* self, HANDLE hClose) {
+    // Without the mix of a period, the device would play the stale contents of the half again.
+    if (self->Swap) {
+        if (!self->Filled) {
+            LPBYTE buffer = NULL;
+
+            if (SUCCEEDED(IAudioRenderClient_GetBuffer(self->AudioRenderer, self->BufferSize, &buffer))) {
+                IAudioRenderClient_ReleaseBuffer(self->AudioRenderer, self->BufferSize, AUDCLNT_BUFFERFLAGS_SILENT);
+            }
+        }
+
+        self->Filled = FALSE;
+    }
+
+    HANDLE events[MAX_EVENT_COUNT];
+
+    events[AUDIO_EVENT_INDEX] = self->Event;
+    events[CLOSE_EVENT_INDEX] = hClose;
+
+    const DWORD result = WaitForMultipleObjects(MAX_EVENT_COUNT, events, FALSE, WAIT_TIMEOUT_MILLISECONDS);
+
+    if (result == WAIT_OBJECT_0 + AUDIO_EVENT_INDEX) {
+        return S_OK;
+    }
+
+    if (result == WAIT_TIMEOUT) {
+        UINT32 padding = 0;
+        const HRESULT hr = IAudioClient_GetCurrentPadding(self->AudioClient, &padding);
+
+        return SUCCEEDED(hr) ? S_OK : hr;
+    }
+
+    return result == WAIT_OBJECT_0 + CLOSE_EVENT_INDEX ? S_FALSE : E_FAIL;
+}
+
+HRESULT DELTACALL backend_wasapi_initialize_low_latency(backend_wasapi* self, LPWAVEFORMATEX pwfxFormat) {
+    HRESULT hr = S_OK;
+    IAudioClient3* client = NULL;
+
+    // IAudioClient3 is available since Windows 10.
+    if (FAILED(hr = IAudioClient_QueryInterface(self->AudioClient, &IID_IAudioClient3, &client))) {
+        return hr;
+    }
+
+    UINT32 period = 0, fundamental = 0, minimum = 0, maximum = 0;
+
+    if (SUCCEEDED(hr = IAudioClient3_GetSharedModeEnginePeriod(client,
+        pwfxFormat, &period, &fundamental, &minimum, &maximum))) {
+        hr = IAudioClient3_InitializeSharedAudioStream(client, AUDCLNT_STREAMFLAGS_DEFAULT, minimum, pwfxFormat, NULL);
+
+        // Another stream already runs the engine at its own period, which is then the smallest one available.
+        // The stream is initialized on a new client, the one that failed to initialize cannot be used again.
+        if (hr == AUDCLNT_E_ENGINE_PERIODICITY_LOCKED) {
+            LPWAVEFORMATEX wfx = NULL;
+
+            if (SUCCEEDED(hr = IAudioClient3_GetCurrentSharedModeEnginePeriod(client, &wfx, &minimum))) {
+                CoTaskMemFree(wfx);
+
+                RELEASE(client);
+                RELEASE(self->AudioClient);
+
+                if (SUCCEEDED(hr = backend_wasapi_activate(self))
+                    && SUCCEEDED(hr = IAudioClient_QueryInterface(self->AudioClient, &IID_IAudioClient3, &client))) {
+                    hr = IAudioClient3_InitializeSharedAudioStream(client,
+                        AUDCLNT_STREAMFLAGS_DEFAULT, minimum, pwfxFormat, NULL);
+                }
+            }
+        }
+
+        if (SUCCEEDED(hr)) {
+            self->Period = minimum;
+        }
+    }
+
+    RELEASE(client);
+
+    return hr;
+}
+
+HRESULT DELTACALL backend_wasapi_suspend(backend_wasapi* self) {
+    HRESULT hr = S_OK;
+
+    // The queued frames are dropped, so that the resumed stream plays the mix right away.
+    if (SUCCEEDED(hr = IAudioClient_Stop(self->AudioClient))) {
+        hr = IAudioClient_Reset(self->AudioClient);
+    }
+
+    return hr;
+}
+
+HRESULT DELTACALL backend_wasapi_resume(backend_wasapi* self) {
+    HRESULT hr = S_OK;
+
+    if (SUCCEEDED(hr = backend_wasapi_prime(self))) {
+        hr = IAudioClient_Start(self->AudioClient);
+    }
+
+    return hr;
+}
+
+HRESULT DELTACALL backend_wasapi_prime(backend_wasapi* self) {
+    if (!self->Swap) {
+        return S_OK;
+    }
+
+    HRESULT hr = S_OK;
+    LPBYTE buffer = NULL;
+
+    // The device starts playing the first half right away, so it is filled with silence beforehand.
+    if (SUCCEEDED(hr = IAudioRenderClient_GetBuffer(self->AudioRenderer, self->BufferSize, &buffer))) {
+        if (SUCCEEDED(hr = IAudioRenderClient_ReleaseBuffer(self->AudioRenderer,
+            self->BufferSize, AUDCLNT_BUFFERFLAGS_SILENT))) {
+            self->Filled = TRUE;
+        }
+    }
+
+    return hr;
+}
+
+HRESULT DELTACALL backend_wasapi_activate(backend_wasapi* self) {
+    return IMMDevice_Activate(self->Device, &IID_IAudioClient, CLSCTX_INPROC_SERVER, NULL, &self->AudioClient);
+}
+
+HRESULT DELTACALL backend_wasapi_initialize_exclusive(backend_wasapi* self, LPWAVEFORMATEX pwfxMixFormat) {
+    HRESULT hr = S_OK;
+    WAVEFORMATEXTENSIBLE format;
+    REFERENCE_TIME period = 0;
+
+    if (FAILED(hr = backend_wasapi_get_exclusive_format(self, pwfxMixFormat, &format))) {
+        return hr;
+    }
+
+    if (FAILED(hr = IAudioClient_GetDevicePeriod(self->AudioClient, NULL, &period))) {
+        return hr;
+    }
+
+    hr = IAudioClient_Initialize(self->AudioClient, AUDCLNT_SHAREMODE_EXCLUSIVE,
+        AUDCLNT_STREAMFLAGS_DEFAULT, period, period, &format.Format, NULL);
+
+    // The device rounds the period to the alignment of its buffer, the client is initialized again with the aligned one.
+    if (hr == AUDCLNT_E_BUFFER_SIZE_NOT_ALIGNED) {
+        UINT32 frames = 0;
+
+        if (FAILED(hr = IAudioClient_GetBufferSize(self->AudioClient, &frames))) {
+            return hr;
+        }
+
+        period = (REFERENCE_TIME)(((DWORD64)REFTIMES_PER_SEC * frames
+            + format.Format.nSamplesPerSec / 2) / format.Format.nSamplesPerSec);
+
+        RELEASE(self->AudioClient);
+
+        if (FAILED(hr = backend_wasapi_activate(self))) {
+            return hr;
+        }
+
+        hr = IAudioClient_Initialize(self->AudioClient, AUDCLNT_SHAREMODE_EXCLUSIVE,
+            AUDCLNT_STREAMFLAGS_DEFAULT, period, period, &format.Format, NULL);
+    }
+
+    if (FAILED(hr)) {
+        return hr;
+    }
+
+    if (FAILED(hr = allocator_allocate(self->Base.Allocator, sizeof(WAVEFORMATEXTENSIBLE), &self->Format))) {
+        return hr;
+    }
+
+    CopyMemory(self->Format, &format, sizeof(WAVEFORMATEXTENSIBLE));
+
+    self->Swap = TRUE;
+
+    return S_OK;
+}
+
+HRESULT DELTACALL backend_wasapi_get_exclusive_format(backend_wasapi* self,
+    LPWAVEFORMATEX pwfxMixFormat, PWAVEFORMATEXTENSIBLE pwfxFormat) {
+    // The device plays the channels and the frequency of the mix format natively, the sample type is negotiated.
+    const DWORD mask = pwfxMixFormat->wFormatTag == WAVE_FORMAT_EXTENSIBLE
+        ? ((PWAVEFORMATEXTENSIBLE)pwfxMixFormat)->dwChannelMask : 0;
+
+    for (DWORD i = 0; i < _countof(backend_wasapi_formats); i++) {
+        const backend_wasapi_format* candidate = &backend_wasapi_formats[i];
+
+        ZeroMemory(pwfxFormat, sizeof(WAVEFORMATEXTENSIBLE));
+
+        pwfxFormat->Format.wFormatTag = WAVE_FORMAT_EXTENSIBLE;
+        pwfxFormat->Format.nChannels = pwfxMixFormat->nChannels;
+        pwfxFormat->Format.nSamplesPerSec = pwfxMixFormat->nSamplesPerSec;
+        pwfxFormat->Format.wBitsPerSample = candidate->Bits;
+        pwfxFormat->Format.nBlockAlign = pwfxMixFormat->nChannels * candidate->Bits / 8;
+        pwfxFormat->Format.nAvgBytesPerSec = pwfxMixFormat->nSamplesPerSec * pwfxFormat->Format.nBlockAlign;
+        pwfxFormat->Format.cbSize = sizeof(WAVEFORMATEXTENSIBLE) - sizeof(WAVEFORMATEX);
+        pwfxFormat->Samples.wValidBitsPerSample = candidate->ValidBits;
+        pwfxFormat->dwChannelMask = mask;
+
+        CopyMemory(&pwfxFormat->SubFormat, candidate->SubFormat, sizeof(GUID));
+
+        if (IAudioClient_IsFormatSupported(self->AudioClient,
+            AUDCLNT_SHAREMODE_EXCLUSIVE, &pwfxFormat->Format, NULL) == S_OK) {
+            return S_OK;
+        }
+    }
+
+    return AUDCLNT_E_UNSUPPORTED_FORMAT;
+}
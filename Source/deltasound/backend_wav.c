@@ -0,0 +1,266 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "backend.h"
+#include "wave.h"
+
+#define RIFF_HEADER_SIZE        12
+#define CHUNK_HEADER_SIZE       8
+
+#define MAX_FORMAT_SIZE         sizeof(WAVEFORMATEXTENSIBLE)
+#define MAX_HEADER_SIZE         (RIFF_HEADER_SIZE + CHUNK_HEADER_SIZE + MAX_FORMAT_SIZE + CHUNK_HEADER_SIZE)
+
+// Writes the mix to a WAV file. The null sink paces the writes, so that the file
+// receives what an endpoint would have played, silence included.
+typedef struct backend_wav {
+    backend     Base;
+    backend*    Sink;
+
+    CHAR        Path[MAX_PATH];
+    HANDLE      File;
+
+    LPBYTE      Buffer;
+    DWORD       Bytes;      // The size of the data chunk
+} backend_wav;
+
+VOID DELTACALL backend_wav_release(backend_wav* self);
+HRESULT DELTACALL backend_wav_open(backend_wav* self, device_info* pInfo);
+VOID DELTACALL backend_wav_close(backend_wav* self);
+HRESULT DELTACALL backend_wav_get_format(backend_wav* self, PWAVEFORMATEXTENSIBLE* ppFormat);
+HRESULT DELTACALL backend_wav_get_buffer_size(backend_wav* self, LPDWORD pdwFrames);
+HRESULT DELTACALL backend_wav_get_period(backend_wav* self, LPDWORD pdwFrames);
+HRESULT DELTACALL backend_wav_get_min_latency(backend_wav* self, LPDWORD pdwFrames);
+HRESULT DELTACALL backend_wav_get_padding(backend_wav* self, LPDWORD pdwFrames);
+HRESULT DELTACALL backend_wav_acquire_buffer(backend_wav* self, DWORD dwFrames, LPBYTE* ppBuffer);
+HRESULT DELTACALL backend_wav_release_buffer(backend_wav* self, DWORD dwFrames, DWORD dwFlags);
+HRESULT DELTACALL backend_wav_wait(backend_wav* self, HANDLE hClose);
+HRESULT DELTACALL backend_wav_suspend(backend_wav* self);
+HRESULT DELTACALL backend_wav_resume(backend_wav* self);
+
+HRESULT DELTACALL backend_wav_write_header(backend_wav* self);
+HRESULT DELTACALL backend_wav_write(backend_wav* self, LPCVOID pData, DWORD dwBytes);
+DWORD DELTACALL backend_wav_put(LPBYTE pHeader, DWORD dwOffset, LPCVOID pData, DWORD dwBytes);
+
+const static backend_vft backend_wav_self = {
+    (LPBACKENDRELEASE)backend_wav_release,
+    (LPBACKENDOPEN)backend_wav_open,
+    (LPBACKENDCLOSE)backend_wav_close,
+    (LPBACKENDGETFORMAT)backend_wav_get_format,
+    (LPBACKENDGETBUFFERSIZE)backend_wav_get_buffer_size,
+    (LPBACKENDGETPERIOD)backend_wav_get_period,
+    (LPBACKENDGETMINLATENCY)backend_wav_get_min_latency,
+    (LPBACKENDGETPADDING)backend_wav_get_padding,
+    (LPBACKENDACQUIREBUFFER)backend_wav_acquire_buffer,
+    (LPBACKENDRELEASEBUFFER)backend_wav_release_buffer,
+    (LPBACKENDWAIT)backend_wav_wait,
+    (LPBACKENDSUSPEND)backend_wav_suspend,
+    (LPBACKENDRESUME)backend_wav_resume
+};
+
+HRESULT DELTACALL backend_wav_create(allocator* pAlloc, LPCSTR pszPath, BOOL bVirtual, backend** ppOut) {
+    if (pAlloc == NULL || pszPath == NULL || ppOut == NULL) {
+        return E_INVALIDARG;
+    }
+
+    HRESULT hr = S_OK;
+    backend_wav* instance = NULL;
+
+    if (SUCCEEDED(hr = allocator_allocate(pAlloc, sizeof(backend_wav), &instance))) {
+        instance->Base.Self = &backend_wav_self;
+        instance->Base.Allocator = pAlloc;
+        instance->File = INVALID_HANDLE_VALUE;
+
+        lstrcpynA(instance->Path, pszPath, MAX_PATH);
+
+        if (SUCCEEDED(hr = backend_null_create(pAlloc, bVirtual, &instance->Sink))) {
+            *ppOut = &instance->Base;
+
+            return S_OK;
+        }
+
+        allocator_free(pAlloc, instance);
+    }
+
+    return hr;
+}
+
+/* ---------------------------------------------------------------------- */
+
+VOID DELTACALL backend_wav_release(backend_wav* self) {
+    backend_wav_close(self);
+
+    backend_release(self->Sink);
+
+    allocator_free(self->Base.Allocator, self);
+}
+
+HRESULT DELTACALL backend_wav_open(backend_wav* self, device_info* pInfo) {
+    HRESULT hr = S_OK;
+
+    if (FAILED(hr = backend_open(self->Sink, pInfo))) {
+        return hr;
+    }
+
+    self->File = CreateFileA(self->Path, GENERIC_WRITE, FILE_SHARE_READ,
+        NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (self->File == INVALID_HANDLE_VALUE) {
+        hr = HRESULT_FROM_WIN32(GetLastError());
+    }
+    else {
+        self->Bytes = 0;
+
+        hr = backend_wav_write_header(self);
+    }
+
+    if (FAILED(hr)) {
+        backend_wav_close(self);
+    }
+
+    return hr;
+}
+
+VOID DELTACALL backend_wav_close(backend_wav* self) {
+    if (self->File != INVALID_HANDLE_VALUE) {
+        // The header is written again with the final sizes of the chunks.
+        if (SetFilePointer(self->File, 0, NULL, FILE_BEGIN) != INVALID_SET_FILE_POINTER) {
+            backend_wav_write_header(self);
+        }
+
+        CloseHandle(self->File);
+
+        self->File = INVALID_HANDLE_VALUE;
+    }
+
+    backend_close(self->Sink);
+}
+
+HRESULT DELTACALL backend_wav_get_format(backend_wav* self, PWAVEFORMATEXTENSIBLE* ppFormat) {
+    return backend_get_format(self->Sink, ppFormat);
+}
+
+HRESULT DELTACALL backend_wav_get_buffer_size(backend_wav* self, LPDWORD pdwFrames) {
+    return backend_get_buffer_size(self->Sink, pdwFrames);
+}
+
+HRESULT DELTACALL backend_wav_get_period(backend_wav* self, LPDWORD pdwFrames) {
+    return backend_get_period(self->Sink, pdwFrames);
+}
+
+HRESULT DELTACALL backend_wav_get_min_latency(backend_wav* self, LPDWORD pdwFrames) {
+    return backend_get_min_latency(self->Sink, pdwFrames);
+}
+
+HRESULT DELTACALL backend_wav_get_padding(backend_wav* self, LPDWORD pdwFrames) {
+    return backend_get_padding(self->Sink, pdwFrames);
+}
+
+HRESULT DELTACALL backend_wav_acquire_buffer(backend_wav* self, DWORD dwFrames, LPBYTE* ppBuffer) {
+    HRESULT hr = S_OK;
+
+    if (SUCCEEDED(hr = backend_acquire_buffer(self->Sink, dwFrames, &self->Buffer))) {
+        *ppBuffer = self->Buffer;
+    }
+
+    return hr;
+}
+
+HRESULT DELTACALL backend_wav_release_buffer(backend_wav* self, DWORD dwFrames, DWORD dwFlags) {
+    HRESULT hr = S_OK;
+    PWAVEFORMATEXTENSIBLE format = NULL;
+
+    if (FAILED(hr = backend_get_format(self->Sink, &format))) {
+        return hr;
+    }
+
+    const DWORD bytes = dwFrames * format->Format.nBlockAlign;
+
+    if (dwFlags & BACKEND_RELEASE_SILENT) {
+        ZeroMemory(self->Buffer, bytes);
+    }
+
+    if (SUCCEEDED(hr = backend_wav_write(self, self->Buffer, bytes))) {
+        self->Bytes += bytes;
+    }
+
+    backend_release_buffer(self->Sink, dwFrames, dwFlags);
+
+    return hr;
+}
+
+HRESULT DELTACALL backend_wav_wait(backend_wav* self, HANDLE hClose) {
+    return backend_wait(self->Sink, hClose);
+}
+
+HRESULT DELTACALL backend_wav_suspend(backend_wav* self) {
+    return backend_suspend(self->Sink);
+}
+
+HRESULT DELTACALL backend_wav_resume(backend_wav* self) {
+    return backend_resume(self->Sink);
+}
+
+HRESULT DELTACALL backend_wav_write_header(backend_wav* self) {
+    HRESULT hr = S_OK;
+    PWAVEFORMATEXTENSIBLE format = NULL;
+
+    if (FAILED(hr = backend_get_format(self->Sink, &format))) {
+        return hr;
+    }
+
+    BYTE header[MAX_HEADER_SIZE];
+
+    const DWORD length = min(SIZEOFFORMATEX((&format->Format)), MAX_FORMAT_SIZE);
+    const DWORD riff = RIFF_HEADER_SIZE - CHUNK_HEADER_SIZE
+        + CHUNK_HEADER_SIZE + length + CHUNK_HEADER_SIZE + self->Bytes;
+
+    DWORD offset = 0;
+
+    offset = backend_wav_put(header, offset, "RIFF", 4);
+    offset = backend_wav_put(header, offset, &riff, sizeof(DWORD));
+    offset = backend_wav_put(header, offset, "WAVE", 4);
+    offset = backend_wav_put(header, offset, "fmt ", 4);
+    offset = backend_wav_put(header, offset, &length, sizeof(DWORD));
+    offset = backend_wav_put(header, offset, format, length);
+    offset = backend_wav_put(header, offset, "data", 4);
+    offset = backend_wav_put(header, offset, &self->Bytes, sizeof(DWORD));
+
+    return backend_wav_write(self, header, offset);
+}
+
+HRESULT DELTACALL backend_wav_write(backend_wav* self, LPCVOID pData, DWORD dwBytes) {
+    DWORD written = 0;
+
+    if (!WriteFile(self->File, pData, dwBytes, &written, NULL)) {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    return written == dwBytes ? S_OK : E_FAIL;
+}
+
+DWORD DELTACALL backend_wav_put(LPBYTE pHeader, DWORD dwOffset, LPCVOID pData, DWORD dwBytes) {
+    CopyMemory(&pHeader[dwOffset], pData, dwBytes);
+
+    return dwOffset + dwBytes;
+}
@@ -0,0 +1,247 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "config.h"
+
+#define MAX_VARIABLE_LENGTH     16
+#define MAX_MASK_LENGTH         24
+
+BOOL DELTACALL config_get_boolean(LPCSTR pszName, BOOL bDefault);
+DWORD DELTACALL config_get_number(LPCSTR pszName, DWORD dwDefault, DWORD dwMin, DWORD dwMax);
+DWORD DELTACALL config_get_backend(LPCSTR pszName, DWORD dwDefault);
+VOID DELTACALL config_get_path(LPCSTR pszName, LPCSTR pszDefault, LPSTR pszPath);
+DWORD DELTACALL config_get_task(LPCSTR pszName, DWORD dwDefault);
+DWORD DELTACALL config_get_priority(LPCSTR pszName, DWORD dwDefault);
+DWORD64 DELTACALL config_get_mask(LPCSTR pszName);
+
+HRESULT DELTACALL config_initialize(config* self) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    self->HalfCache = config_get_boolean(CONFIG_HALF_CACHE_VARIABLE, FALSE);
+    self->SlabAllocator = config_get_boolean(CONFIG_SLAB_ALLOCATOR_VARIABLE, TRUE);
+    self->AllocatorTracking = config_get_boolean(CONFIG_ALLOCATOR_TRACKING_VARIABLE, CONFIG_ALLOCATOR_TRACKING_DEFAULT);
+    self->RealtimeCheck = config_get_boolean(CONFIG_REALTIME_CHECK_VARIABLE, CONFIG_REALTIME_CHECK_DEFAULT);
+    self->MaxVoices = config_get_number(CONFIG_MAX_VOICES_VARIABLE,
+        CONFIG_MAX_VOICES_DEFAULT, CONFIG_MAX_VOICES_MIN, CONFIG_MAX_VOICES_LIMIT);
+    self->LowLatency = config_get_boolean(CONFIG_LOW_LATENCY_VARIABLE, FALSE);
+    self->Exclusive = config_get_boolean(CONFIG_EXCLUSIVE_VARIABLE, FALSE);
+    self->MinLatency = config_get_number(CONFIG_MIN_LATENCY_VARIABLE,
+        self->LowLatency ? CONFIG_MIN_LATENCY_LOW_LATENCY : CONFIG_MIN_LATENCY_DEFAULT, 0, CONFIG_LATENCY_LIMIT);
+    self->MaxLatency = config_get_number(CONFIG_MAX_LATENCY_VARIABLE, CONFIG_MAX_LATENCY_DEFAULT, 0, CONFIG_LATENCY_LIMIT);
+
+    // Bounds in the wrong order select a fixed latency.
+    if (self->MaxLatency < self->MinLatency) {
+        self->MaxLatency = self->MinLatency;
+    }
+
+    self->IdleTimeout = config_get_number(CONFIG_IDLE_TIMEOUT_VARIABLE,
+        CONFIG_IDLE_TIMEOUT_DEFAULT, 0, CONFIG_IDLE_TIMEOUT_LIMIT);
+
+    self->Backend = config_get_backend(CONFIG_BACKEND_VARIABLE, CONFIG_BACKEND_WASAPI);
+    self->VirtualClock = config_get_boolean(CONFIG_VIRTUAL_CLOCK_VARIABLE, FALSE);
+
+    config_get_path(CONFIG_BACKEND_FILE_VARIABLE, CONFIG_BACKEND_FILE_DEFAULT, self->BackendFile);
+
+    self->MmcssTask = config_get_task(CONFIG_MMCSS_TASK_VARIABLE, CONFIG_MMCSS_TASK_PRO_AUDIO);
+    self->MmcssPriority = config_get_priority(CONFIG_MMCSS_PRIORITY_VARIABLE, CONFIG_MMCSS_PRIORITY_HIGH);
+    self->Affinity = config_get_mask(CONFIG_AFFINITY_VARIABLE);
+    self->FlushDenormals = config_get_boolean(CONFIG_FLUSH_DENORMALS_VARIABLE, TRUE);
+
+    return S_OK;
+}
+
+/* ---------------------------------------------------------------------- */
+
+BOOL DELTACALL config_get_boolean(LPCSTR pszName, BOOL bDefault) {
+    CHAR value[MAX_VARIABLE_LENGTH];
+    ZeroMemory(value, MAX_VARIABLE_LENGTH);
+
+    const DWORD length = GetEnvironmentVariableA(pszName, value, MAX_VARIABLE_LENGTH);
+
+    if (length == 0 || MAX_VARIABLE_LENGTH <= length) {
+        return bDefault;
+    }
+
+    return lstrcmpiA(value, "1") == 0 || lstrcmpiA(value, "true") == 0
+        || lstrcmpiA(value, "yes") == 0 || lstrcmpiA(value, "on") == 0;
+}
+
+DWORD DELTACALL config_get_number(LPCSTR pszName, DWORD dwDefault, DWORD dwMin, DWORD dwMax) {
+    CHAR value[MAX_VARIABLE_LENGTH];
+    ZeroMemory(value, MAX_VARIABLE_LENGTH);
+
+    const DWORD length = GetEnvironmentVariableA(pszName, value, MAX_VARIABLE_LENGTH);
+
+    if (length == 0 || MAX_VARIABLE_LENGTH <= length) {
+        return dwDefault;
+    }
+
+    DWORD result = 0;
+
+    for (DWORD i = 0; i < length; i++) {
+        if (value[i] < '0' || '9' < value[i]) {
+            return dwDefault;
+        }
+
+        result = result * 10 + (value[i] - '0');
+
+        if (dwMax < result) {
+            return dwDefault;
+        }
+    }
+
+    // Only an unset variable takes the default, a zero is a value of its own where the minimum allows it.
+    return result < dwMin ? dwDefault : result;
+}
+
+DWORD DELTACALL config_get_backend(LPCSTR pszName, DWORD dwDefault) {
+    CHAR value[MAX_VARIABLE_LENGTH];
+    ZeroMemory(value, MAX_VARIABLE_LENGTH);
+
+    const DWORD length = GetEnvironmentVariableA(pszName, value, MAX_VARIABLE_LENGTH);
+
+    if (length == 0 || MAX_VARIABLE_LENGTH <= length) {
+        return dwDefault;
+    }
+
+    if (lstrcmpiA(value, "null") == 0) {
+        return CONFIG_BACKEND_NULL;
+    }
+
+    if (lstrcmpiA(value, "wav") == 0) {
+        return CONFIG_BACKEND_WAV;
+    }
+
+    return lstrcmpiA(value, "wasapi") == 0 ? CONFIG_BACKEND_WASAPI : dwDefault;
+}
+
+VOID DELTACALL config_get_path(LPCSTR pszName, LPCSTR pszDefault, LPSTR pszPath) {
+    const DWORD length = GetEnvironmentVariableA(pszName, pszPath, MAX_PATH);
+
+    if (length == 0 || MAX_PATH <= length) {
+        lstrcpynA(pszPath, pszDefault, MAX_PATH);
+    }
+}
+
+DWORD DELTACALL config_get_task(LPCSTR pszName, DWORD dwDefault) {
+    CHAR value[MAX_VARIABLE_LENGTH];
+    ZeroMemory(value, MAX_VARIABLE_LENGTH);
+
+    const DWORD length = GetEnvironmentVariableA(pszName, value, MAX_VARIABLE_LENGTH);
+
+    if (length == 0 || MAX_VARIABLE_LENGTH <= length) {
+        return dwDefault;
+    }
+
+    if (lstrcmpiA(value, "none") == 0) {
+        return CONFIG_MMCSS_TASK_NONE;
+    }
+
+    if (lstrcmpiA(value, "games") == 0) {
+        return CONFIG_MMCSS_TASK_GAMES;
+    }
+
+    return lstrcmpiA(value, "pro audio") == 0 ? CONFIG_MMCSS_TASK_PRO_AUDIO : dwDefault;
+}
+
+DWORD DELTACALL config_get_priority(LPCSTR pszName, DWORD dwDefault) {
+    CHAR value[MAX_VARIABLE_LENGTH];
+    ZeroMemory(value, MAX_VARIABLE_LENGTH);
+
+    const DWORD length = GetEnvironmentVariableA(pszName, value, MAX_VARIABLE_LENGTH);
+
+    if (length == 0 || MAX_VARIABLE_LENGTH <= length) {
+        return dwDefault;
+    }
+
+    if (lstrcmpiA(value, "low") == 0) {
+        return CONFIG_MMCSS_PRIORITY_LOW;
+    }
+
+    if (lstrcmpiA(value, "normal") == 0) {
+        return CONFIG_MMCSS_PRIORITY_NORMAL;
+    }
+
+    if (lstrcmpiA(value, "high") == 0) {
+        return CONFIG_MMCSS_PRIORITY_HIGH;
+    }
+
+    return lstrcmpiA(value, "critical") == 0 ? CONFIG_MMCSS_PRIORITY_CRITICAL : dwDefault;
+}
+
+DWORD64 DELTACALL config_get_mask(LPCSTR pszName) {
+    CHAR value[MAX_MASK_LENGTH];
+    ZeroMemory(value, MAX_MASK_LENGTH);
+
+    const DWORD length = GetEnvironmentVariableA(pszName, value, MAX_MASK_LENGTH);
+
+    if (length == 0 || MAX_MASK_LENGTH <= length) {
+        return 0;
+    }
+
+    DWORD64 result = 0;
+
+    if (2 < length && value[0] == '0' && (value[1] == 'x' || value[1] == 'X')) {
+        if (length - 2 > 16) {
+            return 0;
+        }
+
+        for (DWORD i = 2; i < length; i++) {
+            const CHAR c = value[i];
+
+            if ('0' <= c && c <= '9') {
+                result = (result << 4) | (DWORD64)(c - '0');
+            }
+            else if ('a' <= c && c <= 'f') {
+                result = (result << 4) | (DWORD64)(c - 'a' + 10);
+            }
+            else if ('A' <= c && c <= 'F') {
+                result = (result << 4) | (DWORD64)(c - 'A' + 10);
+            }
+            else {
+                return 0;
+            }
+        }
+
+        return result;
+    }
+
+    for (DWORD i = 0; i < length; i++) {
+        if (value[i] < '0' || '9' < value[i]) {
+            return 0;
+        }
+
+        const DWORD64 digit = (DWORD64)(value[i] - '0');
+
+        if ((~(DWORD64)0 - digit) / 10 < result) {
+            return 0;
+        }
+
+        result = result * 10 + digit;
+    }
+
+    return result;
+}
@@ -0,0 +1,148 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "base.h"
+
+// Name of the environment variable that enables the IEEE half precision cache of static buffers.
+// Accepts "1", "true", "yes" or "on", anything else leaves the option disabled.
+#define CONFIG_HALF_CACHE_VARIABLE      "DELTASOUND_HALF_CACHE"
+
+// Name of the environment variable that selects the slab allocator, enabled by default.
+// Any value other than the ones above falls back to the process heap.
+#define CONFIG_SLAB_ALLOCATOR_VARIABLE  "DELTASOUND_SLAB_ALLOCATOR"
+
+// Name of the environment variable that makes the allocator record the call site of every allocation,
+// so that the outstanding allocations can be reported by call site. Enabled by default in debug builds.
+#define CONFIG_ALLOCATOR_TRACKING_VARIABLE  "DELTASOUND_ALLOCATOR_TRACKING"
+
+// Name of the environment variable that makes the render thread report every allocation it makes,
+// and in debug builds every lock it takes. Enabled by default in debug builds.
+#define CONFIG_REALTIME_CHECK_VARIABLE      "DELTASOUND_REALTIME_CHECK"
+
+// Name of the environment variable with the number of voices the render thread is prepared to mix
+// without allocating, a positive decimal number.
+#define CONFIG_MAX_VOICES_VARIABLE          "DELTASOUND_MAX_VOICES"
+
+#define CONFIG_MAX_VOICES_DEFAULT           64
+#define CONFIG_MAX_VOICES_MIN               1
+#define CONFIG_MAX_VOICES_LIMIT             4096
+
+// Names of the environment variables with the bounds, in milliseconds, of how far ahead
+// of the endpoint the mix is rendered. The latency adapts between them to the timing of the device thread.
+#define CONFIG_MIN_LATENCY_VARIABLE         "DELTASOUND_MIN_LATENCY"
+#define CONFIG_MAX_LATENCY_VARIABLE         "DELTASOUND_MAX_LATENCY"
+
+#define CONFIG_MIN_LATENCY_DEFAULT          10
+#define CONFIG_MIN_LATENCY_LOW_LATENCY      0
+#define CONFIG_MAX_LATENCY_DEFAULT          100
+#define CONFIG_LATENCY_LIMIT                1000
+
+// Name of the environment variable that makes the "wasapi" backend ask the audio engine for its smallest period.
+// The minimum latency then defaults to none, the fill target follows the period and the timing of the device thread alone.
+#define CONFIG_LOW_LATENCY_VARIABLE         "DELTASOUND_LOW_LATENCY"
+
+// Name of the environment variable that makes the "wasapi" backend open the endpoint in exclusive mode,
+// in the native format of the device and at its smallest period. A shared stream is opened when the device refuses.
+#define CONFIG_EXCLUSIVE_VARIABLE           "DELTASOUND_EXCLUSIVE"
+
+// Name of the environment variable with the time, in milliseconds, the device renders silence
+// while no buffers play before it stops the endpoint and sleeps until one is played. Zero keeps the endpoint running.
+#define CONFIG_IDLE_TIMEOUT_VARIABLE        "DELTASOUND_IDLE_TIMEOUT"
+
+#define CONFIG_IDLE_TIMEOUT_DEFAULT         2000
+#define CONFIG_IDLE_TIMEOUT_LIMIT           3600000
+
+// Name of the environment variable that selects where the mix is rendered to, "wasapi" by default.
+// "null" consumes the mix at the rate of an endpoint without playing it, "wav" writes it to a file as well.
+#define CONFIG_BACKEND_VARIABLE             "DELTASOUND_BACKEND"
+
+// Name of the environment variable with the path of the file the "wav" backend writes to.
+#define CONFIG_BACKEND_FILE_VARIABLE        "DELTASOUND_BACKEND_FILE"
+
+#define CONFIG_BACKEND_FILE_DEFAULT         "deltasound.wav"
+
+// Name of the environment variable that makes the "null" and "wav" backends run on a virtual clock.
+// Every wait of the device thread then plays out one period at once, and the mix is rendered as fast as possible.
+#define CONFIG_VIRTUAL_CLOCK_VARIABLE       "DELTASOUND_VIRTUAL_CLOCK"
+
+// Name of the environment variable with the MMCSS task the render thread joins, "pro audio" by default.
+// "games" selects the task of game threads instead, "none" leaves the thread at the time critical priority.
+#define CONFIG_MMCSS_TASK_VARIABLE          "DELTASOUND_MMCSS_TASK"
+
+// Name of the environment variable with the priority of the render thread within its MMCSS task,
+// "low", "normal", "high" or "critical", "high" by default.
+#define CONFIG_MMCSS_PRIORITY_VARIABLE      "DELTASOUND_MMCSS_PRIORITY"
+
+// Name of the environment variable with the mask of the processors the render thread runs on,
+// a hexadecimal number with the "0x" prefix or a decimal number. The thread runs on any processor by default.
+#define CONFIG_AFFINITY_VARIABLE            "DELTASOUND_AFFINITY"
+
+// Name of the environment variable that makes the render thread flush denormal numbers to zero, enabled by default.
+// The tails of decaying voices and filters then cost the same as any other sample.
+#define CONFIG_FLUSH_DENORMALS_VARIABLE     "DELTASOUND_FLUSH_DENORMALS"
+
+#define CONFIG_BACKEND_WASAPI               0
+#define CONFIG_BACKEND_NULL                 1
+#define CONFIG_BACKEND_WAV                  2
+
+#define CONFIG_MMCSS_TASK_NONE              0
+#define CONFIG_MMCSS_TASK_PRO_AUDIO         1
+#define CONFIG_MMCSS_TASK_GAMES             2
+
+#define CONFIG_MMCSS_PRIORITY_LOW           0
+#define CONFIG_MMCSS_PRIORITY_NORMAL        1
+#define CONFIG_MMCSS_PRIORITY_HIGH          2
+#define CONFIG_MMCSS_PRIORITY_CRITICAL      3
+
+#ifdef _DEBUG
+#define CONFIG_ALLOCATOR_TRACKING_DEFAULT   TRUE
+#define CONFIG_REALTIME_CHECK_DEFAULT       TRUE
+#else
+#define CONFIG_ALLOCATOR_TRACKING_DEFAULT   FALSE
+#define CONFIG_REALTIME_CHECK_DEFAULT       FALSE
+#endif
+
+typedef struct config {
+    BOOL    HalfCache;
+    BOOL    SlabAllocator;
+    BOOL    AllocatorTracking;
+    BOOL    RealtimeCheck;
+    DWORD   MaxVoices;
+    BOOL    LowLatency;
+    BOOL    Exclusive;
+    DWORD   MinLatency;     // In milliseconds
+    DWORD   MaxLatency;     // In milliseconds
+    DWORD   IdleTimeout;    // In milliseconds
+    DWORD   Backend;
+    CHAR    BackendFile[MAX_PATH];
+    BOOL    VirtualClock;
+    DWORD   MmcssTask;
+    DWORD   MmcssPriority;
+    DWORD64 Affinity;       // None when zero
+    BOOL    FlushDenormals;
+} config;
+
+HRESULT DELTACALL config_initialize(config* pConfig);
\ No newline at end of file
@@ -0,0 +1,163 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "cpu.h"
+
+#if defined(_M_IX86) || defined(_M_X64)
+#include <intrin.h>
+#endif
+
+#define CPUID_BASIC                 0
+#define CPUID_FEATURES              1
+#define CPUID_EXTENDED_FEATURES     7
+
+#define CPUID_EDX_SSE2              (1 << 26)
+#define CPUID_ECX_SSE41             (1 << 19)
+#define CPUID_ECX_FMA               (1 << 12)
+#define CPUID_ECX_OSXSAVE           (1 << 27)
+#define CPUID_ECX_AVX               (1 << 28)
+#define CPUID_ECX_F16C              (1 << 29)
+#define CPUID_EBX_AVX2              (1 << 5)
+#define CPUID_EBX_AVX512F           (1 << 16)
+#define CPUID_EBX_AVX512BW          (1 << 30)
+
+#define XCR0_YMM_STATE              0x06
+#define XCR0_ZMM_STATE              0xE6
+
+#define MAX_OVERRIDE_LENGTH         16
+
+typedef struct cpu_tier {
+    LPCSTR  Name;
+    DWORD   Features;
+} cpu_tier;
+
+const static cpu_tier cpu_tiers[] = {
+    { "scalar", CPU_FEATURE_NONE },
+    { "sse2", CPU_FEATURE_SSE2 },
+    { "sse41", CPU_FEATURE_SSE2 | CPU_FEATURE_SSE41 },
+    { "avx2", CPU_FEATURE_SSE2 | CPU_FEATURE_SSE41 | CPU_FEATURE_AVX2 | CPU_FEATURE_FMA | CPU_FEATURE_F16C },
+    { "avx512", CPU_FEATURE_ALL }
+};
+
+DWORD DELTACALL cpu_probe();
+DWORD DELTACALL cpu_get_override();
+
+HRESULT DELTACALL cpu_get_features(LPDWORD pdwFeatures) {
+    if (pdwFeatures == NULL) {
+        return E_INVALIDARG;
+    }
+
+    *pdwFeatures = cpu_probe() & cpu_get_override();
+
+    return S_OK;
+}
+
+/* ---------------------------------------------------------------------- */
+
+DWORD DELTACALL cpu_probe() {
+    DWORD features = CPU_FEATURE_NONE;
+
+#if defined(_M_IX86) || defined(_M_X64)
+    int info[4] = { 0, 0, 0, 0 };
+
+    __cpuid(info, CPUID_BASIC);
+
+    const int maximum = info[0];
+
+    if (maximum < CPUID_FEATURES) {
+        return features;
+    }
+
+    __cpuid(info, CPUID_FEATURES);
+
+    const int ecx = info[2];
+    const int edx = info[3];
+
+    if (edx & CPUID_EDX_SSE2) {
+        features |= CPU_FEATURE_SSE2;
+    }
+
+    if (ecx & CPUID_ECX_SSE41) {
+        features |= CPU_FEATURE_SSE41;
+    }
+
+    // Wide registers are only usable when the operating system saves them on context switch.
+    if (!(ecx & CPUID_ECX_OSXSAVE) || !(ecx & CPUID_ECX_AVX)) {
+        return features;
+    }
+
+    const DWORD64 xcr0 = _xgetbv(0);
+
+    if ((xcr0 & XCR0_YMM_STATE) != XCR0_YMM_STATE) {
+        return features;
+    }
+
+    if (ecx & CPUID_ECX_FMA) {
+        features |= CPU_FEATURE_FMA;
+    }
+
+    if (ecx & CPUID_ECX_F16C) {
+        features |= CPU_FEATURE_F16C;
+    }
+
+    if (maximum < CPUID_EXTENDED_FEATURES) {
+        return features;
+    }
+
+    __cpuidex(info, CPUID_EXTENDED_FEATURES, 0);
+
+    const int ebx = info[1];
+
+    if (ebx & CPUID_EBX_AVX2) {
+        features |= CPU_FEATURE_AVX2;
+    }
+
+    if ((xcr0 & XCR0_ZMM_STATE) == XCR0_ZMM_STATE) {
+        if ((ebx & CPUID_EBX_AVX512F) && (ebx & CPUID_EBX_AVX512BW)) {
+            features |= CPU_FEATURE_AVX512;
+        }
+    }
+#endif
+
+    return features;
+}
+
+DWORD DELTACALL cpu_get_override() {
+    CHAR value[MAX_OVERRIDE_LENGTH];
+    ZeroMemory(value, MAX_OVERRIDE_LENGTH);
+
+    const DWORD length = GetEnvironmentVariableA(CPU_OVERRIDE_VARIABLE, value, MAX_OVERRIDE_LENGTH);
+
+    if (length == 0 || MAX_OVERRIDE_LENGTH <= length) {
+        return CPU_FEATURE_ALL;
+    }
+
+    for (DWORD i = 0; i < _countof(cpu_tiers); i++) {
+        if (lstrcmpiA(cpu_tiers[i].Name, value) == 0) {
+            return cpu_tiers[i].Features;
+        }
+    }
+
+    return CPU_FEATURE_ALL;
+}
@@ -0,0 +1,44 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "base.h"
+
+#define CPU_FEATURE_NONE        0
+#define CPU_FEATURE_SSE2        0x1
+#define CPU_FEATURE_SSE41       0x2
+#define CPU_FEATURE_AVX2        0x4
+#define CPU_FEATURE_FMA         0x8
+#define CPU_FEATURE_F16C        0x10
+#define CPU_FEATURE_AVX512      0x20
+
+#define CPU_FEATURE_ALL         (CPU_FEATURE_SSE2 | CPU_FEATURE_SSE41 | CPU_FEATURE_AVX2 \
+                                    | CPU_FEATURE_FMA | CPU_FEATURE_F16C | CPU_FEATURE_AVX512)
+
+// Name of the environment variable that limits the detected features to a single tier,
+// one of "scalar", "sse2", "sse41", "avx2" or "avx512".
+#define CPU_OVERRIDE_VARIABLE   "DELTASOUND_CPU"
+
+HRESULT DELTACALL cpu_get_features(LPDWORD pdwFeatures);
\ No newline at end of file
@@ -23,10 +23,12 @@ SOFTWARE.
 */
 
 #include "cf.h"
+#include "cpu.h"
 #include "deltasound.h"
 #include "device_info.h"
 #include "ds.h"
 #include "dsc.h"
+#include "dsdevice.h"
 #include "prvt.h"
 
 #define DELTASOUNDDEVICE_INVALID_COUNT ((DWORD)-1)
@@ -38,18 +40,30 @@ HRESULT DELTACALL deltasound_create(allocator* pAlloc, deltasound** ppOut) {
     if (SUCCEEDED(hr = allocator_allocate(pAlloc, sizeof(deltasound), &instance))) {
         instance->Allocator = pAlloc;
 
+        if (FAILED(hr = config_initialize(&instance->Config))
+            || FAILED(hr = cpu_get_features(&instance->Features))
+            || FAILED(hr = kernel_initialize(&instance->Kernel, instance->Features))) {
+            allocator_free(pAlloc, instance);
+            return hr;
+        }
+
         if (SUCCEEDED(hr = arr_create(pAlloc, &instance->Render))) {
             if (SUCCEEDED(hr = arr_create(pAlloc, &instance->Capture))) {
                 if (SUCCEEDED(hr = arr_create(pAlloc, &instance->Create))) {
                     if (SUCCEEDED(hr = arr_create(pAlloc, &instance->Private))) {
-                        InitializeCriticalSection(&instance->Lock);
+                        if (SUCCEEDED(hr = arr_create(pAlloc, &instance->Devices))) {
+                            InitializeCriticalSection(&instance->Lock);
+                            InitializeCriticalSection(&instance->DeviceLock);
+
+                            *ppOut = instance;
 
-                        *ppOut = instance;
+                            return S_OK;
+                        }
 
-                        return S_OK;
+                        arr_release(instance->Private);
                     }
 
-                    arr_release(instance->Private);
+                    arr_release(instance->Create);
                 }
 
                 arr_release(instance->Capture);
@@ -115,8 +129,23 @@ VOID DELTACALL deltasound_release(deltasound* self) {
         }
     }
 
+    // The devices are released with the DirectSound objects, the ones left behind are released here.
+    {
+        const DWORD count = arr_get_count(self->Devices);
+
+        for (DWORD i = 0; i < count; i++) {
+            dsdevice* instance = NULL;
+
+            if (SUCCEEDED(arr_get_item(self->Devices, i, &instance))) {
+                dsdevice_release(instance);
+            }
+        }
+    }
+
     DeleteCriticalSection(&self->Lock);
+    DeleteCriticalSection(&self->DeviceLock);
 
+    arr_release(self->Devices);
     arr_release(self->Render);
     arr_release(self->Capture);
     arr_release(self->Create);
@@ -143,8 +172,7 @@ HRESULT DELTACALL deltasound_create_direct_sound(deltasound* self,
     HRESULT hr = S_OK;
     ds* instance = NULL;
 
-    EnterCriticalSection(&self->Lock);
-
+    // The device is acquired without the instance lock, which is always taken after the device lock.
     if (SUCCEEDED(hr = ds_create(self->Allocator, rclsid, &instance))) {
         instance->Instance = self;
 
@@ -155,11 +183,16 @@ HRESULT DELTACALL deltasound_create_direct_sound(deltasound* self,
                 ? &IID_IDirectSound : &IID_IDirectSound8;
 
             if (SUCCEEDED(hr = ds_query_interface(instance, riid, &intfc))) {
-                if (SUCCEEDED(hr = arr_add_item(self->Render, instance))) {
+                EnterCriticalSection(&self->Lock);
+
+                hr = arr_add_item(self->Render, instance);
+
+                LeaveCriticalSection(&self->Lock);
 
+                if (SUCCEEDED(hr)) {
                     *ppOut = intfc;
 
-                    goto exit;
+                    return S_OK;
                 }
             }
         }
@@ -167,10 +200,6 @@ HRESULT DELTACALL deltasound_create_direct_sound(deltasound* self,
         ds_release(instance);
     }
 
-exit:
-
-    LeaveCriticalSection(&self->Lock);
-
     return hr;
 }
 
@@ -207,6 +236,83 @@ exit:
     return hr;
 }
 
+HRESULT DELTACALL deltasound_acquire_device(deltasound* self, device_info* pInfo, dsdevice** ppOut) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (pInfo == NULL || ppOut == NULL) {
+        return E_INVALIDARG;
+    }
+
+    HRESULT hr = S_OK;
+    dsdevice* instance = NULL;
+
+    // The endpoint is opened outside of the instance lock, a device that fails to open or opens slowly
+    // holds up only the other devices being created. The instance lock is only ever taken after this one.
+    EnterCriticalSection(&self->DeviceLock);
+
+    if ((hr = deltasound_find_device(self, pInfo, &instance)) == S_OK) {
+        *ppOut = instance;
+    }
+    else if (SUCCEEDED(hr = dsdevice_create(self->Allocator, self, pInfo, &instance))) {
+        instance->References = 1;
+
+        EnterCriticalSection(&self->Lock);
+
+        hr = arr_add_item(self->Devices, instance);
+
+        LeaveCriticalSection(&self->Lock);
+
+        if (SUCCEEDED(hr)) {
+            *ppOut = instance;
+        }
+        else {
+            dsdevice_release(instance);
+        }
+    }
+
+    LeaveCriticalSection(&self->DeviceLock);
+
+    return hr;
+}
+
+HRESULT DELTACALL deltasound_release_device(deltasound* self, dsdevice* pDev) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (pDev == NULL) {
+        return E_INVALIDARG;
+    }
+
+    HRESULT hr = S_FALSE;
+    dsdevice* instance = NULL;
+
+    EnterCriticalSection(&self->Lock);
+
+    const DWORD count = arr_get_count(self->Devices);
+
+    for (DWORD i = 0; i < count; i++) {
+        if (SUCCEEDED(arr_get_item(self->Devices, i, &instance)) && instance == pDev) {
+            if (--instance->References == 0) {
+                hr = arr_remove_item(self->Devices, i, NULL);
+            }
+
+            break;
+        }
+    }
+
+    LeaveCriticalSection(&self->Lock);
+
+    // The render thread is stopped outside of the lock, it never takes it.
+    if (hr == S_OK) {
+        dsdevice_release(pDev);
+    }
+
+    return hr;
+}
+
 HRESULT DELTACALL deltasound_create_direct_sound_capture(deltasound* self,
     REFCLSID rclsid, LPCGUID pcGuidDevice, LPVOID* ppOut) {
     if (self == NULL) {
@@ -427,3 +533,36 @@ HRESULT DELTACALL deltasound_can_unload(deltasound* self) {
 
     return result ? S_OK : S_FALSE;
 }
+
+HRESULT DELTACALL deltasound_find_device(deltasound* self, device_info* pInfo, dsdevice** ppOut) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (pInfo == NULL || ppOut == NULL) {
+        return E_INVALIDARG;
+    }
+
+    HRESULT hr = S_FALSE;
+    dsdevice* instance = NULL;
+
+    EnterCriticalSection(&self->Lock);
+
+    const DWORD count = arr_get_count(self->Devices);
+
+    for (DWORD i = 0; i < count; i++) {
+        if (SUCCEEDED(arr_get_item(self->Devices, i, &instance)) && IsEqualGUID(&instance->Info.ID, &pInfo->ID)) {
+            instance->References++;
+
+            *ppOut = instance;
+
+            hr = S_OK;
+
+            break;
+        }
+    }
+
+    LeaveCriticalSection(&self->Lock);
+
+    return hr;
+}
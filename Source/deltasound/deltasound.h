@@ -25,20 +25,31 @@ SOFTWARE.
 #pragma once
 
 #include "arr.h"
+#include "config.h"
+#include "device_info.h"
+#include "kernel.h"
 
 typedef struct cf cf;
 typedef struct ds ds;
 typedef struct dsc dsc;
+typedef struct dsdevice dsdevice;
 typedef struct prvt prvt;
 
 typedef struct deltasound {
     allocator*          Allocator;
     CRITICAL_SECTION    Lock;
+    CRITICAL_SECTION    DeviceLock; // Serializes the creation of the devices, which waits for the endpoint to open
 
     arr*                Create;
     arr*                Render;
     arr*                Capture;
     arr*                Private;
+    arr*                Devices;
+
+    config              Config;
+
+    DWORD               Features;
+    kernel              Kernel;
 } deltasound;
 
 HRESULT DELTACALL deltasound_create(allocator* pAlloc, deltasound** ppOut);
@@ -48,6 +59,12 @@ HRESULT DELTACALL deltasound_create_direct_sound(deltasound* pD,
     REFCLSID rclsid, LPCGUID pcGuidDevice, LPVOID* ppOut);
 HRESULT DELTACALL deltasound_remove_direct_sound(deltasound* pD, ds* pDS);
 
+// The DirectSound objects that play to the same endpoint share its device, it is released with the last of them.
+HRESULT DELTACALL deltasound_acquire_device(deltasound* pD, device_info* pInfo, dsdevice** ppOut);
+HRESULT DELTACALL deltasound_release_device(deltasound* pD, dsdevice* pDev);
+// Takes a reference on the open device of the endpoint, or returns S_FALSE when none is open.
+HRESULT DELTACALL deltasound_find_device(deltasound* pD, device_info* pInfo, dsdevice** ppOut);
+
 HRESULT DELTACALL deltasound_create_direct_sound_capture(deltasound* pD,
     REFCLSID rclsid, LPCGUID pcGuidDevice, LPVOID* ppOut);
 HRESULT DELTACALL deltasound_remove_direct_sound_capture(deltasound* pD, dsc* pDSC);
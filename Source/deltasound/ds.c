@@ -43,7 +43,7 @@ HRESULT DELTACALL ds_create(allocator* pAlloc, REFCLSID rclsid, ds** ppOut) {
         CopyMemory(&instance->ID, rclsid, sizeof(CLSID));
 
         if (SUCCEEDED(hr = intfc_create(pAlloc, &instance->Interfaces))) {
-            if (SUCCEEDED(hr = arr_create(pAlloc, &instance->Buffers))) {
+            if (SUCCEEDED(hr = slm_create(pAlloc, &instance->Buffers))) {
                 dsb* main = NULL;
 
                 REFIID riid = IsEqualCLSID(&CLSID_DirectSound, rclsid)
@@ -59,7 +59,7 @@ HRESULT DELTACALL ds_create(allocator* pAlloc, REFCLSID rclsid, ds** ppOut) {
                     return S_OK;
                 }
 
-                arr_release(instance->Buffers);
+                slm_release(instance->Buffers);
             }
 
             intfc_release(instance->Interfaces);
@@ -74,10 +74,6 @@ HRESULT DELTACALL ds_create(allocator* pAlloc, REFCLSID rclsid, ds** ppOut) {
 VOID DELTACALL ds_release(ds* self) {
     if (self == NULL) { return; }
 
-    if (self->Device != NULL) {
-        dsdevice_release(self->Device);
-    }
-
     DeleteCriticalSection(&self->Lock);
 
     {
@@ -95,21 +91,27 @@ VOID DELTACALL ds_release(ds* self) {
     intfc_release(self->Interfaces);
 
     {
-        const DWORD count = arr_get_count(self->Buffers);
-
-        for (DWORD i = 0; i < count; i++) {
+        // Each buffer removes itself from the registry, so the registry is released from its end.
+        for (DWORD i = slm_get_count(self->Buffers); i != 0; i--) {
             dsb* instance = NULL;
 
-            if (SUCCEEDED(arr_get_item(self->Buffers, i, &instance))) {
+            if (SUCCEEDED(slm_get_item_at(self->Buffers, i - 1, &instance))) {
                 dsb_release(instance);
             }
         }
     }
 
-    arr_release(self->Buffers);
+    slm_release(self->Buffers);
 
     dsb_release(self->Main);
 
+    // The device is shared, it keeps rendering for the other DirectSound objects.
+    // The buffers above were stopped and dropped from it before they were freed.
+    if (self->Device != NULL) {
+        deltasound_release_device(self->Instance, self->Device);
+        self->Device = NULL;
+    }
+
     if (self->Instance != NULL) {
         deltasound_remove_direct_sound(self->Instance, self);
     }
@@ -195,7 +197,7 @@ HRESULT DELTACALL ds_create_sound_buffer(ds* self, REFIID riid, LPCDSBUFFERDESC
 
     if (SUCCEEDED(hr = dsb_create(self->Allocator, riid, &instance))) {
         if (SUCCEEDED(hr = dsb_initialize(instance, self, pcDesc))) {
-            if (SUCCEEDED(hr = arr_add_item(self->Buffers, instance))) {
+            if (SUCCEEDED(hr = slm_add_item(self->Buffers, instance, &instance->Handle))) {
 
                 *ppOut = instance;
 
@@ -214,17 +216,14 @@ exit:
 }
 
 HRESULT DELTACALL ds_remove_sound_buffer(ds* self, dsb* pDSB) {
-    HRESULT hr = S_OK;
-    const DWORD count = arr_get_count(self->Buffers);
+    if (pDSB->Handle == SLM_INVALID_HANDLE) {
+        return S_OK;
+    }
 
-    for (DWORD i = 0; i < count; i++) {
-        dsb* instance = NULL;
+    HRESULT hr = S_OK;
 
-        if (SUCCEEDED(hr = arr_get_item(self->Buffers, i, &instance))) {
-            if (instance == pDSB) {
-                return arr_remove_item(self->Buffers, i, NULL);
-            }
-        }
+    if (SUCCEEDED(hr = slm_remove_item(self->Buffers, pDSB->Handle, NULL))) {
+        pDSB->Handle = SLM_INVALID_HANDLE;
     }
 
     return hr;
@@ -268,21 +267,14 @@ HRESULT DELTACALL ds_duplicate_sound_buffer(ds* self, dsb* pDSBufferOriginal, ds
 
     EnterCriticalSection(&self->Lock);
 
-    const DWORD count = arr_get_count(self->Buffers);
-
-    for (DWORD i = 0; i < count; i++) {
-        dsb* instance = NULL;
+    dsb* instance = NULL;
 
-        if (SUCCEEDED(arr_get_item(self->Buffers, i, &instance))) {
-            if (instance == pDSBufferOriginal) {
-                hr = dsb_duplicate(pDSBufferOriginal, ppDSBufferDuplicate);
-                goto exit;
-            }
+    if (SUCCEEDED(slm_get_item(self->Buffers, pDSBufferOriginal->Handle, &instance))) {
+        if (instance == pDSBufferOriginal) {
+            hr = dsb_duplicate(pDSBufferOriginal, ppDSBufferDuplicate);
         }
     }
 
-exit:
-
     LeaveCriticalSection(&self->Lock);
 
     return hr;
@@ -320,9 +312,26 @@ HRESULT DELTACALL ds_initialize(ds* self, LPCGUID pcGuidDevice) {
         return DSERR_NODRIVER;
     }
 
+    dsdevice* device = NULL;
+
+    // The device is acquired outside of the lock, the instance lock is taken after the one of the object elsewhere.
+    if (FAILED(hr = deltasound_acquire_device(self->Instance, &info, &device))) {
+        return hr;
+    }
+
     EnterCriticalSection(&self->Lock);
 
-    if (SUCCEEDED(hr = dsdevice_create(self->Allocator, self, &info, &self->Device))) {
+    if (self->Device != NULL) {
+        LeaveCriticalSection(&self->Lock);
+
+        deltasound_release_device(self->Instance, device);
+
+        return DSERR_ALREADYINITIALIZED;
+    }
+
+    self->Device = device;
+
+    {
         DSBUFFERDESC desc;
         ZeroMemory(&desc, sizeof(DSBUFFERDESC));
 
@@ -348,20 +357,18 @@ HRESULT DELTACALL ds_set_cooperative_level(ds* self, HWND hwnd, DWORD dwLevel) {
     self->Level = dwLevel;
 
     if (dwLevel == DSSCL_WRITEPRIMARY) {
-        const DWORD count = arr_get_count(self->Buffers);
+        const DWORD count = slm_get_count(self->Buffers);
 
         for (DWORD i = 0; i < count; i++) {
             dsb* instance = NULL;
 
-            if (SUCCEEDED(arr_get_item(self->Buffers, i, &instance))) {
-                instance->Play = DSBPLAY_NONE;
-                instance->Status = DSBSTATUS_BUFFERLOST;
+            if (SUCCEEDED(slm_get_item_at(self->Buffers, i, &instance))) {
+                dsb_set_status(instance, DSBPLAY_NONE, DSBSTATUS_BUFFERLOST);
             }
         }
     }
     else {
-        self->Main->Play = DSBPLAY_NONE;
-        self->Main->Status = DSBSTATUS_NONE;
+        dsb_set_status(self->Main, DSBPLAY_NONE, DSBSTATUS_NONE);
 
         dsbcb_set_current_position(self->Main->Buffer, 0, 0, DSBCB_SETPOSITION_NONE);
     }
@@ -380,7 +387,34 @@ HRESULT DELTACALL ds_compact(ds* self) {
         return DSERR_PRIOLEVELNEEDED;
     }
 
-    return S_OK;
+    DWORD64 bytes = 0;
+
+    EnterCriticalSection(&self->Lock);
+
+    // The buffers that are not playing give up the caches no duplicate shares,
+    // they are read from the samples when played again.
+    const DWORD count = slm_get_count(self->Buffers);
+
+    for (DWORD i = 0; i < count; i++) {
+        dsb* instance = NULL;
+
+        if (SUCCEEDED(slm_get_item_at(self->Buffers, i, &instance))) {
+            DWORD released = 0;
+
+            if (SUCCEEDED(dsb_compact(instance, &released))) {
+                bytes += released;
+            }
+        }
+    }
+
+    LeaveCriticalSection(&self->Lock);
+
+    InterlockedAdd64(&self->Device->Reclaimed, (LONG64)bytes);
+
+    // The arenas and the pools are owned by the render thread, so it trims them at the next period.
+    const dscmd command = { DSCQ_COMMAND_COMPACT, NULL, DSBPLAY_NONE, DSBSTATUS_NONE };
+
+    return dsdevice_post(self->Device, &command);
 }
 
 HRESULT DELTACALL ds_get_status(ds* self, LPDWORD pdwStatus) {
@@ -406,12 +440,12 @@ HRESULT DELTACALL ds_get_status(ds* self, LPDWORD pdwStatus) {
 
     EnterCriticalSection(&self->Lock);
 
-    const DWORD count = arr_get_count(self->Buffers);
+    const DWORD count = slm_get_count(self->Buffers);
 
     for (DWORD i = 0; i < count; i++) {
         dsb* instance = NULL;
 
-        if (SUCCEEDED(arr_get_item(self->Buffers, i, &instance))) {
+        if (SUCCEEDED(slm_get_item_at(self->Buffers, i, &instance))) {
             if (SUCCEEDED(hr = dsb_get_status(instance, &status))) {
                 if (status & DSBSTATUS_PLAYING) {
 
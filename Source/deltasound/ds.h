@@ -24,8 +24,8 @@ SOFTWARE.
 
 #pragma once
 
-#include "arr.h"
 #include "intfc.h"
+#include "slm.h"
 
 #define DS_STATUS_NONE      0
 #define DS_STATUS_PLAYING   1
@@ -48,7 +48,7 @@ typedef struct ds {
     dsdevice*           Device;
 
     dsb*                Main;       // Primary Buffer
-    arr*                Buffers;    // Secondary Buffers
+    slm*                Buffers;    // Secondary Buffers
 } ds;
 
 HRESULT DELTACALL ds_create(allocator* pAlloc, REFCLSID rclsid, ds** ppOut);
@@ -22,8 +22,10 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include "deltasound.h"
 #include "ds.h"
 #include "dsb.h"
+#include "dsdevice.h"
 #include "dsn.h"
 #include "dssb.h"
 #include "dssl.h"
@@ -33,9 +35,18 @@ SOFTWARE.
 
 #define DSB_PLAY_WRITE_CURSOR_FRAME_COUNT   800
 
+#define DSB_RENDER_STATE_ATTEMPT_COUNT      64
+
 #define ADVANCEWRITEPOSITION(X, ALIGN) (X + DSB_PLAY_WRITE_CURSOR_FRAME_COUNT * ALIGN)
 
-HRESULT DELTACALL dsb_trigger_notifications(dsb* pDSB, DWORD dwPosition, DWORD dwAdvance);
+HRESULT DELTACALL dsb_bind_voice(dsb* pDSB);
+HRESULT DELTACALL dsb_select_voice(dsb* pDSB);
+HRESULT DELTACALL dsb_reserve_voice(dsb* pDSB);
+HRESULT DELTACALL dsb_create_cache(dsb* pDSB);
+HRESULT DELTACALL dsb_update_cache(dsb* pDSB, LPVOID pvAudioPtr, DWORD dwAudioBytes);
+HRESULT DELTACALL dsb_read_state(dsb* pDSB, dsbs* pState, LPLONG plSequence);
+HRESULT DELTACALL dsb_try_lock_state(dsb* pDSB, LONG lSequence);
+HRESULT DELTACALL dsb_trigger_notifications(dsb* pDSB, DWORD dwStatus, DWORD dwPosition, DWORD dwAdvance);
 
 HRESULT DELTACALL dsb_create(allocator* pAlloc, REFIID riid, dsb** ppOut) {
     if (pAlloc == NULL || riid == NULL || ppOut == NULL) {
@@ -45,8 +56,9 @@ HRESULT DELTACALL dsb_create(allocator* pAlloc, REFIID riid, dsb** ppOut) {
     HRESULT hr = S_OK;
     dsb* instance = NULL;
 
-    if (SUCCEEDED(hr = allocator_allocate(pAlloc, sizeof(dsb), &instance))) {
+    if (SUCCEEDED(hr = allocator_allocate_aligned(pAlloc, sizeof(dsb), ALLOCATOR_CACHE_LINE_SIZE, &instance))) {
         instance->Allocator = pAlloc;
+        instance->ActiveIndex = DSB_INACTIVE_INDEX;
 
         CopyMemory(&instance->ID, riid, sizeof(IID));
 
@@ -64,7 +76,7 @@ HRESULT DELTACALL dsb_create(allocator* pAlloc, REFIID riid, dsb** ppOut) {
             allocator_free(pAlloc, instance->Format);
         }
 
-        allocator_free(pAlloc, instance);
+        allocator_free_aligned(pAlloc, instance);
     }
 
     return hr;
@@ -73,8 +85,16 @@ HRESULT DELTACALL dsb_create(allocator* pAlloc, REFIID riid, dsb** ppOut) {
 VOID DELTACALL dsb_release(dsb* self) {
     if (self == NULL) { return; }
 
-    self->Play = DSBPLAY_NONE;
-    self->Status = DSBSTATUS_NONE;
+    dsb_set_status(self, DSBPLAY_NONE, DSBSTATUS_NONE);
+
+    // The render thread drops the buffer once it applies the stop, only then it can be freed.
+    if (self->Instance != NULL && self->Instance->Device != NULL) {
+        dscq_flush(self->Instance->Device->Commands);
+
+        if (self->Reserved) {
+            dsdevice_release_voice(self->Instance->Device);
+        }
+    }
 
     DeleteCriticalSection(&self->Lock);
 
@@ -103,7 +123,7 @@ VOID DELTACALL dsb_release(dsb* self) {
     }
 
     allocator_free(self->Allocator, self->Format);
-    allocator_free(self->Allocator, self);
+    allocator_free_aligned(self->Allocator, self);
 }
 
 HRESULT DELTACALL dsb_duplicate(dsb* self, dsb** ppOut) {
@@ -120,7 +140,7 @@ HRESULT DELTACALL dsb_duplicate(dsb* self, dsb** ppOut) {
 
     EnterCriticalSection(&self->Lock);
 
-    if (SUCCEEDED(hr = allocator_allocate(self->Allocator, sizeof(dsb), &instance))) {
+    if (SUCCEEDED(hr = allocator_allocate_aligned(self->Allocator, sizeof(dsb), ALLOCATOR_CACHE_LINE_SIZE, &instance))) {
         instance->Allocator = self->Allocator;
 
         CopyMemory(&instance->ID, &self->ID, sizeof(IID));
@@ -138,17 +158,19 @@ HRESULT DELTACALL dsb_duplicate(dsb* self, dsb** ppOut) {
                     CopyMemory(&instance->Caps, &self->Caps, sizeof(DSBCAPS));
                     CopyMemory(instance->Format, self->Format, SIZEOFFORMATEX(self->Format));
 
-                    instance->Volume = self->Volume;
-                    instance->Pan = self->Pan;
-                    instance->Frequency = self->Frequency;
+                    dsb_get_state(self, &instance->State);
+
                     instance->Priority = self->Priority;
+                    instance->HalfCache = self->HalfCache;
 
                     CopyMemory(&instance->SpatialAlgorithm, &self->SpatialAlgorithm, sizeof(GUID));
 
-                    instance->Play = DSBPLAY_NONE;
-                    instance->Status = DSBSTATUS_NONE;
+                    instance->State.Play = DSBPLAY_NONE;
+                    instance->State.Status = DSBSTATUS_NONE;
+
+                    instance->ActiveIndex = DSB_INACTIVE_INDEX;
 
-                    if (SUCCEEDED(hr = arr_add_item(self->Instance->Buffers, instance))) {
+                    if (SUCCEEDED(hr = slm_add_item(self->Instance->Buffers, instance, &instance->Handle))) {
 
                         *ppOut = instance;
 
@@ -164,7 +186,7 @@ HRESULT DELTACALL dsb_duplicate(dsb* self, dsb** ppOut) {
             allocator_free(self->Allocator, instance->Format);
         }
 
-        allocator_free(self->Allocator, instance);
+        allocator_free_aligned(self->Allocator, instance);
     }
 
 exit:
@@ -322,8 +344,7 @@ HRESULT DELTACALL dsb_get_current_position(dsb* self,
         }
     }
     else if (self->Instance->Level == DSSCL_WRITEPRIMARY) {
-        self->Play = DSBPLAY_NONE;
-        self->Status = DSBSTATUS_BUFFERLOST;
+        dsb_set_status(self, DSBPLAY_NONE, DSBSTATUS_BUFFERLOST);
 
         return DSERR_BUFFERLOST;
     }
@@ -365,7 +386,10 @@ HRESULT DELTACALL dsb_get_volume(dsb* self, PFLOAT pfVolume) {
         return DSERR_CONTROLUNAVAIL;
     }
 
-    *pfVolume = self->Volume;
+    dsbs state;
+    dsb_get_state(self, &state);
+
+    *pfVolume = state.Volume;
 
     return S_OK;
 }
@@ -379,7 +403,10 @@ HRESULT DELTACALL dsb_get_pan(dsb* self, PFLOAT pfPan) {
         return DSERR_CONTROLUNAVAIL;
     }
 
-    *pfPan = self->Pan;
+    dsbs state;
+    dsb_get_state(self, &state);
+
+    *pfPan = state.Pan;
 
     return S_OK;
 }
@@ -393,8 +420,11 @@ HRESULT DELTACALL dsb_get_frequency(dsb* self, LPDWORD pdwFrequency) {
         return DSERR_CONTROLUNAVAIL;
     }
 
-    *pdwFrequency = self->Frequency == DSBFREQUENCY_ORIGINAL
-        ? self->Format->nSamplesPerSec : self->Frequency;
+    dsbs state;
+    dsb_get_state(self, &state);
+
+    *pdwFrequency = state.Frequency == DSBFREQUENCY_ORIGINAL
+        ? self->Format->nSamplesPerSec : state.Frequency;
 
     return S_OK;
 }
@@ -406,12 +436,14 @@ HRESULT DELTACALL dsb_get_status(dsb* self, LPDWORD pdwStatus) {
 
     if (!(self->Caps.dwFlags & DSBCAPS_PRIMARYBUFFER)) {
         if (self->Instance->Level == DSSCL_WRITEPRIMARY) {
-            self->Play = DSBPLAY_NONE;
-            self->Status = DSBSTATUS_BUFFERLOST;
+            dsb_set_status(self, DSBPLAY_NONE, DSBSTATUS_BUFFERLOST);
         }
     }
 
-    *pdwStatus = self->Status;
+    dsbs state;
+    dsb_get_state(self, &state);
+
+    *pdwStatus = state.Status;
 
     return S_OK;
 }
@@ -429,8 +461,8 @@ HRESULT DELTACALL dsb_initialize(dsb* self, ds* pDS, LPCDSBUFFERDESC pcDesc) {
         self->Caps.dwFlags |= DSBCAPS_LOCSOFTWARE;
     }
 
-    self->Pan = DSB_CENTER_PAN;
-    self->Volume = DSB_MAX_VOLUME;
+    self->State.Pan = DSB_CENTER_PAN;
+    self->State.Volume = DSB_MAX_VOLUME;
 
     if (self->Caps.dwFlags & DSBCAPS_PRIMARYBUFFER) {
         self->Caps.dwBufferBytes = DSB_DEFAULT_PRIMARY_BUFFER_SIZE;
@@ -452,7 +484,15 @@ HRESULT DELTACALL dsb_initialize(dsb* self, ds* pDS, LPCDSBUFFERDESC pcDesc) {
         CopyMemory(&self->SpatialAlgorithm, &pcDesc->guid3DAlgorithm, sizeof(GUID));
     }
 
-    return dsbcb_create(self->Allocator, self->Caps.dwBufferBytes, &self->Buffer);
+    HRESULT hr = S_OK;
+
+    if (SUCCEEDED(hr = dsbcb_create(self->Allocator, self->Caps.dwBufferBytes, &self->Buffer))) {
+        if (SUCCEEDED(hr = dsb_create_cache(self))) {
+            hr = dsb_bind_voice(self);
+        }
+    }
+
+    return hr;
 }
 
 HRESULT DELTACALL dsb_lock(dsb* self, DWORD dwOffset, DWORD dwBytes,
@@ -471,15 +511,14 @@ HRESULT DELTACALL dsb_lock(dsb* self, DWORD dwOffset, DWORD dwBytes,
         }
     }
     else if (self->Instance->Level == DSSCL_WRITEPRIMARY) {
-        self->Play = DSBPLAY_NONE;
-        self->Status = DSBSTATUS_BUFFERLOST;
+        dsb_set_status(self, DSBPLAY_NONE, DSBSTATUS_BUFFERLOST);
 
         hr = DSERR_BUFFERLOST;
         
         goto fail;
     }
 
-    if (self->Status & DSBSTATUS_BUFFERLOST) {
+    if (self->State.Status & DSBSTATUS_BUFFERLOST) {
         hr = DSERR_BUFFERLOST;
 
         goto fail;
@@ -542,13 +581,12 @@ HRESULT DELTACALL dsb_play(dsb* self, DWORD dwPriority, DWORD dwFlags) {
         }
     }
     else if (self->Instance->Level == DSSCL_WRITEPRIMARY) {
-        self->Play = DSBPLAY_NONE;
-        self->Status = DSBSTATUS_BUFFERLOST;
+        dsb_set_status(self, DSBPLAY_NONE, DSBSTATUS_BUFFERLOST);
 
         return DSERR_BUFFERLOST;
     }
 
-    if (self->Status & DSBSTATUS_BUFFERLOST) {
+    if (self->State.Status & DSBSTATUS_BUFFERLOST) {
         return DSERR_BUFFERLOST;
     }
 
@@ -579,14 +617,13 @@ HRESULT DELTACALL dsb_play(dsb* self, DWORD dwPriority, DWORD dwFlags) {
             return E_INVALIDARG;
         }
 
-        const DWORD count = arr_get_count(self->Instance->Buffers);
+        const DWORD count = slm_get_count(self->Instance->Buffers);
 
         for (DWORD i = 0; i < count; i++) {
             dsb* instance = NULL;
 
-            if (SUCCEEDED(arr_get_item(self->Instance->Buffers, i, &instance))) {
-                instance->Play = DSBPLAY_NONE;
-                instance->Status = DSBSTATUS_BUFFERLOST;
+            if (SUCCEEDED(slm_get_item_at(self->Instance->Buffers, i, &instance))) {
+                dsb_set_status(instance, DSBPLAY_NONE, DSBSTATUS_BUFFERLOST);
             }
         }
     }
@@ -610,24 +647,28 @@ HRESULT DELTACALL dsb_play(dsb* self, DWORD dwPriority, DWORD dwFlags) {
     HRESULT hr = S_OK;
     DWORD read = 0, write = 0;
 
+    if (FAILED(hr = dsb_reserve_voice(self))) {
+        return hr;
+    }
+
     if (SUCCEEDED(hr = dsbcb_get_current_position(self->Buffer, &read, &write))) {
         const DWORD advance = min(self->Caps.dwBufferBytes,
             ADVANCEWRITEPOSITION(write, self->Format->nBlockAlign));
 
         if (SUCCEEDED(hr = dsbcb_set_current_position(self->Buffer, read, advance, DSBCB_SETPOSITION_NONE))) {
-
-            self->Play = dwFlags;
-            self->Priority = dwPriority;
-
-            self->Status = DSBSTATUS_PLAYING;
+            DWORD status = DSBSTATUS_PLAYING;
 
             if (dwFlags & DSBPLAY_LOOPING) {
-                self->Status = self->Status | DSBSTATUS_LOOPING;
+                status = status | DSBSTATUS_LOOPING;
             }
 
             if (self->Caps.dwFlags & DSBCAPS_LOCDEFER) {
-                self->Status = self->Status | DSBSTATUS_LOCSOFTWARE;
+                status = status | DSBSTATUS_LOCSOFTWARE;
             }
+
+            self->Priority = dwPriority;
+
+            hr = dsb_set_status(self, dwFlags, status);
         }
     }
 
@@ -643,8 +684,7 @@ HRESULT DELTACALL dsb_set_current_position(dsb* self, DWORD dwNewPosition) {
         return DSERR_INVALIDCALL;
     }
     else if (self->Instance->Level == DSSCL_WRITEPRIMARY) {
-        self->Play = DSBPLAY_NONE;
-        self->Status = DSBSTATUS_BUFFERLOST;
+        dsb_set_status(self, DSBPLAY_NONE, DSBSTATUS_BUFFERLOST);
 
         return DSERR_BUFFERLOST;
     }
@@ -653,7 +693,7 @@ HRESULT DELTACALL dsb_set_current_position(dsb* self, DWORD dwNewPosition) {
         return E_INVALIDARG;
     }
 
-    const DWORD write = (self->Status & DSBSTATUS_PLAYING)
+    const DWORD write = (self->State.Status & DSBSTATUS_PLAYING)
         ? min(self->Caps.dwBufferBytes, ADVANCEWRITEPOSITION(dwNewPosition, self->Format->nBlockAlign))
         : dwNewPosition;
 
@@ -693,7 +733,7 @@ HRESULT DELTACALL dsb_set_format(dsb* self, LPCWAVEFORMATEX pcfxFormat) {
 
     self->Format->cbSize = 0;
 
-    return S_OK;
+    return dsb_bind_voice(self);
 
     // TODO
     // DirectSound recognizes the WAVE_FORMAT_EXTENSIBLE format tag
@@ -711,9 +751,11 @@ HRESULT DELTACALL dsb_set_volume(dsb* self, FLOAT fVolume) {
         return DSERR_CONTROLUNAVAIL;
     }
 
-    self->Volume = fVolume;
+    dsb_lock_state(self);
 
-    return S_OK;
+    self->State.Volume = fVolume;
+
+    return dsb_unlock_state(self);
 }
 
 HRESULT DELTACALL dsb_set_pan(dsb* self, FLOAT fPan) {
@@ -725,9 +767,11 @@ HRESULT DELTACALL dsb_set_pan(dsb* self, FLOAT fPan) {
         return DSERR_CONTROLUNAVAIL;
     }
 
-    self->Pan = fPan;
+    dsb_lock_state(self);
 
-    return S_OK;
+    self->State.Pan = fPan;
+
+    return dsb_unlock_state(self);
 }
 
 HRESULT DELTACALL dsb_set_frequency(dsb* self, DWORD dwFrequency) {
@@ -739,9 +783,14 @@ HRESULT DELTACALL dsb_set_frequency(dsb* self, DWORD dwFrequency) {
         return DSERR_CONTROLUNAVAIL;
     }
 
-    self->Frequency = dwFrequency;
+    // The render thread must never see the new frequency with the kernel of the old one.
+    dsb_lock_state(self);
 
-    return S_OK;
+    self->State.Frequency = dwFrequency;
+
+    dsb_select_voice(self);
+
+    return dsb_unlock_state(self);
 }
 
 HRESULT DELTACALL dsb_stop(dsb* self) {
@@ -751,23 +800,21 @@ HRESULT DELTACALL dsb_stop(dsb* self) {
 
     if (!(self->Caps.dwFlags & DSBCAPS_PRIMARYBUFFER)) {
         if (self->Instance->Level == DSSCL_WRITEPRIMARY) {
-            self->Play = DSBPLAY_NONE;
-            self->Status = DSBSTATUS_BUFFERLOST;
+            dsb_set_status(self, DSBPLAY_NONE, DSBSTATUS_BUFFERLOST);
 
             return DSERR_BUFFERLOST;
         }
     }
 
-    if (self->Status & DSBSTATUS_BUFFERLOST) {
+    if (self->State.Status & DSBSTATUS_BUFFERLOST) {
         return DSERR_BUFFERLOST;
     }
 
     HRESULT hr = S_OK;
 
-    if (self->Status & DSBSTATUS_PLAYING) {
+    if (self->State.Status & DSBSTATUS_PLAYING) {
 
-        self->Play = DSBPLAY_NONE;
-        self->Status = DSBSTATUS_NONE;
+        dsb_set_status(self, DSBPLAY_NONE, DSBSTATUS_NONE);
 
         if (self->Caps.dwFlags & DSBCAPS_PRIMARYBUFFER) {
             if (self->Instance->Level == DSSCL_WRITEPRIMARY) {
@@ -775,7 +822,7 @@ HRESULT DELTACALL dsb_stop(dsb* self) {
             }
         }
         else if (self->Caps.dwFlags & DSBCAPS_CTRLPOSITIONNOTIFY) {
-            hr = dsb_trigger_notifications(self, self->Caps.dwBufferBytes, 0);
+            hr = dsb_trigger_notifications(self, DSBSTATUS_NONE, self->Caps.dwBufferBytes, 0);
         }
     }
 
@@ -794,8 +841,7 @@ HRESULT DELTACALL dsb_unlock(dsb* self,
         }
     }
     else if (self->Instance->Level == DSSCL_WRITEPRIMARY) {
-        self->Play = DSBPLAY_NONE;
-        self->Status = DSBSTATUS_BUFFERLOST;
+        dsb_set_status(self, DSBPLAY_NONE, DSBSTATUS_BUFFERLOST);
 
         return DSERR_BUFFERLOST;
     }
@@ -812,60 +858,151 @@ HRESULT DELTACALL dsb_unlock(dsb* self,
         return E_INVALIDARG;
     }
 
-    return dsbcb_unlock(self->Buffer, pvAudioPtr1, pvAudioPtr2);
+    HRESULT hr = S_OK;
+
+    // The cache is updated while the buffer is still locked, so that compaction cannot release it meanwhile.
+    if (self->HalfCache) {
+        if (SUCCEEDED(hr = dsb_update_cache(self, pvAudioPtr1, dwAudioBytes1))) {
+            hr = dsb_update_cache(self, pvAudioPtr2, dwAudioBytes2);
+        }
+    }
+
+    if (SUCCEEDED(hr)) {
+        hr = dsbcb_unlock(self->Buffer, pvAudioPtr1, pvAudioPtr2);
+    }
+
+    return hr;
 }
 
 HRESULT DELTACALL dsb_restore(dsb* self) {
     if (!(self->Caps.dwFlags & DSBCAPS_PRIMARYBUFFER)) {
         if (self->Instance->Level == DSSCL_WRITEPRIMARY) {
-            self->Play = DSBPLAY_NONE;
-            self->Status = DSBSTATUS_BUFFERLOST;
+            dsb_set_status(self, DSBPLAY_NONE, DSBSTATUS_BUFFERLOST);
 
             return DSERR_BUFFERLOST;
         }
     }
 
-    self->Status = DSBSTATUS_NONE;
+    dsb_set_status(self, DSBPLAY_NONE, DSBSTATUS_NONE);
 
     return dsbcb_set_current_position(self->Buffer, 0, 0, DSBCB_SETPOSITION_NONE);
 }
 
-HRESULT DELTACALL dsb_update_current_position(dsb* self, DWORD dwAdvance) {
+HRESULT DELTACALL dsb_compact(dsb* self, LPDWORD pdwBytes) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (pdwBytes == NULL) {
+        return E_INVALIDARG;
+    }
+
+    *pdwBytes = 0;
+
+    if (!self->HalfCache) {
+        return S_FALSE;
+    }
+
+    HRESULT hr = S_FALSE;
+
+    EnterCriticalSection(&self->Lock);
+
+    // The state lock keeps the buffer from being played while its cache is released.
+    dsb_lock_state(self);
+
+    if (!(self->State.Status & DSBSTATUS_PLAYING)) {
+        // The render thread reads the cache until it applies the stop.
+        if (self->Instance->Device != NULL) {
+            dscq_flush(self->Instance->Device->Commands);
+        }
+
+        if ((hr = dsbcb_release_cache(self->Buffer, pdwBytes)) == S_OK) {
+            self->HalfCache = FALSE;
+
+            dsb_select_voice(self);
+        }
+    }
+
+    dsb_unlock_state(self);
+
+    LeaveCriticalSection(&self->Lock);
+
+    return hr;
+}
+
+HRESULT DELTACALL dsb_update_current_position(dsb* self, dsvt* pVoices, DWORD dwAdvance, FLOAT fPhase) {
     if (self == NULL) {
         return E_POINTER;
     }
 
+    if (pVoices == NULL || pVoices->Count <= self->ActiveIndex) {
+        return E_INVALIDARG;
+    }
+
     HRESULT hr = S_OK;
     DWORD read = 0, write = 0;
 
+    const DWORD index = self->ActiveIndex;
+    const DWORD status = pVoices->Status[index];
+    const BOOL notify = pVoices->Flags[index] & DSVT_VOICE_NOTIFY;
+
+    // The render thread never waits for the API threads. When the cursors or the state
+    // are changed concurrently, the API change wins and the update is dropped for this period.
     if (SUCCEEDED(hr = dsbcb_get_current_position(self->Buffer, &read, &write))) {
-        if (self->Status & DSBSTATUS_LOOPING) {
-            if (SUCCEEDED(hr = dsbcb_set_current_position(self->Buffer,
-                read + dwAdvance, write + dwAdvance, DSBCB_SETPOSITION_LOOPING))) {
-                if (self->Caps.dwFlags & DSBCAPS_CTRLPOSITIONNOTIFY) {
-                    hr = dsb_trigger_notifications(self, read, dwAdvance);
+        if (status & DSBSTATUS_LOOPING) {
+            if ((hr = dsbcb_advance_current_position(self->Buffer, read, write,
+                read + dwAdvance, write + dwAdvance, DSBCB_SETPOSITION_LOOPING)) == S_OK) {
+                pVoices->Phases[index] = fPhase;
+
+                if (notify) {
+                    dsb_trigger_notifications(self, status, read, dwAdvance);
                 }
             }
         }
         else {
-            if (self->Caps.dwBufferBytes < read + dwAdvance) {
-                self->Play = DSBPLAY_NONE;
-                self->Status = DSBSTATUS_NONE;
+            const DWORD length = pVoices->Lengths[index];
+
+            if (length <= read + dwAdvance) {
+                if ((hr = dsb_try_lock_state(self, pVoices->Sequences[index])) != S_OK) {
+                    // The tail is already mixed, so the cursor still reaches the end and only the stop
+                    // is retried next period. The stop notification waits for the status to change.
+                    if (read < length && (hr = dsbcb_advance_current_position(self->Buffer,
+                        read, write, length, min(write + dwAdvance, length), DSBCB_SETPOSITION_NONE)) == S_OK) {
+                        pVoices->Phases[index] = fPhase;
+
+                        if (notify) {
+                            dsb_trigger_notifications(self, DSBSTATUS_NONE, read, length - read - 1);
+                        }
+                    }
+
+                    return hr;
+                }
+
+                self->State.Play = DSBPLAY_NONE;
+                self->State.Status = DSBSTATUS_NONE;
 
-                if (SUCCEEDED(hr = dsbcb_set_current_position(self->Buffer, 0, 0, DSBCB_SETPOSITION_NONE))) {
-                    if (self->Caps.dwFlags & DSBCAPS_CTRLPOSITIONNOTIFY) {
-                        hr = dsb_trigger_notifications(self, read, dwAdvance);
+                dsb_unlock_state(self);
+
+                // The voice leaves the table, so nothing of its row is used past this point.
+                dsb_set_render_status(self, DSBPLAY_NONE, DSBSTATUS_NONE);
+
+                if ((hr = dsbcb_advance_current_position(self->Buffer,
+                    read, write, 0, 0, DSBCB_SETPOSITION_NONE)) == S_OK) {
+                    if (notify) {
+                        dsb_trigger_notifications(self, DSBSTATUS_NONE, read, dwAdvance);
                     }
                 }
             }
             else {
-                const DWORD rad = min(read + dwAdvance, self->Caps.dwBufferBytes);
-                const DWORD wad = min(write + dwAdvance, self->Caps.dwBufferBytes);
+                const DWORD rad = min(read + dwAdvance, length);
+                const DWORD wad = min(write + dwAdvance, length);
 
-                if (SUCCEEDED(hr = dsbcb_set_current_position(self->Buffer,
-                    rad, wad, DSBCB_SETPOSITION_NONE))) {
-                    if (self->Caps.dwFlags & DSBCAPS_CTRLPOSITIONNOTIFY) {
-                        hr = dsb_trigger_notifications(self, read, dwAdvance);
+                if ((hr = dsbcb_advance_current_position(self->Buffer,
+                    read, write, rad, wad, DSBCB_SETPOSITION_NONE)) == S_OK) {
+                    pVoices->Phases[index] = fPhase;
+
+                    if (notify) {
+                        dsb_trigger_notifications(self, DSBSTATUS_NONE, read, dwAdvance);
                     }
                 }
             }
@@ -875,9 +1012,324 @@ HRESULT DELTACALL dsb_update_current_position(dsb* self, DWORD dwAdvance) {
     return hr;
 }
 
+HRESULT DELTACALL dsb_get_state(dsb* self, dsbs* pState) {
+    if (self == NULL || pState == NULL) {
+        return E_POINTER;
+    }
+
+    LONG sequence = 0;
+
+    while (dsb_read_state(self, pState, &sequence) != S_OK) {
+        SwitchToThread();
+    }
+
+    return S_OK;
+}
+
+HRESULT DELTACALL dsb_refresh_voice(dsb* self, dsvt* pVoices) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (pVoices == NULL || pVoices->Count <= self->ActiveIndex) {
+        return E_INVALIDARG;
+    }
+
+    const DWORD index = self->ActiveIndex;
+
+    // The row is rebuilt only when the API threads changed the state since it was last read.
+    if (self->Sequence == pVoices->Sequences[index]) {
+        return S_OK;
+    }
+
+    // A writer holds the sequence odd only for a few stores. When it is preempted there,
+    // the render thread keeps mixing with the last consistent state instead of waiting.
+    for (DWORD i = 0; i < DSB_RENDER_STATE_ATTEMPT_COUNT; i++) {
+        LONG sequence = 0;
+        dsbs state;
+
+        if (dsb_read_state(self, &state, &sequence) == S_OK) {
+            // Play and status are owned by the render thread, they change only through the commands.
+            DWORD flags = DSVT_VOICE_NONE;
+
+            if (self->Caps.dwFlags & DSBCAPS_PRIMARYBUFFER) {
+                flags |= DSVT_VOICE_PRIMARY;
+            }
+
+            if (self->Caps.dwFlags & DSBCAPS_CTRLPOSITIONNOTIFY) {
+                flags |= DSVT_VOICE_NOTIFY;
+            }
+
+            if (self->HalfCache) {
+                flags |= DSVT_VOICE_CACHE;
+            }
+
+            pVoices->Flags[index] = flags;
+            pVoices->Alignments[index] = self->Format->nBlockAlign;
+            pVoices->Lengths[index] = self->Caps.dwBufferBytes;
+            pVoices->Channels[index] = self->Format->nChannels;
+            pVoices->Frequencies[index] = state.Frequency == DSBFREQUENCY_ORIGINAL
+                ? self->Format->nSamplesPerSec : state.Frequency;
+            pVoices->Voices[index] = state.Voice;
+
+            if (FAILED(dsvt_set_gains(pVoices, index, state.Volume, state.Pan))) {
+                dsvt_set_gains(pVoices, index, DSB_MIN_VOLUME, DSB_CENTER_PAN);
+            }
+
+            pVoices->Sequences[index] = sequence;
+
+            return S_OK;
+        }
+
+        YieldProcessor();
+    }
+
+    return S_FALSE;
+}
+
+HRESULT DELTACALL dsb_rebind_voice(dsb* self) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    const LONG sequence = self->Sequence;
+
+    if ((sequence & 1) || dsb_try_lock_state(self, sequence) != S_OK) {
+        return S_FALSE;
+    }
+
+    dsb_select_voice(self);
+
+    return dsb_unlock_state(self);
+}
+
+HRESULT DELTACALL dsb_lock_state(dsb* self) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    for (;;) {
+        const LONG sequence = self->Sequence;
+
+        if (!(sequence & 1) && dsb_try_lock_state(self, sequence) == S_OK) {
+            return S_OK;
+        }
+
+        YieldProcessor();
+    }
+}
+
+HRESULT DELTACALL dsb_unlock_state(dsb* self) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    InterlockedIncrement(&self->Sequence);
+
+    return S_OK;
+}
+
+HRESULT DELTACALL dsb_set_status(dsb* self, DWORD dwPlay, DWORD dwStatus) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    HRESULT hr = S_OK;
+
+    dsb_lock_state(self);
+
+    self->State.Play = dwPlay;
+    self->State.Status = dwStatus;
+
+    // The endpoint may have reopened at another frequency since the kernel was selected.
+    if (dwStatus & DSBSTATUS_PLAYING) {
+        dsb_select_voice(self);
+    }
+
+    // The command is posted under the state lock, so the render thread applies the changes in the same order.
+    if (self->Instance != NULL && self->Instance->Device != NULL) {
+        const dscmd command = { DSCQ_COMMAND_STATUS, self, dwPlay, dwStatus };
+
+        hr = dsdevice_post(self->Instance->Device, &command);
+    }
+
+    dsb_unlock_state(self);
+
+    return hr;
+}
+
+HRESULT DELTACALL dsb_set_render_status(dsb* self, DWORD dwPlay, DWORD dwStatus) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    dsdevice* device = self->Instance->Device;
+
+    if (!(dwStatus & DSBSTATUS_PLAYING)) {
+        return dsdevice_deactivate_buffer(device, self);
+    }
+
+    HRESULT hr = S_OK;
+
+    if (SUCCEEDED(hr = dsdevice_activate_buffer(device, self))) {
+        device->Voices->Play[self->ActiveIndex] = dwPlay;
+        device->Voices->Status[self->ActiveIndex] = dwStatus;
+    }
+
+    return hr;
+}
+
 /* ---------------------------------------------------------------------- */
 
-HRESULT DELTACALL dsb_trigger_notifications(dsb* self, DWORD dwPosition, DWORD dwAdvance) {
+HRESULT DELTACALL dsb_read_state(dsb* self, dsbs* pState, LPLONG plSequence) {
+    if (self == NULL || pState == NULL || plSequence == NULL) {
+        return E_POINTER;
+    }
+
+    const LONG sequence = self->Sequence;
+
+    if (sequence & 1) {
+        return S_FALSE;
+    }
+
+    MemoryBarrier();
+
+    CopyMemory(pState, &self->State, sizeof(dsbs));
+
+    MemoryBarrier();
+
+    if (self->Sequence != sequence) {
+        return S_FALSE;
+    }
+
+    *plSequence = sequence;
+
+    return S_OK;
+}
+
+HRESULT DELTACALL dsb_try_lock_state(dsb* self, LONG lSequence) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    return InterlockedCompareExchange(&self->Sequence, lSequence + 1, lSequence) == lSequence
+        ? S_OK : S_FALSE;
+}
+
+HRESULT DELTACALL dsb_bind_voice(dsb* self) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    dsb_lock_state(self);
+
+    dsb_select_voice(self);
+
+    return dsb_unlock_state(self);
+}
+
+HRESULT DELTACALL dsb_select_voice(dsb* self) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    dsdevice* device = self->Instance->Device;
+
+    const DWORD rate = device == NULL ? 0 : (DWORD)device->Frequency;
+
+    if (rate == 0) {
+        self->State.Voice = NULL;
+        return S_OK;
+    }
+
+    const DWORD frequency = self->State.Frequency == DSBFREQUENCY_ORIGINAL
+        ? self->Format->nSamplesPerSec : self->State.Frequency;
+
+    // Formats without a kernel are still accepted, the mixer reports them when they are played.
+    DWORD format = 0;
+    LPKERNELVOICE voice = NULL;
+
+    if (SUCCEEDED(self->HalfCache
+        ? kernel_get_half_format(self->Format, &format) : kernel_get_format(self->Format, &format))) {
+        kernel_get_voice(&self->Instance->Instance->Kernel,
+            format, frequency, rate, &voice);
+    }
+
+    self->State.Voice = voice;
+
+    return S_OK;
+}
+
+HRESULT DELTACALL dsb_reserve_voice(dsb* self) {
+    if (self->Instance->Device == NULL) {
+        return S_OK;
+    }
+
+    HRESULT hr = S_OK;
+
+    EnterCriticalSection(&self->Lock);
+
+    if (!self->Reserved) {
+        if (SUCCEEDED(hr = dsdevice_reserve_voice(self->Instance->Device))) {
+            self->Reserved = TRUE;
+        }
+    }
+
+    LeaveCriticalSection(&self->Lock);
+
+    return hr;
+}
+
+HRESULT DELTACALL dsb_create_cache(dsb* self) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    // Static buffers are converted once when they are unlocked, instead of on every render period.
+    if (!(self->Caps.dwFlags & DSBCAPS_STATIC) || !self->Instance->Instance->Config.HalfCache) {
+        return S_OK;
+    }
+
+    DWORD format = 0;
+
+    if (FAILED(kernel_get_format(self->Format, &format))) {
+        return S_OK;
+    }
+
+    HRESULT hr = S_OK;
+
+    if (SUCCEEDED(hr = dsbcb_create_cache(self->Buffer, self->Format->wBitsPerSample >> 3))) {
+        self->HalfCache = TRUE;
+    }
+
+    return hr;
+}
+
+HRESULT DELTACALL dsb_update_cache(dsb* self, LPVOID pvAudioPtr, DWORD dwAudioBytes) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (pvAudioPtr == NULL || dwAudioBytes == 0) {
+        return S_OK;
+    }
+
+    HRESULT hr = S_OK;
+    LPKERNELENCODE encode = NULL;
+
+    if (SUCCEEDED(hr = kernel_get_encoder(&self->Instance->Instance->Kernel, self->Format, &encode))) {
+        LPVOID cache = NULL;
+        DWORD available = 0;
+
+        if ((hr = dsbcb_get_cache(self->Buffer, pvAudioPtr, &cache, &available)) == S_OK) {
+            encode(pvAudioPtr, min(dwAudioBytes, available) / (self->Format->wBitsPerSample >> 3), cache);
+        }
+    }
+
+    return hr;
+}
+
+HRESULT DELTACALL dsb_trigger_notifications(dsb* self, DWORD dwStatus, DWORD dwPosition, DWORD dwAdvance) {
     if (self == NULL) {
         return E_POINTER;
     }
@@ -898,7 +1350,7 @@ HRESULT DELTACALL dsb_trigger_notifications(dsb* self, DWORD dwPosition, DWORD d
 
         if (SUCCEEDED(hr = dsn_get_notification_positions(self->Notifications, &count, &notes))) {
             if (count != 0) {
-                if (self->Status & DSBSTATUS_LOOPING) {
+                if (dwStatus & DSBSTATUS_LOOPING) {
                     DWORD length = self->Caps.dwBufferBytes < dwPosition + dwAdvance
                         ? self->Caps.dwBufferBytes - dwPosition : dwAdvance;
                     DWORD pending = dwAdvance - length;
@@ -25,8 +25,10 @@ SOFTWARE.
 #pragma once
 
 #include "dsbcb.h"
+#include "dsvt.h"
 #include "idsb.h"
 #include "intfc.h"
+#include "kernel.h"
 
 #define DSBPLAY_NONE    0
 #define DSBSTATUS_NONE  0
@@ -40,13 +42,33 @@ SOFTWARE.
 
 #define DSB_DEFAULT_PRIMARY_BUFFER_SIZE     32768
 
+#define DSB_INACTIVE_INDEX  ((DWORD)-1)
+
 typedef struct ds ds;
 typedef struct ksp ksp;
 typedef struct dsn dsn;
 typedef struct dssl dssl;
 typedef struct dssb dssb;
 
+typedef struct dsbs {
+    DWORD               Frequency;
+    FLOAT               Pan;
+    FLOAT               Volume;
+    DWORD               Play;
+    DWORD               Status;
+    LPKERNELVOICE       Voice;
+} dsbs;
+
+// The fields the render thread reads share the first cache line, apart from the bookkeeping of the API threads.
 typedef struct dsb {
+    DECLSPEC_ALIGN(ALLOCATOR_CACHE_LINE_SIZE)
+    volatile LONG       Sequence;
+    DWORD               ActiveIndex;    // In the device voice table, owned by the render thread
+    dsbcb*              Buffer;
+    LPWAVEFORMATEX      Format;
+    dsbs                State;
+
+    DECLSPEC_ALIGN(ALLOCATOR_CACHE_LINE_SIZE)
     allocator*          Allocator;
     IID                 ID;
     ds*                 Instance;
@@ -59,17 +81,13 @@ typedef struct dsb {
     CRITICAL_SECTION    Lock;
 
     DSBCAPS             Caps;
-    dsbcb*              Buffer;
-
-    LPWAVEFORMATEX      Format;
 
-    DWORD               Frequency;
-    FLOAT               Pan;
-    FLOAT               Volume;
     DWORD               Priority;
 
-    DWORD               Play;
-    DWORD               Status;
+    DWORD64             Handle;         // In the secondary buffer registry
+
+    BOOL                HalfCache;
+    BOOL                Reserved;       // A row of the device voice table, claimed when first played
 
     GUID                SpatialAlgorithm;
 } dsb;
@@ -106,4 +124,18 @@ HRESULT DELTACALL dsb_stop(dsb* pDSB);
 HRESULT DELTACALL dsb_unlock(dsb* self, LPVOID pvAudioPtr1, DWORD dwAudioBytes1, LPVOID pvAudioPtr2, DWORD dwAudioBytes2);
 HRESULT DELTACALL dsb_restore(dsb* pDSB);
 
-HRESULT DELTACALL dsb_update_current_position(dsb* pDSB, DWORD dwAdvance);
+HRESULT DELTACALL dsb_compact(dsb* pDSB, LPDWORD pdwBytes);
+
+HRESULT DELTACALL dsb_get_state(dsb* pDSB, dsbs* pState);
+HRESULT DELTACALL dsb_refresh_voice(dsb* pDSB, dsvt* pVoices);
+// Selects the kernel again on the render thread, after the endpoint reopened at another frequency.
+// Returns S_FALSE without waiting when an API thread holds the state, the rebind is then retried.
+HRESULT DELTACALL dsb_rebind_voice(dsb* pDSB);
+HRESULT DELTACALL dsb_lock_state(dsb* pDSB);
+HRESULT DELTACALL dsb_unlock_state(dsb* pDSB);
+HRESULT DELTACALL dsb_set_status(dsb* pDSB, DWORD dwPlay, DWORD dwStatus);
+HRESULT DELTACALL dsb_set_render_status(dsb* pDSB, DWORD dwPlay, DWORD dwStatus);
+
+// Moves the position of the playing buffer by the frames mixed in the period, and stores the phase
+// of the resampler that goes with it. The update is dropped, returning S_FALSE, when an API thread changed the buffer.
+HRESULT DELTACALL dsb_update_current_position(dsb* pDSB, dsvt* pVoices, DWORD dwAdvance, FLOAT fPhase);
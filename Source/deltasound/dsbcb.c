@@ -26,19 +26,35 @@ SOFTWARE.
 #include "dsbcblc.h"
 #include "rcm.h"
 
+// The cache holds a single IEEE half precision value per sample.
+#define DSBCB_CACHE_SAMPLE_BYTES    2
+
+#define CACHEBYTES(X, SAMPLE) ((X) / (SAMPLE) * DSBCB_CACHE_SAMPLE_BYTES)
+
+// Both cursors are packed into a single value, so the render thread
+// observes and advances them atomically without taking the lock.
+#define POSITION(READ, WRITE)   ((LONG64)(((ULONG64)(READ) << 32) | (DWORD)(WRITE)))
+#define READPOSITION(X)         ((DWORD)((ULONG64)(X) >> 32))
+#define WRITEPOSITION(X)        ((DWORD)(X))
+
 typedef struct dsbcb {
     allocator*          Allocator;
     CRITICAL_SECTION    Lock;
 
     rcm*                Buffer;
+    rcm*                Cache;
+    DWORD               SampleBytes;
 
-    DWORD               ReadPosition;
-    DWORD               WritePosition;
+    volatile LONG64     Position;
 
     dsbcblc*            Locks;
 } dsbcb;
 
+HRESULT DELTACALL dsbcb_get_position(dsbcb* pBuffer, LONG64* pllPosition);
+HRESULT DELTACALL dsbcb_make_position(dsbcb* pBuffer,
+    DWORD dwReadBytes, DWORD dwWriteBytes, DWORD dwFlags, LONG64* pllPosition);
 HRESULT DELTACALL dsbcb_locks_overlap(DWORD dwStart1, DWORD dwEnd1, DWORD dwStart2, DWORD dwEnd2);
+HRESULT DELTACALL dsbcb_commit(dsbcb* pBuffer, DWORD dwOffset, DWORD dwBytes);
 
 HRESULT DELTACALL dsbcb_create(allocator* pAlloc, DWORD dwBytes, dsbcb** ppOut) {
     if (pAlloc == NULL || ppOut == NULL) {
@@ -78,6 +94,10 @@ VOID DELTACALL dsbcb_release(dsbcb* self) {
 
     rcm_remove_ref(self->Buffer);
 
+    if (self->Cache != NULL) {
+        rcm_remove_ref(self->Cache);
+    }
+
     allocator_free(self->Allocator, self);
 }
 
@@ -102,6 +122,12 @@ HRESULT DELTACALL dsbcb_duplicate(dsbcb* self, dsbcb** ppOut) {
             instance->Buffer = self->Buffer;
             rcm_add_ref(instance->Buffer);
 
+            if (self->Cache != NULL) {
+                instance->Cache = self->Cache;
+                instance->SampleBytes = self->SampleBytes;
+                rcm_add_ref(instance->Cache);
+            }
+
             *ppOut = instance;
 
             return S_OK;
@@ -113,6 +139,109 @@ HRESULT DELTACALL dsbcb_duplicate(dsbcb* self, dsbcb** ppOut) {
     return hr;
 }
 
+HRESULT DELTACALL dsbcb_create_cache(dsbcb* self, DWORD dwSampleBytes) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (dwSampleBytes == 0) {
+        return E_INVALIDARG;
+    }
+
+    if (self->Cache != NULL) {
+        return E_FAIL;
+    }
+
+    HRESULT hr = S_OK;
+    DWORD length = 0;
+
+    if (SUCCEEDED(hr = rcm_get_length(self->Buffer, &length))) {
+        if (SUCCEEDED(hr = rcm_create(self->Allocator,
+            CACHEBYTES(length, dwSampleBytes), &self->Cache))) {
+            self->SampleBytes = dwSampleBytes;
+        }
+    }
+
+    return hr;
+}
+
+HRESULT DELTACALL dsbcb_get_cache(dsbcb* self, LPCVOID pvAudioPtr, LPVOID* ppCache, LPDWORD pdwBytes) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (pvAudioPtr == NULL || ppCache == NULL || pdwBytes == NULL) {
+        return E_INVALIDARG;
+    }
+
+    // The cache may have been released by compaction.
+    if (self->Cache == NULL) {
+        *ppCache = NULL;
+        *pdwBytes = 0;
+
+        return S_FALSE;
+    }
+
+    HRESULT hr = S_OK;
+    DWORD length = 0;
+    LPVOID buffer = NULL;
+    LPVOID cache = NULL;
+
+    if (FAILED(hr = rcm_get_length(self->Buffer, &length))) {
+        return hr;
+    }
+
+    if (SUCCEEDED(hr = rcm_get_data(self->Buffer, &buffer))) {
+        if (SUCCEEDED(hr = rcm_get_data(self->Cache, &cache))) {
+            if ((size_t)pvAudioPtr < (size_t)buffer || (size_t)buffer + length <= (size_t)pvAudioPtr) {
+                return E_INVALIDARG;
+            }
+
+            const DWORD offset = (DWORD)((size_t)pvAudioPtr - (size_t)buffer);
+
+            *ppCache = (LPVOID)((size_t)cache + CACHEBYTES(offset, self->SampleBytes));
+            *pdwBytes = length - offset;
+        }
+    }
+
+    return hr;
+}
+
+HRESULT DELTACALL dsbcb_release_cache(dsbcb* self, LPDWORD pdwBytes) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    HRESULT hr = S_FALSE;
+    DWORD bytes = 0;
+
+    EnterCriticalSection(&self->Lock);
+
+    // The cache is written while the buffer is locked, so it is kept until all the locks are released.
+    // The duplicates read the samples from the shared cache, and each of them writes through its own
+    // reference, so the cache is kept as long as any duplicate shares it.
+    DWORD references = 0;
+
+    if (self->Cache != NULL && dsbcblc_get_count(self->Locks) == 0
+        && SUCCEEDED(rcm_get_references(self->Cache, &references)) && references == 1) {
+        rcm_get_length(self->Cache, &bytes);
+
+        rcm_remove_ref(self->Cache);
+
+        self->Cache = NULL;
+
+        hr = S_OK;
+    }
+
+    LeaveCriticalSection(&self->Lock);
+
+    if (pdwBytes != NULL) {
+        *pdwBytes = bytes;
+    }
+
+    return hr;
+}
+
 HRESULT DELTACALL dsbcb_get_current_position(dsbcb* self,
     LPDWORD pdwReadBytes, LPDWORD pdwWriteBytes) {
     if (self == NULL) {
@@ -123,12 +252,16 @@ HRESULT DELTACALL dsbcb_get_current_position(dsbcb* self,
         return E_INVALIDARG;
     }
 
+    LONG64 position = 0;
+
+    dsbcb_get_position(self, &position);
+
     if (pdwReadBytes != NULL) {
-        *pdwReadBytes = self->ReadPosition;
+        *pdwReadBytes = READPOSITION(position);
     }
 
     if (pdwWriteBytes != NULL) {
-        *pdwWriteBytes = self->WritePosition;
+        *pdwWriteBytes = WRITEPOSITION(position);
     }
 
     return S_OK;
@@ -141,20 +274,30 @@ HRESULT DELTACALL dsbcb_set_current_position(dsbcb* self,
     }
 
     HRESULT hr = S_OK;
-    DWORD size = 0;
+    LONG64 position = 0;
 
-    if (SUCCEEDED(hr = rcm_get_length(self->Buffer, &size))) {
-        if (dwFlags & DSBCB_SETPOSITION_LOOPING) {
-            dwReadBytes = dwReadBytes % size;
-            dwWriteBytes = dwWriteBytes % size;
-        }
+    if (SUCCEEDED(hr = dsbcb_make_position(self, dwReadBytes, dwWriteBytes, dwFlags, &position))) {
+        InterlockedExchange64(&self->Position, position);
+    }
 
-        if (size < dwReadBytes || size < dwWriteBytes) {
-            return E_INVALIDARG;
-        }
+    return hr;
+}
+
+HRESULT DELTACALL dsbcb_advance_current_position(dsbcb* self,
+    DWORD dwReadBytes, DWORD dwWriteBytes, DWORD dwNewReadBytes, DWORD dwNewWriteBytes, DWORD dwFlags) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    HRESULT hr = S_OK;
+    LONG64 position = 0;
 
-        self->ReadPosition = dwReadBytes;
-        self->WritePosition = dwWriteBytes;
+    if (SUCCEEDED(hr = dsbcb_make_position(self, dwNewReadBytes, dwNewWriteBytes, dwFlags, &position))) {
+        const LONG64 expected = POSITION(dwReadBytes, dwWriteBytes);
+
+        if (InterlockedCompareExchange64(&self->Position, position, expected) != expected) {
+            return S_FALSE;
+        }
     }
 
     return hr;
@@ -183,11 +326,17 @@ HRESULT DELTACALL dsbcb_get_lockable_length(dsbcb* self, LPDWORD pdwBytes) {
 
     HRESULT hr = S_OK;
     DWORD size = 0;
+    LONG64 position = 0;
 
     if (SUCCEEDED(hr = rcm_get_length(self->Buffer, &size))) {
-        *pdwBytes = self->ReadPosition < self->WritePosition
-            ? size + self->ReadPosition - self->WritePosition
-            : size - self->ReadPosition + self->WritePosition;
+        dsbcb_get_position(self, &position);
+
+        const DWORD read = READPOSITION(position);
+        const DWORD write = WRITEPOSITION(position);
+
+        *pdwBytes = read < write
+            ? size + read - write
+            : size - read + write;
     }
 
     return hr;
@@ -229,6 +378,12 @@ HRESULT DELTACALL dsbcb_lock(dsbcb* self, DWORD dwOffset, DWORD dwBytes,
     const DWORD wrapped = size < dwOffset + dwBytes
         ? dwOffset + dwBytes - size : 0;
 
+    // Large buffers are backed by memory only once they are locked for writing.
+    if (FAILED(hr = dsbcb_commit(self, dwOffset, dwBytes - wrapped))
+        || FAILED(hr = dsbcb_commit(self, 0, wrapped))) {
+        return hr;
+    }
+
     dsbcbl lock;
     ZeroMemory(&lock, sizeof(dsbcbl));
 
@@ -331,45 +486,95 @@ HRESULT DELTACALL dsbcb_read(dsbcb* self, DWORD dwBytes, LPVOID pData, LPDWORD p
         return hr;
     }
 
+    LONG64 current = 0;
+
+    dsbcb_get_position(self, &current);
+
+    const DWORD read = READPOSITION(current);
+
     if (!(dwFlags & DSBCB_READ_LOOPING)) {
-        dwBytes = min(dwBytes, length - self->ReadPosition);
+        dwBytes = min(dwBytes, length - read);
     }
 
-    LPVOID buffer = NULL;
+    // The cache mirrors the buffer, so positions and lengths are scaled to its sample size.
+    const BOOL cache = dwFlags & DSBCB_READ_CACHE;
 
-    EnterCriticalSection(&self->Lock);
+    if (cache && self->Cache == NULL) {
+        return E_INVALIDARG;
+    }
 
-    if (SUCCEEDED(hr = rcm_get_data(self->Buffer, &buffer))) {
-        if (pData != NULL) {
-            DWORD bytes = min(dwBytes, length - self->ReadPosition);
+    rcm* memory = cache ? self->Cache : self->Buffer;
 
-            CopyMemory(pData, (LPVOID)((size_t)buffer + self->ReadPosition), bytes);
+    if (pData != NULL) {
+        const DWORD size = cache ? CACHEBYTES(length, self->SampleBytes) : length;
+        const DWORD position = cache ? CACHEBYTES(read, self->SampleBytes) : read;
+        const DWORD total = cache ? CACHEBYTES(dwBytes, self->SampleBytes) : dwBytes;
 
-            DWORD offset = bytes;
-            DWORD pending = dwBytes - bytes;
+        DWORD bytes = min(total, size - position);
 
-            while (pending != 0) {
-                bytes = min(pending, length);
+        if (FAILED(hr = rcm_read(memory, position, bytes, pData))) {
+            return hr;
+        }
+
+        DWORD offset = bytes;
+        DWORD pending = total - bytes;
 
-                CopyMemory((LPVOID)((size_t)pData + offset), buffer, bytes);
+        while (pending != 0) {
+            bytes = min(pending, size);
 
-                pending -= bytes;
-                offset += bytes;
+            if (FAILED(hr = rcm_read(memory, 0, bytes, (LPVOID)((size_t)pData + offset)))) {
+                return hr;
             }
-        }
 
-        if (pdwBytes != NULL) {
-            *pdwBytes = dwBytes;
+            pending -= bytes;
+            offset += bytes;
         }
     }
 
-    LeaveCriticalSection(&self->Lock);
+    if (pdwBytes != NULL) {
+        *pdwBytes = dwBytes;
+    }
 
     return hr;
 }
 
 /* ---------------------------------------------------------------------- */
 
+HRESULT DELTACALL dsbcb_get_position(dsbcb* self, LONG64* pllPosition) {
+    if (self == NULL || pllPosition == NULL) {
+        return E_POINTER;
+    }
+
+    *pllPosition = InterlockedCompareExchange64(&self->Position, 0, 0);
+
+    return S_OK;
+}
+
+HRESULT DELTACALL dsbcb_make_position(dsbcb* self,
+    DWORD dwReadBytes, DWORD dwWriteBytes, DWORD dwFlags, LONG64* pllPosition) {
+    if (self == NULL || pllPosition == NULL) {
+        return E_POINTER;
+    }
+
+    HRESULT hr = S_OK;
+    DWORD size = 0;
+
+    if (SUCCEEDED(hr = rcm_get_length(self->Buffer, &size))) {
+        if (dwFlags & DSBCB_SETPOSITION_LOOPING) {
+            dwReadBytes = dwReadBytes % size;
+            dwWriteBytes = dwWriteBytes % size;
+        }
+
+        if (size < dwReadBytes || size < dwWriteBytes) {
+            return E_INVALIDARG;
+        }
+
+        *pllPosition = POSITION(dwReadBytes, dwWriteBytes);
+    }
+
+    return hr;
+}
+
 HRESULT DELTACALL dsbcb_locks_overlap(DWORD dwStart1, DWORD dwEnd1, DWORD dwStart2, DWORD dwEnd2) {
     const DWORD l1min = (dwStart1 < dwEnd1) ? dwStart1 : dwEnd1;
     const DWORD l1max = (dwStart1 > dwEnd1) ? dwStart1 : dwEnd1;
@@ -378,3 +583,23 @@ HRESULT DELTACALL dsbcb_locks_overlap(DWORD dwStart1, DWORD dwEnd1, DWORD dwStar
 
     return (l1max <= l2min || l2max <= l1min) ? E_FAIL : S_OK;
 }
+
+HRESULT DELTACALL dsbcb_commit(dsbcb* self, DWORD dwOffset, DWORD dwBytes) {
+    HRESULT hr = S_OK;
+
+    if (FAILED(hr = rcm_commit(self->Buffer, dwOffset, dwBytes))) {
+        return hr;
+    }
+
+    EnterCriticalSection(&self->Lock);
+
+    if (self->Cache != NULL) {
+        const DWORD offset = CACHEBYTES(dwOffset, self->SampleBytes);
+
+        hr = rcm_commit(self->Cache, offset, CACHEBYTES(dwOffset + dwBytes, self->SampleBytes) - offset);
+    }
+
+    LeaveCriticalSection(&self->Lock);
+
+    return hr;
+}
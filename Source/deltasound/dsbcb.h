@@ -28,6 +28,7 @@ SOFTWARE.
 
 #define DSBCB_READ_NONE             0
 #define DSBCB_READ_LOOPING          1
+#define DSBCB_READ_CACHE            2
 
 #define DSBCB_SETPOSITION_NONE      0
 #define DSBCB_SETPOSITION_LOOPING   1
@@ -39,10 +40,16 @@ VOID DELTACALL dsbcb_release(dsbcb* pBuffer);
 
 HRESULT DELTACALL dsbcb_duplicate(dsbcb* pBuffer, dsbcb** ppOut);
 
+HRESULT DELTACALL dsbcb_create_cache(dsbcb* pBuffer, DWORD dwSampleBytes);
+HRESULT DELTACALL dsbcb_get_cache(dsbcb* pBuffer, LPCVOID pvAudioPtr, LPVOID* ppCache, LPDWORD pdwBytes);
+HRESULT DELTACALL dsbcb_release_cache(dsbcb* pBuffer, LPDWORD pdwBytes);
+
 HRESULT DELTACALL dsbcb_get_current_position(dsbcb* pBuffer,
     LPDWORD pdwReadBytes, LPDWORD pdwWriteBytes);
 HRESULT DELTACALL dsbcb_set_current_position(dsbcb* pBuffer,
     DWORD dwReadBytes, DWORD dwWriteBytes, DWORD dwFlags);
+HRESULT DELTACALL dsbcb_advance_current_position(dsbcb* pBuffer,
+    DWORD dwReadBytes, DWORD dwWriteBytes, DWORD dwNewReadBytes, DWORD dwNewWriteBytes, DWORD dwFlags);
 
 HRESULT DELTACALL dsbcb_get_length(dsbcb* pBuffer, LPDWORD pdwBytes);
 HRESULT DELTACALL dsbcb_get_lockable_length(dsbcb* pBuffer, LPDWORD pdwBytes);
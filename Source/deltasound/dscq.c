@@ -0,0 +1,174 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "dscq.h"
+
+// A bounded ring of commands with a single consumer, the render thread.
+// The API threads are serialized by the lock, the render thread never takes it.
+typedef struct dscq {
+    allocator*          Allocator;
+    CRITICAL_SECTION    Lock;
+
+    DWORD               Capacity;
+    volatile LONG       Read;
+    volatile LONG       Write;
+    volatile LONG       Closed;     // The render thread no longer drains the queue
+
+    dscmd*              Commands;
+} dscq;
+
+HRESULT DELTACALL dscq_create(allocator* pAlloc, DWORD dwCapacity, dscq** ppOut) {
+    if (pAlloc == NULL || ppOut == NULL) {
+        return E_INVALIDARG;
+    }
+
+    if (dwCapacity == 0 || (dwCapacity & (dwCapacity - 1)) != 0) {
+        return E_INVALIDARG;
+    }
+
+    HRESULT hr = S_OK;
+    dscq* instance = NULL;
+
+    if (SUCCEEDED(hr = allocator_allocate(pAlloc, sizeof(dscq), &instance))) {
+        instance->Allocator = pAlloc;
+        instance->Capacity = dwCapacity;
+
+        if (SUCCEEDED(hr = allocator_allocate(pAlloc, dwCapacity * sizeof(dscmd), &instance->Commands))) {
+            InitializeCriticalSection(&instance->Lock);
+
+            *ppOut = instance;
+
+            return S_OK;
+        }
+
+        allocator_free(pAlloc, instance);
+    }
+
+    return hr;
+}
+
+VOID DELTACALL dscq_release(dscq* self) {
+    if (self == NULL) { return; }
+
+    DeleteCriticalSection(&self->Lock);
+
+    allocator_free(self->Allocator, self->Commands);
+    allocator_free(self->Allocator, self);
+}
+
+HRESULT DELTACALL dscq_post(dscq* self, const dscmd* pcCommand) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (pcCommand == NULL) {
+        return E_INVALIDARG;
+    }
+
+    EnterCriticalSection(&self->Lock);
+
+    const LONG write = self->Write;
+
+    // Commands are never dropped while the render thread drains the queue every period.
+    while ((DWORD)(write - self->Read) >= self->Capacity && !self->Closed) {
+        SwitchToThread();
+    }
+
+    if (self->Closed) {
+        LeaveCriticalSection(&self->Lock);
+
+        return S_FALSE;
+    }
+
+    CopyMemory(&self->Commands[write & (self->Capacity - 1)], pcCommand, sizeof(dscmd));
+
+    InterlockedExchange(&self->Write, write + 1);
+
+    LeaveCriticalSection(&self->Lock);
+
+    return S_OK;
+}
+
+HRESULT DELTACALL dscq_peek(dscq* self, dscmd* pCommand) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (pCommand == NULL) {
+        return E_INVALIDARG;
+    }
+
+    const LONG read = self->Read;
+
+    if (read == self->Write) {
+        return S_FALSE;
+    }
+
+    MemoryBarrier();
+
+    CopyMemory(pCommand, &self->Commands[read & (self->Capacity - 1)], sizeof(dscmd));
+
+    return S_OK;
+}
+
+HRESULT DELTACALL dscq_pop(dscq* self) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    const LONG read = self->Read;
+
+    if (read == self->Write) {
+        return S_FALSE;
+    }
+
+    // The slot is reused and the flush returns only after the command has been applied.
+    InterlockedExchange(&self->Read, read + 1);
+
+    return S_OK;
+}
+
+HRESULT DELTACALL dscq_flush(dscq* self) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    const LONG write = self->Write;
+
+    while ((LONG)(write - self->Read) > 0) {
+        if (self->Closed) {
+            return S_FALSE;
+        }
+
+        SwitchToThread();
+    }
+
+    return S_OK;
+}
+
+VOID DELTACALL dscq_close(dscq* self) {
+    if (self == NULL) { return; }
+
+    InterlockedExchange(&self->Closed, TRUE);
+}
@@ -0,0 +1,60 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "allocator.h"
+
+#define DSCQ_COMMAND_STATUS     0
+#define DSCQ_COMMAND_COMPACT    1
+#define DSCQ_COMMAND_RESIZE     2
+
+typedef struct dsb dsb;
+
+typedef struct dscmd {
+    DWORD   Type;
+    dsb*    Buffer;
+    DWORD   Play;
+    DWORD   Status;
+    LPVOID  Memory;     // Of the voice table, allocated by the API thread that grows it
+    DWORD   Capacity;
+    LPVOID* Blocks;     // Of the arenas grown with the table, swapped by the render thread for the replaced ones
+} dscmd;
+
+typedef struct dscq dscq;
+
+HRESULT DELTACALL dscq_create(allocator* pAlloc, DWORD dwCapacity, dscq** ppOut);
+VOID DELTACALL dscq_release(dscq* pQueue);
+
+// Returns S_FALSE and drops the command once the queue is closed.
+HRESULT DELTACALL dscq_post(dscq* pQueue, const dscmd* pcCommand);
+// The command stays queued while it is applied, it is removed by dscq_pop once it has been.
+HRESULT DELTACALL dscq_peek(dscq* pQueue, dscmd* pCommand);
+HRESULT DELTACALL dscq_pop(dscq* pQueue);
+
+// Waits until the render thread has applied the commands posted so far, or until it closes the queue.
+HRESULT DELTACALL dscq_flush(dscq* pQueue);
+
+// Called by the render thread when it stops draining the queue, the commands left are never applied.
+VOID DELTACALL dscq_close(dscq* pQueue);
@@ -22,34 +22,35 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include "deltasound.h"
 #include "ds.h"
 #include "dsb.h"
 #include "dsdevice.h"
-#include "uuid.h"
+#include "rtp.h"
 #include "wave.h"
 
-#define REFTIMES_PER_SEC                    10000000
-#define TARGET_BUFFER_PADDING_IN_SECONDS    (1.0f / 60.0f)
-
-#define AUDCLNT_BUFFERFLAGS_NONE            0
-
-#define RELEASE(X) if ((X) != NULL) { (X)->lpVtbl->Release(X); (X) = NULL; }
-#define RELEASEHANDLE(X) if((X)) { CloseHandle((X)); (X) = NULL; }
-
+// Owned by the creating thread, the render thread does not touch it once it has published the result.
 typedef struct dsdevice_thread_context {
     dsdevice*   Device;
     HANDLE      Init;
+    HRESULT     Result;     // Of the opening of the endpoint
 } dsdevice_thread_context;
 
 DWORD WINAPI dsdevice_thread(dsdevice_thread_context* ctx);
 
 HRESULT DELTACALL dsdevice_initialize(dsdevice* pDev);
-HRESULT DELTACALL dsdevice_get_mix_format(dsdevice* pDev, LPWAVEFORMATEX* ppFormat);
-
-HRESULT DELTACALL dsdevice_render(dsdevice* pDev, DWORD dwBuffers, dsb** ppBuffers);
-HRESULT DELTACALL dsdevice_get_active_buffers(dsdevice* self, LPDWORD pdwCount, dsb*** ppBuffers);
-
-HRESULT DELTACALL dsdevice_create(allocator* pAlloc, ds* pDS, device_info* pInfo, dsdevice** ppOut) {
+HRESULT DELTACALL dsdevice_reserve(dsdevice* pDev);
+
+HRESULT DELTACALL dsdevice_apply_commands(dsdevice* pDev);
+HRESULT DELTACALL dsdevice_maintain(dsdevice* pDev);
+HRESULT DELTACALL dsdevice_trim(dsdevice* pDev);
+HRESULT DELTACALL dsdevice_render(dsdevice* pDev, DWORD dwVoices, LPDWORD pdwVoices);
+HRESULT DELTACALL dsdevice_suspend(dsdevice* pDev);
+HRESULT DELTACALL dsdevice_reopen(dsdevice* pDev);
+HRESULT DELTACALL dsdevice_grow_voices(dsdevice* pDev, DWORD dwCapacity);
+HRESULT DELTACALL dsdevice_get_active_voices(dsdevice* pDev, LPDWORD pdwCount, LPDWORD* ppVoices);
+
+HRESULT DELTACALL dsdevice_create(allocator* pAlloc, deltasound* pD, device_info* pInfo, dsdevice** ppOut) {
     if (pAlloc == NULL) {
         return E_INVALIDARG;
     }
@@ -60,68 +61,111 @@ HRESULT DELTACALL dsdevice_create(allocator* pAlloc, ds* pDS, device_info* pInfo
 
     HRESULT hr = S_OK;
     dsdevice* instance = NULL;
+    dsdevice_thread_context* ctx = NULL;
 
     if (SUCCEEDED(hr = allocator_allocate(pAlloc, sizeof(dsdevice), &instance))) {
         instance->Allocator = pAlloc;
-        instance->Instance = pDS;
+        instance->Instance = pD;
 
         CopyMemory(&instance->Info, pInfo, sizeof(device_info));
 
-        if (SUCCEEDED(hr = arena_create(pAlloc, &instance->Arena))) {
-            if (SUCCEEDED(hr = mixer_create(pAlloc, &instance->Mixer))) {
-                dsdevice_thread_context* ctx;
+        instance->Realtime = pD->Config.RealtimeCheck;
 
-                if (FAILED(hr = allocator_allocate(pAlloc, sizeof(dsdevice_thread_context), &ctx))) {
-                    dsdevice_release(instance);
-                    return hr;
-                }
+        InitializeCriticalSection(&instance->Lock);
 
-                ctx->Init = CreateEventA(NULL, FALSE, FALSE, NULL);
-                if (ctx->Init == NULL) {
-                    dsdevice_release(instance);
-                    return E_FAIL;
-                }
+#if DELTASOUND_TIMING
+        if (FAILED(hr = dstm_create(pAlloc, &instance->Timing))) {
+            dsdevice_release(instance);
+            return hr;
+        }
+#endif
 
-                for (DWORD i = 0; i < DSDEVICE_MAX_EVENT_COUNT; i++) {
-                    instance->Events[i] = CreateEventA(NULL, FALSE, FALSE, NULL);
+        if (FAILED(hr = arena_create(pAlloc, &instance->Arena))) {
+            dsdevice_release(instance);
+            return hr;
+        }
 
-                    if (instance->Events[i] == NULL) {
-                        dsdevice_release(instance);
-                        return E_FAIL;
-                    }
-                }
+        if (FAILED(hr = mixer_create(pAlloc, &pD->Kernel, instance->Timing, &instance->Mixer))) {
+            dsdevice_release(instance);
+            return hr;
+        }
 
-                instance->ThreadEvent = CreateEventA(NULL, FALSE, FALSE, NULL);
-                if (instance->ThreadEvent == NULL) {
-                    dsdevice_release(instance);
-                    return E_FAIL;
-                }
+        if (FAILED(hr = dscq_create(pAlloc, DSDEVICE_COMMAND_QUEUE_CAPACITY, &instance->Commands))) {
+            dsdevice_release(instance);
+            return hr;
+        }
+
+        if (FAILED(hr = dsvt_create(pAlloc, pD->Config.MaxVoices, &instance->Voices))) {
+            dsdevice_release(instance);
+            return hr;
+        }
 
-                ctx->Device = instance;
+        if (FAILED(hr = backend_create(pAlloc, &pD->Config, &instance->Backend))) {
+            dsdevice_release(instance);
+            return hr;
+        }
 
-                instance->Thread = CreateThread(NULL, 0, dsdevice_thread, ctx, 0, NULL);
+        instance->Close = CreateEventA(NULL, FALSE, FALSE, NULL);
+        if (instance->Close == NULL) {
+            dsdevice_release(instance);
+            return E_FAIL;
+        }
 
-                if (instance->Thread == NULL) {
-                    dsdevice_release(instance);
-                    return E_FAIL;
-                }
+        instance->Wake = CreateEventA(NULL, FALSE, FALSE, NULL);
+        if (instance->Wake == NULL) {
+            dsdevice_release(instance);
+            return E_FAIL;
+        }
 
-                SetThreadPriority(instance->Thread, THREAD_PRIORITY_TIME_CRITICAL);
+        instance->ThreadEvent = CreateEventA(NULL, FALSE, FALSE, NULL);
+        if (instance->ThreadEvent == NULL) {
+            dsdevice_release(instance);
+            return E_FAIL;
+        }
 
-                WaitForSingleObject(ctx->Init, INFINITE);
-                CloseHandle(ctx->Init);
+        // Without the notification the memory is still trimmed when the device is idle.
+        instance->MemoryNotification = CreateMemoryResourceNotification(LowMemoryResourceNotification);
 
-                // TODO check if thread exited prematurely...
+        if (FAILED(hr = allocator_allocate(pAlloc, sizeof(dsdevice_thread_context), &ctx))) {
+            dsdevice_release(instance);
+            return hr;
+        }
 
-                *ppOut = instance;
+        ctx->Device = instance;
+        ctx->Result = E_FAIL;
 
-                return S_OK;
-            }
+        ctx->Init = CreateEventA(NULL, FALSE, FALSE, NULL);
+        if (ctx->Init == NULL) {
+            allocator_free(pAlloc, ctx);
+            dsdevice_release(instance);
+            return E_FAIL;
+        }
+
+        instance->Thread = CreateThread(NULL, 0, dsdevice_thread, ctx, 0, NULL);
 
-            mixer_release(instance->Mixer);
+        if (instance->Thread == NULL) {
+            CloseHandle(ctx->Init);
+            allocator_free(pAlloc, ctx);
+            dsdevice_release(instance);
+            return E_FAIL;
         }
 
-        arena_release(instance->Arena);
+        // The thread signals the event whether or not the endpoint opened, and exits when it did not.
+        WaitForSingleObject(ctx->Init, INFINITE);
+        CloseHandle(ctx->Init);
+
+        hr = ctx->Result;
+
+        allocator_free(pAlloc, ctx);
+
+        if (FAILED(hr)) {
+            dsdevice_release(instance);
+            return hr;
+        }
+
+        *ppOut = instance;
+
+        return S_OK;
     }
 
     return hr;
@@ -131,142 +175,355 @@ VOID DELTACALL dsdevice_release(dsdevice* self) {
     if (self == NULL) { return; }
 
     if (self->Thread != NULL) {
-        SetEvent(self->Events[DSDEVICE_CLOSE_EVENT_INDEX]);
+        SetEvent(self->Close);
 
         // NOTE. Cannot wait for thread handle,
         // because it does not fire when thread is being
         // terminated through the FreeLibrary function call.
 
         WaitForSingleObject(self->ThreadEvent, INFINITE);
-        CloseHandle(self->ThreadEvent);
         CloseHandle(self->Thread);
     }
 
+    if (self->ThreadEvent != NULL) {
+        CloseHandle(self->ThreadEvent);
+    }
+
+    if (self->Close != NULL) {
+        CloseHandle(self->Close);
+    }
+
+    if (self->Wake != NULL) {
+        CloseHandle(self->Wake);
+    }
+
+    if (self->MemoryNotification != NULL) {
+        CloseHandle(self->MemoryNotification);
+    }
+
+    backend_release(self->Backend);
+
     mixer_release(self->Mixer);
+    arena_release(self->Arena);
+    dscq_release(self->Commands);
+
+    dsvt_release(self->Voices);
+
+    dstm_release(self->Timing);
+
+    DeleteCriticalSection(&self->Lock);
 
     allocator_free(self->Allocator, self);
 }
 
-/* ---------------------------------------------------------------------- */
-
-HRESULT DELTACALL dsdevice_initialize(dsdevice* self) {
+HRESULT DELTACALL dsdevice_reserve_voice(dsdevice* self) {
     if (self == NULL) {
         return E_POINTER;
     }
 
     HRESULT hr = S_OK;
-    IMMDeviceEnumerator* enumerator = NULL;
-    LPWAVEFORMATEX wfx = NULL;
 
-    if (FAILED(hr = CoCreateInstance(&CLSID_IMMDeviceEnumerator,
-        NULL, CLSCTX_ALL, &IID_IMMDeviceEnumerator, &enumerator))) {
-        goto exit;
+    EnterCriticalSection(&self->Lock);
+
+    // The capacity changes only while the lock is held, by the render thread applying the resize.
+    if (self->Reserved < self->Voices->Capacity
+        || SUCCEEDED(hr = dsdevice_grow_voices(self, self->Voices->Capacity * 2))) {
+        self->Reserved++;
     }
 
-    if (FAILED(hr = IMMDeviceEnumerator_GetDevice(enumerator,
-        self->Info.Module, &self->Device))) {
-        goto exit;
+    LeaveCriticalSection(&self->Lock);
+
+    return hr;
+}
+
+VOID DELTACALL dsdevice_release_voice(dsdevice* self) {
+    if (self == NULL) { return; }
+
+    EnterCriticalSection(&self->Lock);
+
+    self->Reserved--;
+
+    LeaveCriticalSection(&self->Lock);
+}
+
+HRESULT DELTACALL dsdevice_activate_buffer(dsdevice* self, dsb* pDSB) {
+    if (self == NULL) {
+        return E_POINTER;
     }
 
-    if (FAILED(hr = IMMDevice_Activate(self->Device,
-        &IID_IAudioClient, CLSCTX_INPROC_SERVER, NULL, &self->AudioClient))) {
-        goto exit;
+    if (pDSB == NULL) {
+        return E_INVALIDARG;
     }
 
-    if (FAILED(hr = dsdevice_get_mix_format(self, &wfx))) {
-        goto exit;
+    if (pDSB->ActiveIndex != DSB_INACTIVE_INDEX) {
+        return S_FALSE;
     }
 
-    if (FAILED(hr = IAudioClient_Initialize(self->AudioClient,
-        AUDCLNT_SHAREMODE_SHARED,
-        AUDCLNT_STREAMFLAGS_NOPERSIST | AUDCLNT_STREAMFLAGS_EVENTCALLBACK,
-        REFTIMES_PER_SEC, 0, wfx, NULL))) {
-        goto exit;
+    return dsvt_add_voice(self->Voices, pDSB, pDSB->Buffer, &pDSB->ActiveIndex);
+}
+
+HRESULT DELTACALL dsdevice_deactivate_buffer(dsdevice* self, dsb* pDSB) {
+    if (self == NULL) {
+        return E_POINTER;
     }
 
-    if (FAILED(hr = allocator_allocate(self->Allocator, SIZEOFFORMATEX(wfx), &self->Format))) {
-        goto exit;
+    if (pDSB == NULL) {
+        return E_INVALIDARG;
     }
 
-    CopyMemory(self->Format, wfx, SIZEOFFORMATEX(wfx));
+    if (pDSB->ActiveIndex == DSB_INACTIVE_INDEX) {
+        return S_FALSE;
+    }
 
-    CoTaskMemFree(wfx);
+    HRESULT hr = S_OK;
+    dsb* moved = NULL;
 
-    if (FAILED(hr = IAudioClient_SetEventHandle(self->AudioClient,
-        self->Events[DSDEVICE_AUDIO_EVENT_INDEX]))) {
-        goto exit;
+    if (SUCCEEDED(hr = dsvt_remove_voice(self->Voices, pDSB->ActiveIndex, &moved))) {
+        if (moved != NULL) {
+            moved->ActiveIndex = pDSB->ActiveIndex;
+        }
+
+        pDSB->ActiveIndex = DSB_INACTIVE_INDEX;
     }
 
-    if (FAILED(hr = IAudioClient_GetService(self->AudioClient,
-        &IID_IAudioRenderClient, &self->AudioRenderer))) {
-        goto exit;
+    return hr;
+}
+
+HRESULT DELTACALL dsdevice_post(dsdevice* self, const dscmd* pcCommand) {
+    if (self == NULL) {
+        return E_POINTER;
     }
 
-    if (FAILED(hr = IAudioClient_GetBufferSize(self->AudioClient, &self->AudioClientBufferSize))) {
-        goto exit;
+    HRESULT hr = S_OK;
+
+    // The post is a full barrier, either the suspended render thread sees the command or it is woken for it.
+    if ((hr = dscq_post(self->Commands, pcCommand)) == S_OK) {
+        if (self->Suspended) {
+            SetEvent(self->Wake);
+        }
     }
 
-    if (FAILED(hr = IAudioClient_Start(self->AudioClient))) {
-        goto exit;
+    // The render thread asks for the trim when the memory runs low while voices play.
+    if (self->Pressure && InterlockedExchange(&self->Pressure, FALSE)) {
+        dsdevice_trim(self);
+    }
+
+    return hr == S_FALSE ? DSERR_NODRIVER : hr;
+}
+
+HRESULT DELTACALL dsdevice_compact(dsdevice* self) {
+    if (self == NULL) {
+        return E_POINTER;
     }
 
-    RELEASE(enumerator);
+    HRESULT hr = S_OK;
+    DWORD mixer = 0, arena = 0, slabs = 0;
+
+    // Compaction is the one place the render thread is allowed to free memory and take the allocator lock,
+    // the arenas keep the reserved memory.
+    const DWORD depth = rtc_suspend();
+
+    if (SUCCEEDED(hr = mixer_compact(self->Mixer, &mixer))) {
+        if (SUCCEEDED(hr = arena_trim(self->Arena, &arena))) {
+            hr = allocator_trim(self->Allocator, &slabs);
+        }
+    }
+
+    rtc_resume(depth);
+
+    InterlockedAdd64(&self->Reclaimed, (LONG64)mixer + arena + slabs);
+
+    return hr;
+}
+
+HRESULT DELTACALL dsdevice_get_latency(dsdevice* self, LPDWORD pdwMilliseconds, PDWORD64 pdwUnderruns) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    const DWORD frequency = (DWORD)self->Frequency;
+
+    if (frequency == 0) {
+        return DSERR_UNINITIALIZED;
+    }
+
+    if (pdwMilliseconds != NULL) {
+        *pdwMilliseconds = (DWORD)((DWORD64)dslc_get_target(&self->Latency) * 1000 / frequency);
+    }
+
+    if (pdwUnderruns != NULL) {
+        *pdwUnderruns = dslc_get_underrun_count(&self->Latency);
+    }
 
     return S_OK;
+}
 
-exit:
+HRESULT DELTACALL dsdevice_get_timing(dsdevice* self, DWORD dwHistogram, dstm_histogram* pHistogram) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (self->Timing == NULL) {
+        return DSERR_UNSUPPORTED;
+    }
+
+    return dstm_get_histogram(self->Timing, dwHistogram, pHistogram);
+}
+
+/* ---------------------------------------------------------------------- */
+
+HRESULT DELTACALL dsdevice_initialize(dsdevice* self) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    HRESULT hr = S_OK;
+
+    if (FAILED(hr = backend_open(self->Backend, &self->Info))) {
+        return hr;
+    }
+
+    DWORD period = 0, least = 0;
+    PWAVEFORMATEXTENSIBLE format = NULL;
+
+    if (SUCCEEDED(hr = backend_get_format(self->Backend, &format))) {
+        if (SUCCEEDED(hr = backend_get_buffer_size(self->Backend, &self->BufferSize))) {
+            if (SUCCEEDED(hr = backend_get_period(self->Backend, &period))
+                && SUCCEEDED(hr = backend_get_min_latency(self->Backend, &least))) {
+                const config* settings = &self->Instance->Config;
+
+                const DWORD frequency = format->Format.nSamplesPerSec;
+
+                // The backend frees its format when the endpoint is closed, the device keeps a copy of it.
+                const LPWAVEFORMATEX wfx = &format->Format;
+
+                ZeroMemory(&self->Format, sizeof(WAVEFORMATEXTENSIBLE));
+                CopyMemory(&self->Format, format, min(sizeof(WAVEFORMATEXTENSIBLE), SIZEOFFORMATEX(wfx)));
+
+                const DWORD previous = (DWORD)InterlockedExchange(&self->Frequency, (LONG)frequency);
 
-    if (self->Format != NULL) {
-        allocator_free(self->Allocator, self->Format);
+                self->Rebind = self->Rebind || (previous != 0 && previous != frequency);
+
+                DWORD maximum = min((DWORD)((DWORD64)settings->MaxLatency * frequency / 1000), self->BufferSize);
+                DWORD minimum = min((DWORD)((DWORD64)settings->MinLatency * frequency / 1000), maximum);
+
+                // Endpoints that swap whole buffers are always filled to the same depth.
+                minimum = min(max(minimum, least), self->BufferSize);
+                maximum = max(maximum, minimum);
+
+                // On the virtual clock the wake-ups take no time, the latency is fixed so that the runs repeat exactly.
+                if (settings->VirtualClock && settings->Backend != CONFIG_BACKEND_WASAPI) {
+                    minimum = maximum = min(max(minimum, 2 * period), self->BufferSize);
+                }
+
+                self->SuspendFrames = (DWORD64)settings->IdleTimeout * frequency / 1000;
+
+                if (SUCCEEDED(hr = dslc_initialize(&self->Latency, frequency, period, max(minimum, 1), max(maximum, 1)))) {
+                    dstm_set_period(self->Timing, frequency, period);
+
+                    return S_OK;
+                }
+            }
+        }
     }
 
-    RELEASE(self->AudioRenderer);
-    RELEASE(self->AudioClient);
-    RELEASE(self->Device);
-    RELEASE(enumerator);
+    backend_close(self->Backend);
 
     return hr;
 }
 
-HRESULT DELTACALL dsdevice_get_mix_format(dsdevice* self, LPWAVEFORMATEX* ppFormat) {
+HRESULT DELTACALL dsdevice_reserve(dsdevice* self) {
     if (self == NULL) {
         return E_POINTER;
     }
 
-    if (ppFormat == NULL) {
-        return E_INVALIDARG;
+    HRESULT hr = S_OK;
+
+    // The arenas are sized up front for the configured number of voices,
+    // so that the render periods do not allocate as long as the voices fit the table.
+    const DWORD voices = self->Voices->Capacity;
+    const DWORD frames = self->Latency.MaxFrames;
+
+    if (SUCCEEDED(hr = arena_reserve(self->Arena, voices * sizeof(DWORD)))) {
+        hr = mixer_reserve(self->Mixer, voices, self->Format.Format.nSamplesPerSec, frames);
+    }
+
+    return hr;
+}
+
+HRESULT DELTACALL dsdevice_apply_commands(dsdevice* self) {
+    if (self == NULL) {
+        return E_POINTER;
     }
 
-    return IAudioClient_GetMixFormat(self->AudioClient, ppFormat);
+    HRESULT hr = S_OK;
+    dscmd command;
+
+    while ((hr = dscq_peek(self->Commands, &command)) == S_OK) {
+        if (command.Type == DSCQ_COMMAND_STATUS) {
+            dsb_set_render_status(command.Buffer, command.Play, command.Status);
+        }
+        else if (command.Type == DSCQ_COMMAND_COMPACT) {
+            dsdevice_compact(self);
+        }
+        else if (command.Type == DSCQ_COMMAND_RESIZE) {
+            dsvt_move(self->Voices, command.Memory, command.Capacity);
+
+            arena_swap(self->Arena, &command.Blocks[0]);
+            mixer_swap(self->Mixer, &command.Blocks[1]);
+        }
+
+        // A buffer released by an API thread may be freed as soon as its last command is removed.
+        dscq_pop(self->Commands);
+    }
+
+    return SUCCEEDED(hr) ? S_OK : hr;
 }
 
-HRESULT DELTACALL dsdevice_render(dsdevice* self, DWORD dwBuffers, dsb** ppBuffers) {
+HRESULT DELTACALL dsdevice_render(dsdevice* self, DWORD dwVoices, LPDWORD pdwVoices) {
     if (self->Instance == NULL) {
         return E_FAIL;
     }
 
     HRESULT hr = S_OK;
-    UINT32 padding = 0;
+    DWORD padding = 0;
 
-    if (SUCCEEDED(hr = IAudioClient_GetCurrentPadding(self->AudioClient, &padding))) {
-        const UINT32 frames =
-            (UINT32)(self->AudioClientBufferSize * TARGET_BUFFER_PADDING_IN_SECONDS) - padding;
+    if (SUCCEEDED(hr = backend_get_padding(self->Backend, &padding))) {
+        const DWORD frames = dslc_get_frames(&self->Latency, padding);
 
         if (frames != 0) {
             BYTE* lock = NULL;
+            LARGE_INTEGER start, end;
+
+            QueryPerformanceCounter(&start);
 
-            if (SUCCEEDED(hr = IAudioRenderClient_GetBuffer(self->AudioRenderer, frames, &lock))) {
-                LPVOID buffer = NULL;
+            if (SUCCEEDED(hr = backend_acquire_buffer(self->Backend, frames, &lock))) {
                 DWORD available = 0;
 
-                if (SUCCEEDED(hr = mixer_mix(self->Mixer, dwBuffers, ppBuffers,
-                    self->Format, frames, &buffer, &available))) {
-                    CopyMemory(lock, buffer, available * self->Format->Format.nBlockAlign);
+                // Without voices the endpoint is kept fed with silence, nothing is mixed.
+                if (dwVoices == 0) {
+                    available = frames;
 
-                    hr = IAudioRenderClient_ReleaseBuffer(self->AudioRenderer, available, AUDCLNT_BUFFERFLAGS_NONE);
+                    hr = backend_release_buffer(self->Backend, frames, BACKEND_RELEASE_SILENT);
+                }
+                // The mix is written straight into the endpoint buffer.
+                else if (SUCCEEDED(hr = mixer_mix(self->Mixer, self->Voices, dwVoices, pdwVoices,
+                    &self->Format, frames, lock, &available))) {
+                    hr = backend_release_buffer(self->Backend, available, BACKEND_RELEASE_NONE);
                 }
                 else {
-                    hr = IAudioRenderClient_ReleaseBuffer(self->AudioRenderer, 0, AUDCLNT_BUFFERFLAGS_SILENT);
+                    available = 0;
+
+                    hr = backend_release_buffer(self->Backend, 0, BACKEND_RELEASE_SILENT);
+                }
+
+                QueryPerformanceCounter(&end);
+
+                // The cost of the mix is how much sooner the next one has to start.
+                dslc_commit(&self->Latency, available, end.QuadPart - start.QuadPart);
+
+                if (dwVoices != 0) {
+                    DSTM_RECORD(self->Timing, DSTM_RENDER, end.QuadPart - start.QuadPart);
                 }
             }
         }
@@ -275,112 +532,316 @@ HRESULT DELTACALL dsdevice_render(dsdevice* self, DWORD dwBuffers, dsb** ppBuffe
     return hr;
 }
 
-HRESULT DELTACALL dsdevice_get_active_buffers(dsdevice* self, LPDWORD pdwCount, dsb*** ppBuffers) {
+HRESULT DELTACALL dsdevice_maintain(dsdevice* self) {
     if (self == NULL) {
         return E_POINTER;
     }
 
-    if (pdwCount == NULL || ppBuffers == NULL) {
+    const ULONGLONG now = GetTickCount64();
+    BOOL compact = FALSE;
+
+    // The memory is trimmed once the device has been idle for a while, and again after it played.
+    if (self->Voices->Count != 0) {
+        self->IdleTime = now;
+        self->IdleCompacted = FALSE;
+    }
+    else if (!self->IdleCompacted && DSDEVICE_IDLE_COMPACT_TIMEOUT <= now - self->IdleTime) {
+        self->IdleCompacted = TRUE;
+        compact = TRUE;
+    }
+
+    if (self->MemoryNotification != NULL && DSDEVICE_MEMORY_CHECK_INTERVAL <= now - self->MemoryCheckTime) {
+        BOOL low = FALSE;
+
+        self->MemoryCheckTime = now;
+
+        // The render thread takes the allocator lock only when no voice plays, otherwise an API thread trims.
+        if (QueryMemoryResourceNotification(self->MemoryNotification, &low) && low) {
+            if (self->Voices->Count == 0) {
+                compact = TRUE;
+            }
+            else {
+                InterlockedExchange(&self->Pressure, TRUE);
+            }
+        }
+    }
+
+    return compact ? dsdevice_compact(self) : S_OK;
+}
+
+HRESULT DELTACALL dsdevice_trim(dsdevice* self) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    HRESULT hr = S_OK;
+    DWORD slabs = 0;
+
+    // The arenas and the pools are owned by the render thread, they are trimmed once the device is idle.
+    if (SUCCEEDED(hr = allocator_trim(self->Allocator, &slabs))) {
+        InterlockedAdd64(&self->Reclaimed, slabs);
+    }
+
+    return hr;
+}
+
+HRESULT DELTACALL dsdevice_get_active_voices(dsdevice* self, LPDWORD pdwCount, LPDWORD* ppVoices) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (pdwCount == NULL || ppVoices == NULL) {
         return E_INVALIDARG;
     }
 
     HRESULT hr = S_OK;
-    ds* instance = self->Instance;
+    dsvt* voices = self->Voices;
 
     if (FAILED(hr = arena_clear(self->Arena))) {
         return hr;
     }
 
-    if (instance->Level == DSSCL_WRITEPRIMARY
-        && (instance->Main->Status & DSBSTATUS_PLAYING)) {
-        dsb** buffers = NULL;
+    LPDWORD indexes = NULL;
+    DWORD count = 0;
 
-        if (FAILED(hr = arena_allocate(self->Arena, sizeof(dsb**), (LPVOID*)&buffers))) {
+    // Only the rows to mix are listed, the mixer reads the voice state from the table.
+    if (voices->Count != 0) {
+        if (FAILED(hr = arena_allocate_uninitialized(self->Arena,
+            voices->Count * sizeof(DWORD), (LPVOID*)&indexes))) {
             return hr;
         }
+    }
+
+    BOOL rebind = FALSE;
+
+    for (DWORD i = 0; i < voices->Count; i++) {
+        dsb* buffer = voices->Buffers[i];
+
+        // The kernels of the voices are selected for the frequency of the endpoint, which changes when it reopens.
+        if (self->Rebind && dsb_rebind_voice(buffer) != S_OK) {
+            rebind = TRUE;
+        }
+
+        dsb_refresh_voice(buffer, voices);
 
-        buffers[0] = instance->Main;
+        // The primary buffer is mixed only in the write primary mode, and then exclusively
+        // of the secondary buffers of the same DirectSound object.
+        const BOOL primary = buffer->Instance->Level == DSSCL_WRITEPRIMARY;
 
-        *pdwCount = 1;
-        *ppBuffers = buffers;
+        if (((voices->Flags[i] & DSVT_VOICE_PRIMARY) != 0) == primary) {
+            indexes[count++] = i;
+        }
     }
-    else {
-        dsb** buffers = NULL;
-        DWORD count = 0;
 
-        const DWORD available = arr_get_count(instance->Buffers);
+    self->Rebind = rebind;
 
-        if (FAILED(hr = arena_allocate(self->Arena, available * sizeof(dsb**), (LPVOID*)&buffers))) {
-            return hr;
+    *pdwCount = count;
+    *ppVoices = indexes;
+
+    return hr;
+}
+
+HRESULT DELTACALL dsdevice_suspend(dsdevice* self) {
+    HRESULT hr = S_OK;
+
+    // The endpoint that cannot be stopped keeps playing silence, the suspension is tried again after another timeout.
+    if (FAILED(hr = backend_suspend(self->Backend))) {
+        self->SilentFrames = 0;
+
+        return S_OK;
+    }
+
+    // The idle device gives the memory back right away, rather than after the idle timeout.
+    if (!self->IdleCompacted) {
+        self->IdleCompacted = TRUE;
+
+        dsdevice_compact(self);
+    }
+
+    InterlockedExchange(&self->Suspended, TRUE);
+
+    DWORD result = WAIT_OBJECT_0;
+    HANDLE events[] = { self->Wake, self->Close };
+
+    // The commands posted before the flag was raised did not signal the event, so they are applied first.
+    // Commands that do not start a buffer are applied, and the device goes back to sleep.
+    for (;;) {
+        dsdevice_apply_commands(self);
+
+        if (self->Voices->Count != 0) {
+            break;
         }
 
-        for (DWORD i = 0; i < available; i++) {
-            dsb* buffer = NULL;
+        if ((result = WaitForMultipleObjects(_countof(events), events, FALSE, INFINITE)) != WAIT_OBJECT_0) {
+            break;
+        }
+    }
+
+    InterlockedExchange(&self->Suspended, FALSE);
 
-            if (SUCCEEDED(arr_get_item(instance->Buffers, i, &buffer))) {
-                DWORD status = DSBSTATUS_NONE;
+    if (result != WAIT_OBJECT_0) {
+        return result == WAIT_OBJECT_0 + 1 ? S_FALSE : E_FAIL;
+    }
+
+    self->SilentFrames = 0;
+
+    dslc_reset(&self->Latency);
+
+    DSTM_RESET(self->Timing);
+
+    // The endpoint may have been invalidated while the device slept.
+    if (FAILED(hr = backend_resume(self->Backend))) {
+        hr = dsdevice_reopen(self);
+    }
+
+    return hr;
+}
+
+HRESULT DELTACALL dsdevice_reopen(dsdevice* self) {
+    HRESULT hr = S_OK;
+
+    backend_close(self->Backend);
+
+    if (SUCCEEDED(hr = dsdevice_initialize(self))) {
+        dsdevice_reserve(self);
+    }
+
+    return hr;
+}
+
+HRESULT DELTACALL dsdevice_grow_voices(dsdevice* self, DWORD dwCapacity) {
+    HRESULT hr = S_OK;
+    LPVOID memory = NULL;
+    LPVOID blocks[] = { NULL, NULL };
 
-                if (SUCCEEDED(dsb_get_status(buffer, &status))) {
-                    if (status & DSBSTATUS_PLAYING) {
-                        buffers[count++] = buffer;
-                    }
+    if (SUCCEEDED(hr = dsvt_allocate(self->Voices, dwCapacity, &memory))) {
+        const LPVOID previous = self->Voices->Memory;
+
+        // The arenas are reserved for the grown table too, so that the render thread does not allocate for the added voices.
+        if (SUCCEEDED(hr = arena_prepare(self->Arena, dwCapacity * sizeof(DWORD), &blocks[0]))) {
+            if (SUCCEEDED(hr = mixer_prepare(self->Mixer,
+                dwCapacity, (DWORD)self->Frequency, self->Latency.MaxFrames, &blocks[1]))) {
+                const dscmd command = {
+                    DSCQ_COMMAND_RESIZE, NULL, DSBPLAY_NONE, DSBSTATUS_NONE, memory, dwCapacity, blocks };
+
+                if (SUCCEEDED(hr = dsdevice_post(self, &command))) {
+                    dscq_flush(self->Commands);
                 }
             }
         }
 
-        *pdwCount = count;
-        *ppBuffers = buffers;
+        // The command is dropped when the render thread stops before it applies it.
+        if (self->Voices->Memory == memory) {
+            dsvt_free(self->Voices, previous);
+        }
+        else {
+            dsvt_free(self->Voices, memory);
+        }
+
+        // Either the replaced blocks or the prepared ones that were not swapped in.
+        arena_discard(self->Arena, blocks[0]);
+        mixer_discard(self->Mixer, blocks[1]);
     }
 
     return hr;
 }
 
 DWORD WINAPI dsdevice_thread(dsdevice_thread_context* ctx) {
-    if (FAILED(CoInitializeEx(NULL, COINIT_SPEED_OVER_MEMORY))) {
+    HRESULT hr = S_OK;
+    dsdevice* device = ctx->Device;
+
+    if (FAILED(hr = CoInitializeEx(NULL, COINIT_SPEED_OVER_MEMORY))) {
+        ctx->Result = hr;
+
+        SetEvent(ctx->Init);
+        SetEvent(device->ThreadEvent);
+
         return EXIT_FAILURE;
     }
 
-    HRESULT hr = S_OK;
-    dsdevice* device = ctx->Device;
+    rtp policy;
+    rtp_enter(&policy, &device->Instance->Config, "Render");
 
-    if (FAILED(hr = dsdevice_initialize(device))) {
-        goto exit;
+    if (SUCCEEDED(hr = dsdevice_initialize(device))) {
+        // Without the reservation the arenas grow on the first render periods instead.
+        dsdevice_reserve(device);
+
+        device->IdleTime = device->MemoryCheckTime = GetTickCount64();
     }
 
+    ctx->Result = hr;
+
     SetEvent(ctx->Init);
 
-    while (TRUE) {
-        const DWORD result =
-            WaitForMultipleObjects(DSDEVICE_MAX_EVENT_COUNT, device->Events, FALSE, INFINITE);
+    if (FAILED(hr)) {
+        goto exit;
+    }
+
+    // The backend paces the thread, the wait ends with the period of the endpoint or when the device closes.
+    // An endpoint that fails, e.g. when it is invalidated, is opened again, and the device is lost when it cannot be.
+    // Only then the thread exits, and the commands posted to the device are rejected.
+    while ((hr = backend_wait(device->Backend, device->Close)) != S_FALSE) {
+        LPDWORD voices = NULL;
+        DWORD count = 0;
 
-        if (result == DSDEVICE_CLOSE_EVENT_INDEX
-            || result == DSDEVICE_MAX_EVENT_COUNT) {
+        if (FAILED(hr) && FAILED(hr = dsdevice_reopen(device))) {
             break;
         }
-        else if (result == DSDEVICE_AUDIO_EVENT_INDEX) {
-            dsb** buffers = NULL;
-            DWORD count = 0;
 
-            if (SUCCEEDED(hr = dsdevice_get_active_buffers(device, &count, &buffers))) {
-                if (count != 0) {
-                    hr = dsdevice_render(device, count, buffers);
-                }
+        dslc_wake(&device->Latency);
+
+        DSTM_WAKE(device->Timing);
+
+        if (device->Realtime) {
+            rtc_enter();
+        }
+
+        // State changes made by the API threads are applied together at the period boundary.
+        dsdevice_apply_commands(device);
+        dsdevice_maintain(device);
+
+        // While no buffers play, the table is not scanned and the period is rendered as silence.
+        if (device->Voices->Count != 0) {
+            device->SilentFrames = 0;
+
+            DSTM_START(mark);
+
+            if (SUCCEEDED(hr = dsdevice_get_active_voices(device, &count, &voices))) {
+                DSTM_LAP(device->Timing, DSTM_GATHER, mark);
+
+                hr = dsdevice_render(device, count, voices);
             }
         }
-    }
+        else {
+            device->SilentFrames += device->Latency.Period;
+
+            hr = dsdevice_render(device, 0, NULL);
+        }
+
+        if (device->Realtime) {
+            rtc_leave();
+        }
 
-    if (device->Format != NULL) {
-        allocator_free(device->Allocator, device->Format);
+        if (device->SuspendFrames != 0 && device->SuspendFrames <= device->SilentFrames) {
+            if ((hr = dsdevice_suspend(device)) != S_OK) {
+                break;
+            }
+        }
     }
 
-    RELEASE(device->AudioRenderer);
-    RELEASE(device->AudioClient);
-    RELEASE(device->Device);
+    // Past this point the voices are never touched again, the API threads stop waiting for the commands.
+    dscq_close(device->Commands);
 
-    allocator_free(device->Allocator, ctx);
+#if DELTASOUND_TIMING
+    dstm_dump(device->Timing);
+#endif
+
+    backend_close(device->Backend);
 
 exit:
 
+    rtp_leave(&policy);
+
     CoUninitialize();
 
     SetEvent(device->ThreadEvent);
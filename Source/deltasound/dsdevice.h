@@ -25,37 +25,89 @@ SOFTWARE.
 #pragma once
 
 #include "arena.h"
+#include "backend.h"
 #include "device_info.h"
+#include "dscq.h"
+#include "dslc.h"
+#include "dstm.h"
+#include "dsvt.h"
 #include "mixer.h"
 
-typedef struct ds ds;
+typedef struct deltasound deltasound;
 
-#define DSDEVICE_AUDIO_EVENT_INDEX      0
-#define DSDEVICE_CLOSE_EVENT_INDEX      1
+#define DSDEVICE_COMMAND_QUEUE_CAPACITY 1024
 
-#define DSDEVICE_MAX_EVENT_COUNT        2
+#define DSDEVICE_IDLE_COMPACT_TIMEOUT   30000   // In milliseconds
+#define DSDEVICE_MEMORY_CHECK_INTERVAL  1000    // In milliseconds
 
+typedef struct dsb dsb;
+
+// The engine of an endpoint, shared by all the DirectSound objects that play to it.
+// Their voices are mixed together by one render thread, into one stream.
 typedef struct dsdevice {
     allocator*              Allocator;
-    ds*                     Instance;
+    deltasound*             Instance;
+    LONG                    References; // Of the DirectSound objects, guarded by the lock of the instance
     arena*                  Arena;
     mixer*                  Mixer;
+    dscq*                   Commands;
 
     device_info             Info;
 
-    IMMDevice*              Device;
-    IAudioClient*           AudioClient;
-    IAudioRenderClient*     AudioRenderer;
+    backend*                Backend;
+
+    DWORD                   BufferSize; // In frames
 
-    UINT32                  AudioClientBufferSize;  // In frames
+    dslc                    Latency;
+    dstm*                   Timing;     // None unless the build measures the render timing
 
-    PWAVEFORMATEXTENSIBLE   Format;
+    WAVEFORMATEXTENSIBLE    Format;     // Of the endpoint, copied by the render thread whenever it opens
+    volatile LONG           Frequency;  // Of the endpoint, published to the API threads, none until it opens
+    BOOL                    Rebind;     // The endpoint opened again at another frequency, the playing voices are not bound yet
 
-    HANDLE                  Events[DSDEVICE_MAX_EVENT_COUNT];
+    HANDLE                  Close;
+    HANDLE                  Wake;       // Signaled by the commands posted to a suspended device
 
     HANDLE                  Thread;
     HANDLE                  ThreadEvent;
+
+    dsvt*                   Voices;     // Playing buffers, owned by the render thread
+
+    CRITICAL_SECTION        Lock;
+    DWORD                   Reserved;   // Rows of the voice table claimed by the buffers, guarded by the lock
+
+    BOOL                    Realtime;   // Render periods are checked for allocations and locks
+
+    HANDLE                  MemoryNotification;
+    ULONGLONG               MemoryCheckTime;
+    ULONGLONG               IdleTime;
+    BOOL                    IdleCompacted;
+
+    DWORD64                 SilentFrames;   // Rendered since the last buffer stopped
+    DWORD64                 SuspendFrames;  // Of silence before the endpoint is stopped, none to keep it running
+    volatile LONG           Suspended;
+    volatile LONG           Pressure;   // The memory ran low while voices played, the next post trims the allocator
+
+    volatile LONG64         Reclaimed;  // In bytes, released by compaction
 } dsdevice;
 
-HRESULT DELTACALL dsdevice_create(allocator* pAlloc, ds* pDS, device_info* pInfo, dsdevice** ppOut);
+HRESULT DELTACALL dsdevice_create(allocator* pAlloc, deltasound* pD, device_info* pInfo, dsdevice** ppOut);
 VOID DELTACALL dsdevice_release(dsdevice* pDev);
+
+// Claims a row of the voice table for a buffer before it is first played, growing the table when it is full.
+// The render thread moves the rows into the grown table, it never allocates one.
+HRESULT DELTACALL dsdevice_reserve_voice(dsdevice* pDev);
+VOID DELTACALL dsdevice_release_voice(dsdevice* pDev);
+
+HRESULT DELTACALL dsdevice_activate_buffer(dsdevice* pDev, dsb* pDSB);
+HRESULT DELTACALL dsdevice_deactivate_buffer(dsdevice* pDev, dsb* pDSB);
+
+// Posts the command to the render thread, and wakes it when it is suspended.
+// Fails with DSERR_NODRIVER once the render thread has stopped, after the endpoint was lost.
+HRESULT DELTACALL dsdevice_post(dsdevice* pDev, const dscmd* pcCommand);
+
+HRESULT DELTACALL dsdevice_compact(dsdevice* pDev);
+HRESULT DELTACALL dsdevice_get_latency(dsdevice* pDev, LPDWORD pdwMilliseconds, PDWORD64 pdwUnderruns);
+
+// Copies one of the DSTM_* timing histograms of the render thread, the build has to define DELTASOUND_TIMING.
+HRESULT DELTACALL dsdevice_get_timing(dsdevice* pDev, DWORD dwHistogram, dstm_histogram* pHistogram);
@@ -0,0 +1,145 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "dslc.h"
+
+#include <math.h>
+
+FLOAT DELTACALL dslc_follow(FLOAT fValue, FLOAT fSample);
+DWORD DELTACALL dslc_get_required_frames(dslc* pLC);
+
+HRESULT DELTACALL dslc_initialize(dslc* self, DWORD dwFrequency, DWORD dwPeriod, DWORD dwMinFrames, DWORD dwMaxFrames) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (dwFrequency == 0 || dwMinFrames == 0 || dwMaxFrames < dwMinFrames) {
+        return E_INVALIDARG;
+    }
+
+    ZeroMemory(self, sizeof(dslc));
+
+    self->Frequency = dwFrequency;
+    self->Period = dwPeriod;
+    self->MinFrames = dwMinFrames;
+    self->MaxFrames = dwMaxFrames;
+
+    QueryPerformanceFrequency(&self->TickFrequency);
+
+    self->Target = (LONG)max(dwMinFrames, min(dslc_get_required_frames(self), dwMaxFrames));
+
+    return S_OK;
+}
+
+VOID DELTACALL dslc_wake(dslc* self) {
+    LARGE_INTEGER now;
+
+    QueryPerformanceCounter(&now);
+
+    // Only a late wake-up eats into the fill, an early one leaves more of it.
+    if (self->Wake.QuadPart != 0) {
+        const FLOAT interval = (FLOAT)(now.QuadPart - self->Wake.QuadPart)
+            * self->Frequency / self->TickFrequency.QuadPart;
+
+        self->Lateness = dslc_follow(self->Lateness, max(interval - self->Period, 0.0f));
+    }
+
+    self->Wake = now;
+
+    self->Primed = self->Committed;
+    self->Committed = FALSE;
+}
+
+VOID DELTACALL dslc_reset(dslc* self) {
+    // The endpoint resumes empty, and the pause before the next wake-up is not lateness.
+    self->Wake.QuadPart = 0;
+
+    self->Primed = FALSE;
+    self->Committed = FALSE;
+}
+
+DWORD DELTACALL dslc_get_frames(dslc* self, DWORD dwPadding) {
+    const DWORD required = dslc_get_required_frames(self);
+    DWORD target = (DWORD)self->Target;
+
+    // The endpoint drained the frames written in the previous period before it was refilled.
+    if (self->Primed && dwPadding == 0) {
+        InterlockedIncrement64(&self->Underruns);
+
+        target = max(target + self->Period, required);
+        self->Hold = DSLC_HOLD_PERIODS;
+    }
+    else if (target < required) {
+        target = required;
+    }
+    else if (self->Hold != 0) {
+        self->Hold--;
+    }
+    else {
+        target -= (target - required) / DSLC_DECAY_RATE;
+    }
+
+    target = max(self->MinFrames, min(target, self->MaxFrames));
+
+    InterlockedExchange(&self->Target, (LONG)target);
+
+    return dwPadding < target ? target - dwPadding : 0;
+}
+
+VOID DELTACALL dslc_commit(dslc* self, DWORD dwFrames, LONGLONG llTicks) {
+    const FLOAT cost = (FLOAT)llTicks * self->Frequency / self->TickFrequency.QuadPart;
+
+    self->Cost = dslc_follow(self->Cost, cost);
+
+    if (dwFrames != 0) {
+        self->Committed = TRUE;
+    }
+}
+
+DWORD DELTACALL dslc_get_target(dslc* self) {
+    if (self == NULL) {
+        return 0;
+    }
+
+    return (DWORD)self->Target;
+}
+
+DWORD64 DELTACALL dslc_get_underrun_count(dslc* self) {
+    if (self == NULL) {
+        return 0;
+    }
+
+    return (DWORD64)self->Underruns;
+}
+
+/* ---------------------------------------------------------------------- */
+
+FLOAT DELTACALL dslc_follow(FLOAT fValue, FLOAT fSample) {
+    // Peaks are taken at once and released slowly, so that a single slow period is remembered for a while.
+    return fValue < fSample ? fSample : fValue + (fSample - fValue) / DSLC_RELEASE_RATE;
+}
+
+DWORD DELTACALL dslc_get_required_frames(dslc* self) {
+    return self->Period + (DWORD)ceilf(self->Lateness + self->Cost);
+}
@@ -0,0 +1,65 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "base.h"
+
+#define DSLC_HOLD_PERIODS       100     // Periods the target holds after an underrun before it decays
+#define DSLC_DECAY_RATE         64      // The target moves 1/64 of the way down to the required fill every period
+#define DSLC_RELEASE_RATE       64      // The measured lateness and cost fall back by 1/64 every period
+
+// The latency controller sets how far ahead of the endpoint the device thread mixes.
+// The required fill covers a device period, the peak lateness of the wake-ups and the peak cost of a mix,
+// the target follows it up at once and down slowly, and jumps by a period after every underrun.
+// The target and the underrun count are written by the device thread only, and read by the others.
+typedef struct dslc {
+    DWORD               Frequency;      // In frames per second
+    DWORD               Period;         // In frames
+    DWORD               MinFrames;
+    DWORD               MaxFrames;
+
+    LARGE_INTEGER       TickFrequency;
+    LARGE_INTEGER       Wake;
+
+    FLOAT               Lateness;       // In frames
+    FLOAT               Cost;           // In frames
+
+    BOOL                Committed;      // Frames were written in the current period
+    BOOL                Primed;         // Frames were written in the previous period
+    DWORD               Hold;
+
+    volatile LONG       Target;         // In frames
+    volatile LONG64     Underruns;
+} dslc;
+
+HRESULT DELTACALL dslc_initialize(dslc* pLC, DWORD dwFrequency, DWORD dwPeriod, DWORD dwMinFrames, DWORD dwMaxFrames);
+
+VOID DELTACALL dslc_wake(dslc* pLC);
+VOID DELTACALL dslc_reset(dslc* pLC);
+DWORD DELTACALL dslc_get_frames(dslc* pLC, DWORD dwPadding);
+VOID DELTACALL dslc_commit(dslc* pLC, DWORD dwFrames, LONGLONG llTicks);
+
+DWORD DELTACALL dslc_get_target(dslc* pLC);
+DWORD64 DELTACALL dslc_get_underrun_count(dslc* pLC);
@@ -22,7 +22,9 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include "ds.h"
 #include "dsb.h"
+#include "dsdevice.h"
 #include "dsn.h"
 
 HRESULT DELTACALL dsn_validate_notifications(dsn* pDSN, DWORD dwPositionNotifies, LPDSBPOSITIONNOTIFY pPositionNotifies);
@@ -136,16 +138,14 @@ HRESULT DELTACALL dsn_get_notification_positions(dsn* self, LPDWORD pdwPositionN
         return E_INVALIDARG;
     }
 
-    EnterCriticalSection(&self->Lock);
-
+    // The render thread reads the positions without the lock,
+    // they are replaced only once it no longer plays the buffer.
     *pdwPositionNotifies = self->NotificationCount;
 
     if (ppcPositionNotifies != NULL) {
         *ppcPositionNotifies = self->Notifications;
     }
 
-    LeaveCriticalSection(&self->Lock);
-
     return S_OK;
 }
 
@@ -154,7 +154,7 @@ HRESULT DELTACALL dsn_set_notification_positions(dsn* self, DWORD dwPositionNoti
         return DSERR_CONTROLUNAVAIL;
     }
 
-    if (self->Instance->Status & DSBSTATUS_PLAYING) {
+    if (self->Instance->State.Status & DSBSTATUS_PLAYING) {
         return DSERR_INVALIDCALL;
     }
 
@@ -175,6 +175,13 @@ HRESULT DELTACALL dsn_set_notification_positions(dsn* self, DWORD dwPositionNoti
         CopyMemory(notes, pcPositionNotifies, length);
 
         if (SUCCEEDED(hr = dsn_validate_notifications(self, dwPositionNotifies, notes))) {
+            ds* instance = self->Instance->Instance;
+
+            // The render thread triggers the notifications of the buffer until it applies the stop.
+            if (instance != NULL && instance->Device != NULL) {
+                dscq_flush(instance->Device->Commands);
+            }
+
             EnterCriticalSection(&self->Lock);
 
             if (self->Notifications != NULL) {
@@ -0,0 +1,290 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "dstm.h"
+
+#include <intrin.h>
+#include <stdio.h>
+
+#define MAX_REPORT_LENGTH   256
+
+typedef struct dstm_counters {
+    volatile LONG64 Count;
+    volatile LONG64 Total;
+    volatile LONG64 Max;
+    volatile LONG64 Buckets[DSTM_BUCKET_COUNT];
+} dstm_counters;
+
+struct dstm {
+    allocator*      Allocator;
+    LARGE_INTEGER   Frequency;
+    LONGLONG        Period;     // In ticks, expected between the wake-ups
+    LONGLONG        Wake;       // In ticks, none before the first wake-up
+    dstm_counters   Histograms[DSTM_HISTOGRAM_COUNT];
+};
+
+const static LPCSTR dstm_names[DSTM_HISTOGRAM_COUNT] = {
+    "gather",       // DSTM_GATHER
+    "read",         // DSTM_READ
+    "mix",          // DSTM_MIX
+    "output",       // DSTM_OUTPUT
+    "notify",       // DSTM_NOTIFY
+    "render",       // DSTM_RENDER
+    "late wake",    // DSTM_WAKE_LATE
+    "early wake"    // DSTM_WAKE_EARLY
+};
+
+DWORD DELTACALL dstm_get_bucket(DWORD64 dwlTicks);
+DWORD64 DELTACALL dstm_get_bucket_limit(DWORD dwBucket);
+DOUBLE DELTACALL dstm_to_microseconds(const dstm_histogram* pHistogram, DWORD64 dwlTicks);
+
+HRESULT DELTACALL dstm_create(allocator* pAlloc, dstm** ppOut) {
+    if (pAlloc == NULL || ppOut == NULL) {
+        return E_INVALIDARG;
+    }
+
+    HRESULT hr = S_OK;
+    dstm* instance = NULL;
+
+    if (SUCCEEDED(hr = allocator_allocate(pAlloc, sizeof(dstm), &instance))) {
+        instance->Allocator = pAlloc;
+
+        QueryPerformanceFrequency(&instance->Frequency);
+
+        *ppOut = instance;
+    }
+
+    return hr;
+}
+
+VOID DELTACALL dstm_release(dstm* self) {
+    if (self == NULL) { return; }
+
+    allocator_free(self->Allocator, self);
+}
+
+VOID DELTACALL dstm_set_period(dstm* self, DWORD dwFrequency, DWORD dwPeriod) {
+    if (self == NULL || dwFrequency == 0) {
+        return;
+    }
+
+    self->Period = (LONGLONG)dwPeriod * self->Frequency.QuadPart / dwFrequency;
+    self->Wake = 0;
+}
+
+VOID DELTACALL dstm_reset(dstm* self) {
+    if (self == NULL) {
+        return;
+    }
+
+    self->Wake = 0;
+}
+
+LONGLONG DELTACALL dstm_now(VOID) {
+    LARGE_INTEGER now;
+
+    QueryPerformanceCounter(&now);
+
+    return now.QuadPart;
+}
+
+VOID DELTACALL dstm_record(dstm* self, DWORD dwHistogram, LONGLONG llTicks) {
+    if (self == NULL || DSTM_HISTOGRAM_COUNT <= dwHistogram) {
+        return;
+    }
+
+    dstm_counters* counters = &self->Histograms[dwHistogram];
+    const LONG64 ticks = max(llTicks, 0);
+
+    InterlockedIncrementNoFence64(&counters->Buckets[dstm_get_bucket((DWORD64)ticks)]);
+    InterlockedIncrementNoFence64(&counters->Count);
+    InterlockedExchangeAddNoFence64(&counters->Total, ticks);
+
+    LONG64 peak = ReadNoFence64(&counters->Max);
+
+    while (peak < ticks) {
+        const LONG64 value = InterlockedCompareExchangeNoFence64(&counters->Max, ticks, peak);
+
+        if (value == peak) {
+            break;
+        }
+
+        peak = value;
+    }
+}
+
+VOID DELTACALL dstm_lap(dstm* self, DWORD dwHistogram, LONGLONG* pllMark) {
+    const LONGLONG now = dstm_now();
+
+    dstm_record(self, dwHistogram, now - *pllMark);
+
+    *pllMark = now;
+}
+
+VOID DELTACALL dstm_wake(dstm* self) {
+    if (self == NULL) {
+        return;
+    }
+
+    const LONGLONG now = dstm_now();
+
+    if (self->Wake != 0 && self->Period != 0) {
+        const LONGLONG deviation = now - self->Wake - self->Period;
+
+        if (0 <= deviation) {
+            dstm_record(self, DSTM_WAKE_LATE, deviation);
+        }
+        else {
+            dstm_record(self, DSTM_WAKE_EARLY, -deviation);
+        }
+    }
+
+    self->Wake = now;
+}
+
+HRESULT DELTACALL dstm_get_histogram(dstm* self, DWORD dwHistogram, dstm_histogram* pHistogram) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (DSTM_HISTOGRAM_COUNT <= dwHistogram || pHistogram == NULL) {
+        return E_INVALIDARG;
+    }
+
+    dstm_counters* counters = &self->Histograms[dwHistogram];
+
+    pHistogram->Frequency = (DWORD64)self->Frequency.QuadPart;
+    pHistogram->Count = (DWORD64)ReadNoFence64(&counters->Count);
+    pHistogram->Total = (DWORD64)ReadNoFence64(&counters->Total);
+    pHistogram->Max = (DWORD64)ReadNoFence64(&counters->Max);
+
+    for (DWORD i = 0; i < DSTM_BUCKET_COUNT; i++) {
+        pHistogram->Buckets[i] = (DWORD64)ReadNoFence64(&counters->Buckets[i]);
+    }
+
+    return S_OK;
+}
+
+DWORD64 DELTACALL dstm_get_quantile(const dstm_histogram* pHistogram, DWORD dwPermille) {
+    if (pHistogram == NULL || pHistogram->Count == 0) {
+        return 0;
+    }
+
+    // The buckets are read one by one while they are written, so their sum may differ from the count.
+    DWORD64 total = 0;
+
+    for (DWORD i = 0; i < DSTM_BUCKET_COUNT; i++) {
+        total += pHistogram->Buckets[i];
+    }
+
+    const DWORD64 rank = (total * min(dwPermille, 1000) + 999) / 1000;
+    DWORD64 count = 0;
+
+    // The upper bound of the bucket is reported, so that the quantile is never understated.
+    for (DWORD i = 0; i < DSTM_BUCKET_COUNT; i++) {
+        count += pHistogram->Buckets[i];
+
+        if (rank <= count && count != 0) {
+            return min(dstm_get_bucket_limit(i), pHistogram->Max);
+        }
+    }
+
+    return pHistogram->Max;
+}
+
+HRESULT DELTACALL dstm_dump(dstm* self) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    dstm_histogram histogram;
+    CHAR line[MAX_REPORT_LENGTH];
+
+    for (DWORD i = 0; i < DSTM_HISTOGRAM_COUNT; i++) {
+        dstm_get_histogram(self, i, &histogram);
+
+        if (histogram.Count == 0) {
+            continue;
+        }
+
+        snprintf(line, MAX_REPORT_LENGTH, "DeltaSound: %s %llu time(s), mean %.1f us, "
+            "median %.1f us, 99%% %.1f us, 99.9%% %.1f us, max %.1f us.\r\n",
+            dstm_names[i], histogram.Count,
+            dstm_to_microseconds(&histogram, histogram.Total) / histogram.Count,
+            dstm_to_microseconds(&histogram, dstm_get_quantile(&histogram, 500)),
+            dstm_to_microseconds(&histogram, dstm_get_quantile(&histogram, 990)),
+            dstm_to_microseconds(&histogram, dstm_get_quantile(&histogram, 999)),
+            dstm_to_microseconds(&histogram, histogram.Max));
+
+        OutputDebugStringA(line);
+    }
+
+    return S_OK;
+}
+
+/* ---------------------------------------------------------------------- */
+
+DWORD DELTACALL dstm_get_bucket(DWORD64 dwlTicks) {
+    if (dwlTicks < DSTM_SUB_BUCKET_COUNT) {
+        return (DWORD)dwlTicks;
+    }
+
+    DWORD bit = 0;
+
+    if (!_BitScanReverse(&bit, (DWORD)(dwlTicks >> 32))) {
+        _BitScanReverse(&bit, (DWORD)dwlTicks);
+    }
+    else {
+        bit += 32;
+    }
+
+    if (DSTM_MAX_BITS <= bit) {
+        return DSTM_BUCKET_COUNT - 1;
+    }
+
+    // The bits below the leading one select the linear bucket within its power of two.
+    return (bit - DSTM_SUB_BUCKET_BITS + 1) * DSTM_SUB_BUCKET_COUNT
+        + (DWORD)((dwlTicks >> (bit - DSTM_SUB_BUCKET_BITS)) & (DSTM_SUB_BUCKET_COUNT - 1));
+}
+
+DWORD64 DELTACALL dstm_get_bucket_limit(DWORD dwBucket) {
+    if (DSTM_BUCKET_COUNT - 1 <= dwBucket) {
+        return ~(DWORD64)0;
+    }
+
+    const DWORD next = dwBucket + 1;
+
+    if (next < DSTM_SUB_BUCKET_COUNT) {
+        return next - 1;
+    }
+
+    const DWORD64 start = (DWORD64)(DSTM_SUB_BUCKET_COUNT + next % DSTM_SUB_BUCKET_COUNT)
+        << (next / DSTM_SUB_BUCKET_COUNT - 1);
+
+    return start - 1;
+}
+
+DOUBLE DELTACALL dstm_to_microseconds(const dstm_histogram* pHistogram, DWORD64 dwlTicks) {
+    return pHistogram->Frequency == 0 ? 0.0 : (DOUBLE)dwlTicks * 1000000.0 / (DOUBLE)pHistogram->Frequency;
+}
@@ -0,0 +1,101 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "allocator.h"
+
+// The render timing is measured in builds that define DELTASOUND_TIMING as nonzero, debug builds by default.
+// Otherwise the measurement macros expand to nothing, and the render thread reads no clock for them.
+#ifndef DELTASOUND_TIMING
+#ifdef _DEBUG
+#define DELTASOUND_TIMING       1
+#else
+#define DELTASOUND_TIMING       0
+#endif
+#endif
+
+#define DSTM_GATHER             0   // Listing of the voices to mix
+#define DSTM_READ               1   // Reading of the buffers
+#define DSTM_MIX                2   // Voice kernels, which convert, resample, attenuate and accumulate in one pass
+#define DSTM_OUTPUT             3   // Conversion of the mix to the format of the endpoint
+#define DSTM_NOTIFY             4   // Position updates and notifications of the buffers
+#define DSTM_RENDER             5   // Whole period, from the acquisition of the endpoint buffer to its release
+#define DSTM_WAKE_LATE          6   // How much longer than a device period the wait of the render thread took
+#define DSTM_WAKE_EARLY         7   // How much shorter than a device period the wait of the render thread took
+
+#define DSTM_HISTOGRAM_COUNT    8
+
+// Durations, in ticks of the performance counter, are counted in log-linear buckets.
+// Every power of two is split into 8 buckets, each within 12.5% of the durations it counts,
+// and the durations of 2^40 ticks and longer are counted in the last bucket.
+#define DSTM_SUB_BUCKET_BITS    3
+#define DSTM_SUB_BUCKET_COUNT   (1 << DSTM_SUB_BUCKET_BITS)
+#define DSTM_MAX_BITS           40
+#define DSTM_BUCKET_COUNT       ((DSTM_MAX_BITS - DSTM_SUB_BUCKET_BITS + 1) * DSTM_SUB_BUCKET_COUNT)
+
+// The timing histograms of a device. They are written by the render thread without locks,
+// and can be read by any thread while the device plays.
+typedef struct dstm dstm;
+
+typedef struct dstm_histogram {
+    DWORD64     Frequency;  // Of the performance counter, in ticks per second
+    DWORD64     Count;
+    DWORD64     Total;      // In ticks
+    DWORD64     Max;        // In ticks
+    DWORD64     Buckets[DSTM_BUCKET_COUNT];
+} dstm_histogram;
+
+HRESULT DELTACALL dstm_create(allocator* pAlloc, dstm** ppOut);
+VOID DELTACALL dstm_release(dstm* pTM);
+
+// Sets the device period the wake-ups are measured against, in frames at the frequency of the endpoint.
+VOID DELTACALL dstm_set_period(dstm* pTM, DWORD dwFrequency, DWORD dwPeriod);
+
+// Forgets the last wake-up, so that the pause of a suspended device is not measured.
+VOID DELTACALL dstm_reset(dstm* pTM);
+
+LONGLONG DELTACALL dstm_now(VOID);
+VOID DELTACALL dstm_record(dstm* pTM, DWORD dwHistogram, LONGLONG llTicks);
+VOID DELTACALL dstm_lap(dstm* pTM, DWORD dwHistogram, LONGLONG* pllMark);
+VOID DELTACALL dstm_wake(dstm* pTM);
+
+HRESULT DELTACALL dstm_get_histogram(dstm* pTM, DWORD dwHistogram, dstm_histogram* pHistogram);
+// Returns the duration, in ticks, that the given thousandths of the recorded durations do not exceed.
+DWORD64 DELTACALL dstm_get_quantile(const dstm_histogram* pHistogram, DWORD dwPermille);
+HRESULT DELTACALL dstm_dump(dstm* pTM);
+
+#if DELTASOUND_TIMING
+#define DSTM_START(M)           LONGLONG M = dstm_now()
+#define DSTM_LAP(T, H, M)       dstm_lap(T, H, &M)
+#define DSTM_RECORD(T, H, X)    dstm_record(T, H, X)
+#define DSTM_WAKE(T)            dstm_wake(T)
+#define DSTM_RESET(T)           dstm_reset(T)
+#else
+#define DSTM_START(M)
+#define DSTM_LAP(T, H, M)
+#define DSTM_RECORD(T, H, X)
+#define DSTM_WAKE(T)
+#define DSTM_RESET(T)
+#endif
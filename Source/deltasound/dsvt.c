@@ -0,0 +1,248 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "dsb.h"
+#include "dsvt.h"
+
+#include <math.h>
+
+#define ALIGN(X)    (((X) + ALLOCATOR_CACHE_LINE_SIZE - 1) & ~((size_t)ALLOCATOR_CACHE_LINE_SIZE - 1))
+
+// The rows are invalidated with an odd sequence, the buffer state is published only with even ones.
+#define DSVT_STALE_SEQUENCE ((LONG)-1)
+
+// Places the column at the offset in the memory and moves the existing rows into it.
+// Without the memory only the offset is advanced, which measures the table.
+#define COLUMN(SELF, NAME, MEMORY, CAPACITY, OFFSET)                                \
+    {                                                                               \
+        if ((MEMORY) != NULL) {                                                     \
+            LPVOID column = (LPVOID)((size_t)(MEMORY) + (OFFSET));                  \
+                                                                                    \
+            if ((SELF)->NAME != NULL) {                                             \
+                CopyMemory(column, (SELF)->NAME, (SELF)->Count * sizeof(*(SELF)->NAME)); \
+            }                                                                       \
+                                                                                    \
+            (SELF)->NAME = column;                                                  \
+        }                                                                           \
+                                                                                    \
+        (OFFSET) += ALIGN((CAPACITY) * sizeof(*(SELF)->NAME));                      \
+    }
+
+size_t DELTACALL dsvt_layout(dsvt* pTable, LPVOID pMemory, DWORD dwCapacity);
+
+HRESULT DELTACALL dsvt_create(allocator* pAlloc, DWORD dwCapacity, dsvt** ppOut) {
+    if (pAlloc == NULL || dwCapacity == 0 || ppOut == NULL) {
+        return E_INVALIDARG;
+    }
+
+    HRESULT hr = S_OK;
+    dsvt* instance = NULL;
+
+    if (SUCCEEDED(hr = allocator_allocate(pAlloc, sizeof(dsvt), &instance))) {
+        instance->Allocator = pAlloc;
+
+        LPVOID memory = NULL;
+
+        if (SUCCEEDED(hr = dsvt_allocate(instance, dwCapacity, &memory))) {
+            dsvt_move(instance, memory, dwCapacity);
+
+            *ppOut = instance;
+
+            return S_OK;
+        }
+
+        allocator_free(pAlloc, instance);
+    }
+
+    return hr;
+}
+
+VOID DELTACALL dsvt_release(dsvt* self) {
+    if (self == NULL) { return; }
+
+    dsvt_free(self, self->Memory);
+
+    allocator_free(self->Allocator, self);
+}
+
+HRESULT DELTACALL dsvt_allocate(dsvt* self, DWORD dwCapacity, LPVOID* ppMemory) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (dwCapacity == 0 || ppMemory == NULL) {
+        return E_INVALIDARG;
+    }
+
+    const size_t size = dsvt_layout(self, NULL, dwCapacity);
+
+    if (MAXDWORD < size) {
+        return E_OUTOFMEMORY;
+    }
+
+    return allocator_allocate_aligned(self->Allocator, (DWORD)size, ALLOCATOR_CACHE_LINE_SIZE, ppMemory);
+}
+
+HRESULT DELTACALL dsvt_move(dsvt* self, LPVOID pMemory, DWORD dwCapacity) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (pMemory == NULL || dwCapacity < self->Count) {
+        return E_INVALIDARG;
+    }
+
+    dsvt_layout(self, pMemory, dwCapacity);
+
+    self->Memory = pMemory;
+    self->Capacity = dwCapacity;
+
+    return S_OK;
+}
+
+VOID DELTACALL dsvt_free(dsvt* self, LPVOID pMemory) {
+    if (self == NULL || pMemory == NULL) { return; }
+
+    allocator_free_aligned(self->Allocator, pMemory);
+}
+
+HRESULT DELTACALL dsvt_add_voice(dsvt* self, dsb* pDSB, dsbcb* pBuffer, LPDWORD pdwIndex) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (pDSB == NULL || pBuffer == NULL || pdwIndex == NULL) {
+        return E_INVALIDARG;
+    }
+
+    // Growing the table allocates, which the render thread must not do.
+    if (self->Count == self->Capacity) {
+        return E_OUTOFMEMORY;
+    }
+
+    const DWORD index = self->Count;
+
+    self->Buffers[index] = pDSB;
+    self->Cursors[index] = pBuffer;
+    self->Sequences[index] = DSVT_STALE_SEQUENCE;
+    self->Play[index] = DSBPLAY_NONE;
+    self->Status[index] = DSBSTATUS_NONE;
+    self->Flags[index] = DSVT_VOICE_NONE;
+    self->Alignments[index] = 0;
+    self->Lengths[index] = 0;
+    self->Channels[index] = 0;
+    self->Frequencies[index] = 0;
+    self->Phases[index] = 0.0f;
+    self->Left[index] = 0.0f;
+    self->Right[index] = 0.0f;
+    self->Voices[index] = NULL;
+
+    self->Count++;
+
+    *pdwIndex = index;
+
+    return S_OK;
+}
+
+HRESULT DELTACALL dsvt_remove_voice(dsvt* self, DWORD dwIndex, dsb** ppMoved) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (self->Count <= dwIndex || ppMoved == NULL) {
+        return E_INVALIDARG;
+    }
+
+    self->Count--;
+
+    const DWORD last = self->Count;
+
+    if (dwIndex == last) {
+        *ppMoved = NULL;
+
+        return S_OK;
+    }
+
+    self->Buffers[dwIndex] = self->Buffers[last];
+    self->Cursors[dwIndex] = self->Cursors[last];
+    self->Sequences[dwIndex] = self->Sequences[last];
+    self->Play[dwIndex] = self->Play[last];
+    self->Status[dwIndex] = self->Status[last];
+    self->Flags[dwIndex] = self->Flags[last];
+    self->Alignments[dwIndex] = self->Alignments[last];
+    self->Lengths[dwIndex] = self->Lengths[last];
+    self->Channels[dwIndex] = self->Channels[last];
+    self->Frequencies[dwIndex] = self->Frequencies[last];
+    self->Phases[dwIndex] = self->Phases[last];
+    self->Left[dwIndex] = self->Left[last];
+    self->Right[dwIndex] = self->Right[last];
+    self->Voices[dwIndex] = self->Voices[last];
+
+    *ppMoved = self->Buffers[dwIndex];
+
+    return S_OK;
+}
+
+HRESULT DELTACALL dsvt_set_gains(dsvt* self, DWORD dwIndex, FLOAT fVolume, FLOAT fPan) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (self->Count <= dwIndex
+        || _isnan(fVolume) || fVolume < 0.0f || fVolume > 1.0f
+        || _isnan(fPan) || fPan < -1.0f || fPan > 1.0f) {
+        return E_INVALIDARG;
+    }
+
+    // Positive pan = attenuation of left channel.
+    self->Left[dwIndex] = fVolume * (fPan > 0.0f ? (1.0f - fPan) : 1.0f);
+
+    // Negative pan = attenuation of right channel.
+    self->Right[dwIndex] = fVolume * (fPan < 0.0f ? (1.0f + fPan) : 1.0f);
+
+    return S_OK;
+}
+
+/* ---------------------------------------------------------------------- */
+
+size_t DELTACALL dsvt_layout(dsvt* self, LPVOID pMemory, DWORD dwCapacity) {
+    size_t offset = 0;
+
+    COLUMN(self, Buffers, pMemory, dwCapacity, offset);
+    COLUMN(self, Cursors, pMemory, dwCapacity, offset);
+    COLUMN(self, Sequences, pMemory, dwCapacity, offset);
+    COLUMN(self, Play, pMemory, dwCapacity, offset);
+    COLUMN(self, Status, pMemory, dwCapacity, offset);
+    COLUMN(self, Flags, pMemory, dwCapacity, offset);
+    COLUMN(self, Alignments, pMemory, dwCapacity, offset);
+    COLUMN(self, Lengths, pMemory, dwCapacity, offset);
+    COLUMN(self, Channels, pMemory, dwCapacity, offset);
+    COLUMN(self, Frequencies, pMemory, dwCapacity, offset);
+    COLUMN(self, Phases, pMemory, dwCapacity, offset);
+    COLUMN(self, Left, pMemory, dwCapacity, offset);
+    COLUMN(self, Right, pMemory, dwCapacity, offset);
+    COLUMN(self, Voices, pMemory, dwCapacity, offset);
+
+    return offset;
+}
@@ -0,0 +1,74 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "dsbcb.h"
+#include "kernel.h"
+
+#define DSVT_VOICE_NONE     0
+#define DSVT_VOICE_PRIMARY  1
+#define DSVT_VOICE_CACHE    2
+#define DSVT_VOICE_NOTIFY   4
+
+typedef struct dsb dsb;
+
+// The state of the playing buffers the render thread reads every period, one column per field.
+// Each column starts on its own cache line, and the rows are kept dense by moving the last row into a removed one.
+// The table is owned by the render thread, it is grown by the API threads with memory they allocate and it moves the rows into.
+typedef struct dsvt {
+    allocator*      Allocator;
+    LPVOID          Memory;
+
+    DWORD           Count;
+    DWORD           Capacity;
+
+    dsb**           Buffers;
+    dsbcb**         Cursors;
+    LONG*           Sequences;      // Of the buffer state the row reflects
+    DWORD*          Play;
+    DWORD*          Status;
+    DWORD*          Flags;
+    DWORD*          Alignments;     // In bytes
+    DWORD*          Lengths;        // In bytes
+    DWORD*          Channels;
+    DWORD*          Frequencies;
+    FLOAT*          Phases;         // The fraction of an input frame carried over to the next period
+    FLOAT*          Left;
+    FLOAT*          Right;
+    LPKERNELVOICE*  Voices;
+} dsvt;
+
+HRESULT DELTACALL dsvt_create(allocator* pAlloc, DWORD dwCapacity, dsvt** ppOut);
+VOID DELTACALL dsvt_release(dsvt* pTable);
+
+HRESULT DELTACALL dsvt_allocate(dsvt* pTable, DWORD dwCapacity, LPVOID* ppMemory);
+HRESULT DELTACALL dsvt_move(dsvt* pTable, LPVOID pMemory, DWORD dwCapacity);
+VOID DELTACALL dsvt_free(dsvt* pTable, LPVOID pMemory);
+
+// Fails with E_OUTOFMEMORY when the table is full, the rows are reserved before the buffers are played.
+HRESULT DELTACALL dsvt_add_voice(dsvt* pTable, dsb* pDSB, dsbcb* pBuffer, LPDWORD pdwIndex);
+HRESULT DELTACALL dsvt_remove_voice(dsvt* pTable, DWORD dwIndex, dsb** ppMoved);
+
+HRESULT DELTACALL dsvt_set_gains(dsvt* pTable, DWORD dwIndex, FLOAT fVolume, FLOAT fPan);
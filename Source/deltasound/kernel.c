@@ -0,0 +1,478 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "cpu.h"
+#include "kernel.h"
+
+typedef union kernel_bits {
+    FLOAT   Value;
+    DWORD   Bits;
+} kernel_bits;
+
+FLOAT DELTACALL kernel_half_to_float(WORD wValue);
+WORD DELTACALL kernel_float_to_half(FLOAT fValue);
+FLOAT DELTACALL kernel_get_output_sample(const FLOAT* pInput, DWORD dwFrame, DWORD dwChannels, DWORD dwChannel);
+LONG DELTACALL kernel_quantize(FLOAT fValue, DOUBLE dScale);
+
+HRESULT DELTACALL kernel_initialize(kernel* self, DWORD dwFeatures) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    self->Tier = KERNEL_TIER_SCALAR;
+
+    self->Encode[KERNEL_ENCODE_U8] = kernel_encode_u8;
+    self->Encode[KERNEL_ENCODE_S16] = kernel_encode_s16;
+
+    self->Output[KERNEL_OUTPUT_F32] = kernel_output_f32;
+    self->Output[KERNEL_OUTPUT_S16] = kernel_output_s16;
+    self->Output[KERNEL_OUTPUT_S24] = kernel_output_s24;
+    self->Output[KERNEL_OUTPUT_S32] = kernel_output_s32;
+
+    const LPKERNELVOICE(*voices)[KERNEL_MAX_RESAMPLER_COUNT] = kernel_voices_scalar;
+
+    // Each tier is built on top of the tier below, so the tiers are only enabled in order.
+#if defined(_M_IX86) || defined(_M_X64)
+    if (dwFeatures & CPU_FEATURE_SSE2) {
+        self->Tier = KERNEL_TIER_SSE2;
+        voices = kernel_voices_sse2;
+    }
+
+    if (self->Tier == KERNEL_TIER_SSE2 && (dwFeatures & CPU_FEATURE_SSE41)) {
+        self->Tier = KERNEL_TIER_SSE41;
+        voices = kernel_voices_sse41;
+    }
+
+    if (self->Tier == KERNEL_TIER_SSE41 && (dwFeatures & CPU_FEATURE_AVX2)
+        && (dwFeatures & CPU_FEATURE_FMA) && (dwFeatures & CPU_FEATURE_F16C)) {
+        self->Tier = KERNEL_TIER_AVX2;
+        voices = kernel_voices_avx2;
+
+        self->Encode[KERNEL_ENCODE_U8] = kernel_encode_u8_avx2;
+        self->Encode[KERNEL_ENCODE_S16] = kernel_encode_s16_avx2;
+    }
+
+    if (self->Tier == KERNEL_TIER_AVX2 && (dwFeatures & CPU_FEATURE_AVX512)) {
+        self->Tier = KERNEL_TIER_AVX512;
+        voices = kernel_voices_avx512;
+    }
+#endif
+
+    CopyMemory(self->Voice, voices, sizeof(self->Voice));
+
+    return S_OK;
+}
+
+HRESULT DELTACALL kernel_get_format(LPCWAVEFORMATEX pcfxFormat, LPDWORD pdwFormat) {
+    if (pcfxFormat == NULL || pdwFormat == NULL) {
+        return E_INVALIDARG;
+    }
+
+    if (pcfxFormat->wBitsPerSample != 8 && pcfxFormat->wBitsPerSample != 16) {
+        return E_NOTIMPL;
+    }
+
+    if (pcfxFormat->nChannels != 1 && pcfxFormat->nChannels != 2) {
+        return E_NOTIMPL;
+    }
+
+    *pdwFormat = (pcfxFormat->wBitsPerSample == 8 ? KERNEL_FORMAT_U8_MONO : KERNEL_FORMAT_S16_MONO)
+        + (pcfxFormat->nChannels - 1);
+
+    return S_OK;
+}
+
+HRESULT DELTACALL kernel_get_half_format(LPCWAVEFORMATEX pcfxFormat, LPDWORD pdwFormat) {
+    if (pcfxFormat == NULL || pdwFormat == NULL) {
+        return E_INVALIDARG;
+    }
+
+    HRESULT hr = S_OK;
+    DWORD format = 0;
+
+    if (SUCCEEDED(hr = kernel_get_format(pcfxFormat, &format))) {
+        *pdwFormat = KERNEL_FORMAT_F16_MONO + (pcfxFormat->nChannels - 1);
+    }
+
+    return hr;
+}
+
+HRESULT DELTACALL kernel_get_voice(kernel* self,
+    DWORD dwFormat, DWORD dwFrequency, DWORD dwDeviceFrequency, LPKERNELVOICE* ppVoice) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (KERNEL_MAX_FORMAT_COUNT <= dwFormat
+        || dwFrequency == 0 || dwDeviceFrequency == 0 || ppVoice == NULL) {
+        return E_INVALIDARG;
+    }
+
+    const DWORD resampler = dwFrequency == dwDeviceFrequency
+        ? KERNEL_RESAMPLER_COPY : KERNEL_RESAMPLER_LINEAR;
+
+    *ppVoice = self->Voice[dwFormat][resampler];
+
+    return S_OK;
+}
+
+HRESULT DELTACALL kernel_get_encoder(kernel* self, LPCWAVEFORMATEX pcfxFormat, LPKERNELENCODE* ppEncode) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (ppEncode == NULL) {
+        return E_INVALIDARG;
+    }
+
+    HRESULT hr = S_OK;
+    DWORD format = 0;
+
+    if (SUCCEEDED(hr = kernel_get_format(pcfxFormat, &format))) {
+        *ppEncode = self->Encode[pcfxFormat->wBitsPerSample == 8 ? KERNEL_ENCODE_U8 : KERNEL_ENCODE_S16];
+    }
+
+    return hr;
+}
+
+HRESULT DELTACALL kernel_get_output(kernel* self, PWAVEFORMATEXTENSIBLE pwfxFormat, LPKERNELOUTPUT* ppOutput) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (pwfxFormat == NULL || ppOutput == NULL) {
+        return E_INVALIDARG;
+    }
+
+    const WORD tag = pwfxFormat->Format.wFormatTag;
+    const WORD bits = pwfxFormat->Format.wBitsPerSample;
+
+    const BOOL extensible = tag == WAVE_FORMAT_EXTENSIBLE;
+
+    if (tag == WAVE_FORMAT_IEEE_FLOAT
+        || (extensible && IsEqualGUID(&pwfxFormat->SubFormat, &KSDATAFORMAT_SUBTYPE_IEEE_FLOAT))) {
+        if (bits != 32) {
+            return E_NOTIMPL;
+        }
+
+        *ppOutput = self->Output[KERNEL_OUTPUT_F32];
+
+        return S_OK;
+    }
+
+    if (tag != WAVE_FORMAT_PCM
+        && (!extensible || !IsEqualGUID(&pwfxFormat->SubFormat, &KSDATAFORMAT_SUBTYPE_PCM))) {
+        return E_NOTIMPL;
+    }
+
+    // The samples with fewer valid bits than the container are written at the full range of the container.
+    switch (bits) {
+    case 16:
+        *ppOutput = self->Output[KERNEL_OUTPUT_S16];
+        return S_OK;
+    case 24:
+        *ppOutput = self->Output[KERNEL_OUTPUT_S24];
+        return S_OK;
+    case 32:
+        *ppOutput = self->Output[KERNEL_OUTPUT_S32];
+        return S_OK;
+    }
+
+    return E_NOTIMPL;
+}
+
+VOID DELTACALL kernel_convert_u8_mono(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput) {
+    const BYTE* input = (const BYTE*)pInput;
+
+    for (DWORD i = 0; i < dwFrames; i++) {
+        const FLOAT v = ((FLOAT)input[i] - 128.0f) * KERNEL_U8_SCALE;
+
+        pOutput[i * KERNEL_CHANNELS + 0] = v;
+        pOutput[i * KERNEL_CHANNELS + 1] = v;
+    }
+}
+
+VOID DELTACALL kernel_convert_u8_stereo(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput) {
+    const BYTE* input = (const BYTE*)pInput;
+
+    for (DWORD i = 0; i < dwFrames * KERNEL_CHANNELS; i++) {
+        pOutput[i] = ((FLOAT)input[i] - 128.0f) * KERNEL_U8_SCALE;
+    }
+}
+
+VOID DELTACALL kernel_convert_s16_mono(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput) {
+    const SHORT* input = (const SHORT*)pInput;
+
+    for (DWORD i = 0; i < dwFrames; i++) {
+        const FLOAT v = (FLOAT)input[i] * KERNEL_S16_SCALE;
+
+        pOutput[i * KERNEL_CHANNELS + 0] = v;
+        pOutput[i * KERNEL_CHANNELS + 1] = v;
+    }
+}
+
+VOID DELTACALL kernel_convert_s16_stereo(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput) {
+    const SHORT* input = (const SHORT*)pInput;
+
+    for (DWORD i = 0; i < dwFrames * KERNEL_CHANNELS; i++) {
+        pOutput[i] = (FLOAT)input[i] * KERNEL_S16_SCALE;
+    }
+}
+
+VOID DELTACALL kernel_convert_f16_mono(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput) {
+    const WORD* input = (const WORD*)pInput;
+
+    for (DWORD i = 0; i < dwFrames; i++) {
+        const FLOAT v = kernel_half_to_float(input[i]);
+
+        pOutput[i * KERNEL_CHANNELS + 0] = v;
+        pOutput[i * KERNEL_CHANNELS + 1] = v;
+    }
+}
+
+VOID DELTACALL kernel_convert_f16_stereo(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput) {
+    const WORD* input = (const WORD*)pInput;
+
+    for (DWORD i = 0; i < dwFrames * KERNEL_CHANNELS; i++) {
+        pOutput[i] = kernel_half_to_float(input[i]);
+    }
+}
+
+VOID DELTACALL kernel_resample(const FLOAT* pInput, DWORD dwInputFrames,
+    FLOAT* pOutput, DWORD dwOutputFrames, FLOAT fRatio, FLOAT fPhase) {
+    if (dwInputFrames == 0) {
+        return;
+    }
+
+    const DWORD last = dwInputFrames - 1;
+
+    for (DWORD i = 0; i < dwOutputFrames; i++) {
+        const FLOAT t = fPhase + i * fRatio;
+
+        const DWORD index = (DWORD)t;
+        const FLOAT fraction = t - (FLOAT)index;
+
+        const DWORD index0 = min(index, last);
+        const DWORD index1 = min(index + 1, last);
+
+        for (DWORD j = 0; j < KERNEL_CHANNELS; j++) {
+            const FLOAT y0 = pInput[index0 * KERNEL_CHANNELS + j];
+            const FLOAT y1 = pInput[index1 * KERNEL_CHANNELS + j];
+
+            pOutput[i * KERNEL_CHANNELS + j] = y0 + (y1 - y0) * fraction;
+        }
+    }
+}
+
+VOID DELTACALL kernel_accumulate(const FLOAT* pInput, DWORD dwFrames,
+    FLOAT fLeft, FLOAT fRight, FLOAT* pOutput) {
+    for (DWORD i = 0; i < dwFrames; i++) {
+        pOutput[i * KERNEL_CHANNELS + 0] += pInput[i * KERNEL_CHANNELS + 0] * fLeft;
+        pOutput[i * KERNEL_CHANNELS + 1] += pInput[i * KERNEL_CHANNELS + 1] * fRight;
+    }
+}
+
+VOID DELTACALL kernel_pad(FLOAT* pBuffer, DWORD dwFrames) {
+    for (DWORD i = dwFrames * KERNEL_CHANNELS; i < KERNEL_PADDED_FRAMES(dwFrames) * KERNEL_CHANNELS; i++) {
+        pBuffer[i] = 0.0f;
+    }
+}
+
+VOID DELTACALL kernel_encode_u8(LPCVOID pInput, DWORD dwSamples, WORD* pOutput) {
+    const BYTE* input = (const BYTE*)pInput;
+
+    for (DWORD i = 0; i < dwSamples; i++) {
+        pOutput[i] = kernel_float_to_half(((FLOAT)input[i] - 128.0f) * KERNEL_U8_SCALE);
+    }
+}
+
+VOID DELTACALL kernel_encode_s16(LPCVOID pInput, DWORD dwSamples, WORD* pOutput) {
+    const SHORT* input = (const SHORT*)pInput;
+
+    for (DWORD i = 0; i < dwSamples; i++) {
+        pOutput[i] = kernel_float_to_half((FLOAT)input[i] * KERNEL_S16_SCALE);
+    }
+}
+
+VOID DELTACALL kernel_output_f32(const FLOAT* pInput, DWORD dwFrames, DWORD dwChannels, LPVOID pOutput) {
+    FLOAT* output = (FLOAT*)pOutput;
+
+    if (dwChannels == KERNEL_CHANNELS) {
+        CopyMemory(pOutput, pInput, dwFrames * KERNEL_CHANNELS * sizeof(FLOAT));
+        return;
+    }
+
+    if (dwChannels == 1) {
+        for (DWORD i = 0; i < dwFrames; i++) {
+            output[i] = (pInput[i * KERNEL_CHANNELS + 0] + pInput[i * KERNEL_CHANNELS + 1]) * 0.5f;
+        }
+
+        return;
+    }
+
+    // Front left and right speakers receive the mix, the rest of the channels are silent.
+    for (DWORD i = 0; i < dwFrames; i++) {
+        FLOAT* frame = &output[i * dwChannels];
+
+        frame[0] = pInput[i * KERNEL_CHANNELS + 0];
+        frame[1] = pInput[i * KERNEL_CHANNELS + 1];
+
+        for (DWORD j = KERNEL_CHANNELS; j < dwChannels; j++) {
+            frame[j] = 0.0f;
+        }
+    }
+}
+
+VOID DELTACALL kernel_output_s16(const FLOAT* pInput, DWORD dwFrames, DWORD dwChannels, LPVOID pOutput) {
+    SHORT* output = (SHORT*)pOutput;
+
+    for (DWORD i = 0; i < dwFrames; i++) {
+        for (DWORD j = 0; j < dwChannels; j++) {
+            output[i * dwChannels + j] = (SHORT)kernel_quantize(
+                kernel_get_output_sample(pInput, i, dwChannels, j), KERNEL_S16_MAX);
+        }
+    }
+}
+
+VOID DELTACALL kernel_output_s24(const FLOAT* pInput, DWORD dwFrames, DWORD dwChannels, LPVOID pOutput) {
+    BYTE* output = (BYTE*)pOutput;
+
+    for (DWORD i = 0; i < dwFrames; i++) {
+        for (DWORD j = 0; j < dwChannels; j++) {
+            const LONG value = kernel_quantize(kernel_get_output_sample(pInput, i, dwChannels, j), KERNEL_S24_MAX);
+            BYTE* sample = &output[(i * dwChannels + j) * 3];
+
+            sample[0] = (BYTE)(value & 0xFF);
+            sample[1] = (BYTE)((value >> 8) & 0xFF);
+            sample[2] = (BYTE)((value >> 16) & 0xFF);
+        }
+    }
+}
+
+VOID DELTACALL kernel_output_s32(const FLOAT* pInput, DWORD dwFrames, DWORD dwChannels, LPVOID pOutput) {
+    LONG* output = (LONG*)pOutput;
+
+    for (DWORD i = 0; i < dwFrames; i++) {
+        for (DWORD j = 0; j < dwChannels; j++) {
+            output[i * dwChannels + j] = kernel_quantize(
+                kernel_get_output_sample(pInput, i, dwChannels, j), KERNEL_S32_MAX);
+        }
+    }
+}
+
+/* ---------------------------------------------------------------------- */
+
+FLOAT DELTACALL kernel_half_to_float(WORD wValue) {
+    const DWORD exponent = 0x7C00 << 13;
+    const kernel_bits magic = { .Bits = 113 << 23 };
+
+    kernel_bits result = { .Bits = (wValue & 0x7FFF) << 13 };
+
+    const DWORD bits = result.Bits & exponent;
+
+    result.Bits += (127 - 15) << 23;
+
+    if (bits == exponent) {
+        // Infinity or NaN.
+        result.Bits += (128 - 16) << 23;
+    }
+    else if (bits == 0) {
+        // Zero or denormal, renormalized by the subtraction.
+        result.Bits += 1 << 23;
+        result.Value -= magic.Value;
+    }
+
+    result.Bits |= (DWORD)(wValue & 0x8000) << 16;
+
+    return result.Value;
+}
+
+WORD DELTACALL kernel_float_to_half(FLOAT fValue) {
+    const kernel_bits infinity = { .Bits = 255 << 23 };
+    const kernel_bits maximum = { .Bits = (127 + 16) << 23 };
+    const kernel_bits magic = { .Bits = ((127 - 15) + (23 - 10) + 1) << 23 };
+
+    kernel_bits value = { .Value = fValue };
+
+    const DWORD sign = value.Bits & 0x80000000;
+    value.Bits ^= sign;
+
+    WORD result = 0;
+
+    if (maximum.Bits <= value.Bits) {
+        // Infinity, NaN or too large to be represented.
+        result = infinity.Bits < value.Bits ? 0x7E00 : 0x7C00;
+    }
+    else if (value.Bits < (113 << 23)) {
+        // Denormal, the addition rounds the mantissa into place.
+        value.Value += magic.Value;
+        result = (WORD)(value.Bits - magic.Bits);
+    }
+    else {
+        // Round to the nearest even.
+        const DWORD odd = (value.Bits >> 13) & 1;
+
+        value.Bits += ((DWORD)(15 - 127) << 23) + 0xFFF;
+        value.Bits += odd;
+
+        result = (WORD)(value.Bits >> 13);
+    }
+
+    return result | (WORD)(sign >> 16);
+}
+
+#define KERNEL_VOICE_TIER               scalar
+#define KERNEL_VOICE_CONVERT_U8_MONO    kernel_convert_u8_mono
+#define KERNEL_VOICE_CONVERT_U8_STEREO  kernel_convert_u8_stereo
+#define KERNEL_VOICE_CONVERT_S16_MONO   kernel_convert_s16_mono
+#define KERNEL_VOICE_CONVERT_S16_STEREO kernel_convert_s16_stereo
+#define KERNEL_VOICE_CONVERT_F16_MONO   kernel_convert_f16_mono
+#define KERNEL_VOICE_CONVERT_F16_STEREO kernel_convert_f16_stereo
+#define KERNEL_VOICE_RESAMPLE           kernel_resample
+#define KERNEL_VOICE_ACCUMULATE         kernel_accumulate
+
+#include "kernel_voice.h"
+
+FLOAT DELTACALL kernel_get_output_sample(const FLOAT* pInput, DWORD dwFrame, DWORD dwChannels, DWORD dwChannel) {
+    if (dwChannels == 1) {
+        return (pInput[dwFrame * KERNEL_CHANNELS + 0] + pInput[dwFrame * KERNEL_CHANNELS + 1]) * 0.5f;
+    }
+
+    // Front left and right speakers receive the mix, the rest of the channels are silent.
+    return dwChannel < KERNEL_CHANNELS ? pInput[dwFrame * KERNEL_CHANNELS + dwChannel] : 0.0f;
+}
+
+LONG DELTACALL kernel_quantize(FLOAT fValue, DOUBLE dScale) {
+    const DOUBLE value = (DOUBLE)fValue * dScale;
+
+    if (value >= dScale) {
+        return (LONG)dScale;
+    }
+
+    if (value <= -dScale - 1.0) {
+        return (LONG)(-dScale - 1.0);
+    }
+
+    return (LONG)(value < 0.0 ? value - 0.5 : value + 0.5);
+}
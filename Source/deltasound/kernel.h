@@ -0,0 +1,167 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "base.h"
+
+#define KERNEL_TIER_SCALAR          0
+#define KERNEL_TIER_SSE2            1
+#define KERNEL_TIER_SSE41           2
+#define KERNEL_TIER_AVX2            3
+#define KERNEL_TIER_AVX512          4
+
+#define KERNEL_FORMAT_U8_MONO       0
+#define KERNEL_FORMAT_U8_STEREO     1
+#define KERNEL_FORMAT_S16_MONO      2
+#define KERNEL_FORMAT_S16_STEREO    3
+#define KERNEL_FORMAT_F16_MONO      4
+#define KERNEL_FORMAT_F16_STEREO    5
+
+#define KERNEL_MAX_FORMAT_COUNT     6
+
+#define KERNEL_ENCODE_U8            0
+#define KERNEL_ENCODE_S16           1
+
+#define KERNEL_MAX_ENCODE_COUNT     2
+
+#define KERNEL_OUTPUT_F32           0
+#define KERNEL_OUTPUT_S16           1
+#define KERNEL_OUTPUT_S24           2
+#define KERNEL_OUTPUT_S32           3
+
+#define KERNEL_MAX_OUTPUT_COUNT     4
+
+#define KERNEL_RESAMPLER_COPY       0
+#define KERNEL_RESAMPLER_LINEAR     1
+
+#define KERNEL_MAX_RESAMPLER_COUNT  2
+
+#define KERNEL_CHANNELS             2
+
+// The mix, scratch and sample buffers are aligned to, and padded to a multiple of, KERNEL_ALIGNMENT bytes.
+#define KERNEL_ALIGNMENT            64
+#define KERNEL_ALIGNMENT_FRAMES     ((DWORD)(KERNEL_ALIGNMENT / (KERNEL_CHANNELS * sizeof(FLOAT))))
+
+#define KERNEL_PADDED_FRAMES(X)     (((X) + KERNEL_ALIGNMENT_FRAMES - 1) & ~(KERNEL_ALIGNMENT_FRAMES - 1))
+
+#define KERNEL_U8_SCALE             (1.0f / 128.0f)
+#define KERNEL_S16_SCALE            (1.0f / 32768.0f)
+
+#define KERNEL_S16_MAX              32767.0
+#define KERNEL_S24_MAX              8388607.0
+#define KERNEL_S32_MAX              2147483647.0
+
+// Converts, resamples and mixes the frames of a single voice into the interleaved stereo IEEE mix.
+// The output frame i is sampled at the input position fPhase + i * fRatio, the phase carries the fraction
+// of an input frame left over by the previous period. The scratch buffer holds at least KERNEL_PADDED_FRAMES(dwInputFrames) + KERNEL_PADDED_FRAMES(dwOutputFrames)
+// interleaved stereo IEEE frames, the mix at least KERNEL_PADDED_FRAMES(dwOutputFrames), both aligned.
+typedef VOID(DELTACALL* LPKERNELVOICE)(LPCVOID pInput, DWORD dwInputFrames, FLOAT* pScratch,
+    FLOAT* pOutput, DWORD dwOutputFrames, FLOAT fRatio, FLOAT fPhase, FLOAT fLeft, FLOAT fRight);
+
+// Converts PCM samples to IEEE half precision samples.
+typedef VOID(DELTACALL* LPKERNELENCODE)(LPCVOID pInput, DWORD dwSamples, WORD* pOutput);
+
+// Writes interleaved stereo IEEE frames as frames of the device format with the requested number of channels.
+// The integer formats are clipped to the range of the samples.
+typedef VOID(DELTACALL* LPKERNELOUTPUT)(const FLOAT* pInput, DWORD dwFrames, DWORD dwChannels, LPVOID pOutput);
+
+typedef struct kernel {
+    DWORD               Tier;
+
+    LPKERNELVOICE       Voice[KERNEL_MAX_FORMAT_COUNT][KERNEL_MAX_RESAMPLER_COUNT];
+    LPKERNELENCODE      Encode[KERNEL_MAX_ENCODE_COUNT];
+    LPKERNELOUTPUT      Output[KERNEL_MAX_OUTPUT_COUNT];
+} kernel;
+
+HRESULT DELTACALL kernel_initialize(kernel* pKernel, DWORD dwFeatures);
+HRESULT DELTACALL kernel_get_format(LPCWAVEFORMATEX pcfxFormat, LPDWORD pdwFormat);
+HRESULT DELTACALL kernel_get_half_format(LPCWAVEFORMATEX pcfxFormat, LPDWORD pdwFormat);
+HRESULT DELTACALL kernel_get_voice(kernel* pKernel,
+    DWORD dwFormat, DWORD dwFrequency, DWORD dwDeviceFrequency, LPKERNELVOICE* ppVoice);
+HRESULT DELTACALL kernel_get_encoder(kernel* pKernel, LPCWAVEFORMATEX pcfxFormat, LPKERNELENCODE* ppEncode);
+HRESULT DELTACALL kernel_get_output(kernel* pKernel, PWAVEFORMATEXTENSIBLE pwfxFormat, LPKERNELOUTPUT* ppOutput);
+
+// Converts PCM frames to interleaved stereo IEEE frames.
+VOID DELTACALL kernel_convert_u8_mono(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput);
+VOID DELTACALL kernel_convert_u8_stereo(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput);
+VOID DELTACALL kernel_convert_s16_mono(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput);
+VOID DELTACALL kernel_convert_s16_stereo(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput);
+VOID DELTACALL kernel_convert_f16_mono(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput);
+VOID DELTACALL kernel_convert_f16_stereo(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput);
+
+// Linearly resamples interleaved stereo IEEE frames, the output frame i is sampled at fPhase + i * fRatio.
+VOID DELTACALL kernel_resample(const FLOAT* pInput, DWORD dwInputFrames,
+    FLOAT* pOutput, DWORD dwOutputFrames, FLOAT fRatio, FLOAT fPhase);
+
+// Applies left and right gains to interleaved stereo IEEE frames and adds them to the mix.
+// The vector tiers expect aligned buffers and process the padding frames too, so the input padding must be zero.
+VOID DELTACALL kernel_accumulate(const FLOAT* pInput, DWORD dwFrames,
+    FLOAT fLeft, FLOAT fRight, FLOAT* pOutput);
+
+// Zeroes the padding frames that follow dwFrames interleaved stereo IEEE frames.
+VOID DELTACALL kernel_pad(FLOAT* pBuffer, DWORD dwFrames);
+
+VOID DELTACALL kernel_encode_u8(LPCVOID pInput, DWORD dwSamples, WORD* pOutput);
+VOID DELTACALL kernel_encode_s16(LPCVOID pInput, DWORD dwSamples, WORD* pOutput);
+
+VOID DELTACALL kernel_output_f32(const FLOAT* pInput, DWORD dwFrames, DWORD dwChannels, LPVOID pOutput);
+VOID DELTACALL kernel_output_s16(const FLOAT* pInput, DWORD dwFrames, DWORD dwChannels, LPVOID pOutput);
+VOID DELTACALL kernel_output_s24(const FLOAT* pInput, DWORD dwFrames, DWORD dwChannels, LPVOID pOutput);
+VOID DELTACALL kernel_output_s32(const FLOAT* pInput, DWORD dwFrames, DWORD dwChannels, LPVOID pOutput);
+
+VOID DELTACALL kernel_convert_u8_mono_sse2(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput);
+VOID DELTACALL kernel_convert_u8_stereo_sse2(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput);
+VOID DELTACALL kernel_convert_s16_mono_sse2(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput);
+VOID DELTACALL kernel_convert_s16_stereo_sse2(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput);
+VOID DELTACALL kernel_accumulate_sse2(const FLOAT* pInput, DWORD dwFrames,
+    FLOAT fLeft, FLOAT fRight, FLOAT* pOutput);
+
+VOID DELTACALL kernel_convert_u8_mono_sse41(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput);
+VOID DELTACALL kernel_convert_u8_stereo_sse41(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput);
+VOID DELTACALL kernel_convert_s16_mono_sse41(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput);
+VOID DELTACALL kernel_convert_s16_stereo_sse41(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput);
+
+VOID DELTACALL kernel_convert_u8_mono_avx2(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput);
+VOID DELTACALL kernel_convert_u8_stereo_avx2(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput);
+VOID DELTACALL kernel_convert_s16_mono_avx2(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput);
+VOID DELTACALL kernel_convert_s16_stereo_avx2(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput);
+VOID DELTACALL kernel_convert_f16_mono_avx2(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput);
+VOID DELTACALL kernel_convert_f16_stereo_avx2(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput);
+VOID DELTACALL kernel_resample_avx2(const FLOAT* pInput, DWORD dwInputFrames,
+    FLOAT* pOutput, DWORD dwOutputFrames, FLOAT fRatio, FLOAT fPhase);
+VOID DELTACALL kernel_accumulate_avx2(const FLOAT* pInput, DWORD dwFrames,
+    FLOAT fLeft, FLOAT fRight, FLOAT* pOutput);
+VOID DELTACALL kernel_encode_u8_avx2(LPCVOID pInput, DWORD dwSamples, WORD* pOutput);
+VOID DELTACALL kernel_encode_s16_avx2(LPCVOID pInput, DWORD dwSamples, WORD* pOutput);
+
+VOID DELTACALL kernel_convert_s16_stereo_avx512(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput);
+VOID DELTACALL kernel_accumulate_avx512(const FLOAT* pInput, DWORD dwFrames,
+    FLOAT fLeft, FLOAT fRight, FLOAT* pOutput);
+
+extern const LPKERNELVOICE kernel_voices_scalar[KERNEL_MAX_FORMAT_COUNT][KERNEL_MAX_RESAMPLER_COUNT];
+extern const LPKERNELVOICE kernel_voices_sse2[KERNEL_MAX_FORMAT_COUNT][KERNEL_MAX_RESAMPLER_COUNT];
+extern const LPKERNELVOICE kernel_voices_sse41[KERNEL_MAX_FORMAT_COUNT][KERNEL_MAX_RESAMPLER_COUNT];
+extern const LPKERNELVOICE kernel_voices_avx2[KERNEL_MAX_FORMAT_COUNT][KERNEL_MAX_RESAMPLER_COUNT];
+extern const LPKERNELVOICE kernel_voices_avx512[KERNEL_MAX_FORMAT_COUNT][KERNEL_MAX_RESAMPLER_COUNT];
\ No newline at end of file
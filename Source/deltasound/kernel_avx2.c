@@ -0,0 +1,263 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "kernel.h"
+
+#if defined(_M_IX86) || defined(_M_X64)
+
+#include <immintrin.h>
+
+// Unpacking works within 128-bit lanes, so the halves are reassembled in frame order.
+static __inline VOID kernel_duplicate_avx2(__m256 v, FLOAT* pOutput) {
+    const __m256 lo = _mm256_unpacklo_ps(v, v);
+    const __m256 hi = _mm256_unpackhi_ps(v, v);
+
+    _mm256_storeu_ps(&pOutput[0], _mm256_permute2f128_ps(lo, hi, 0x20));
+    _mm256_storeu_ps(&pOutput[8], _mm256_permute2f128_ps(lo, hi, 0x31));
+}
+
+VOID DELTACALL kernel_convert_u8_mono_avx2(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput) {
+    const BYTE* input = (const BYTE*)pInput;
+
+    const __m256i bias = _mm256_set1_epi32(128);
+    const __m256 scale = _mm256_set1_ps(KERNEL_U8_SCALE);
+
+    DWORD i = 0;
+
+    for (; i + 8 <= dwFrames; i += 8) {
+        const __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)&input[i]));
+
+        kernel_duplicate_avx2(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(v, bias)), scale),
+            &pOutput[i * KERNEL_CHANNELS]);
+    }
+
+    kernel_convert_u8_mono(&input[i], dwFrames - i, &pOutput[i * KERNEL_CHANNELS]);
+}
+
+VOID DELTACALL kernel_convert_u8_stereo_avx2(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput) {
+    const BYTE* input = (const BYTE*)pInput;
+    const DWORD samples = dwFrames * KERNEL_CHANNELS;
+
+    const __m256i bias = _mm256_set1_epi32(128);
+    const __m256 scale = _mm256_set1_ps(KERNEL_U8_SCALE);
+
+    DWORD i = 0;
+
+    for (; i + 16 <= samples; i += 16) {
+        const __m128i v = _mm_loadu_si128((const __m128i*)&input[i]);
+
+        const __m256i lo = _mm256_sub_epi32(_mm256_cvtepu8_epi32(v), bias);
+        const __m256i hi = _mm256_sub_epi32(_mm256_cvtepu8_epi32(_mm_srli_si128(v, 8)), bias);
+
+        _mm256_storeu_ps(&pOutput[i + 0], _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale));
+        _mm256_storeu_ps(&pOutput[i + 8], _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale));
+    }
+
+    kernel_convert_u8_stereo(&input[i], (samples - i) / KERNEL_CHANNELS, &pOutput[i]);
+}
+
+VOID DELTACALL kernel_convert_s16_mono_avx2(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput) {
+    const SHORT* input = (const SHORT*)pInput;
+
+    const __m256 scale = _mm256_set1_ps(KERNEL_S16_SCALE);
+
+    DWORD i = 0;
+
+    for (; i + 8 <= dwFrames; i += 8) {
+        const __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)&input[i]));
+
+        kernel_duplicate_avx2(_mm256_mul_ps(_mm256_cvtepi32_ps(v), scale),
+            &pOutput[i * KERNEL_CHANNELS]);
+    }
+
+    kernel_convert_s16_mono(&input[i], dwFrames - i, &pOutput[i * KERNEL_CHANNELS]);
+}
+
+VOID DELTACALL kernel_convert_s16_stereo_avx2(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput) {
+    const SHORT* input = (const SHORT*)pInput;
+    const DWORD samples = dwFrames * KERNEL_CHANNELS;
+
+    const __m256 scale = _mm256_set1_ps(KERNEL_S16_SCALE);
+
+    DWORD i = 0;
+
+    for (; i + 16 <= samples; i += 16) {
+        const __m256i lo = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)&input[i + 0]));
+        const __m256i hi = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)&input[i + 8]));
+
+        _mm256_storeu_ps(&pOutput[i + 0], _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale));
+        _mm256_storeu_ps(&pOutput[i + 8], _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale));
+    }
+
+    kernel_convert_s16_stereo(&input[i], (samples - i) / KERNEL_CHANNELS, &pOutput[i]);
+}
+
+VOID DELTACALL kernel_convert_f16_mono_avx2(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput) {
+    const WORD* input = (const WORD*)pInput;
+
+    DWORD i = 0;
+
+    for (; i + 8 <= dwFrames; i += 8) {
+        kernel_duplicate_avx2(_mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)&input[i])),
+            &pOutput[i * KERNEL_CHANNELS]);
+    }
+
+    kernel_convert_f16_mono(&input[i], dwFrames - i, &pOutput[i * KERNEL_CHANNELS]);
+}
+
+VOID DELTACALL kernel_convert_f16_stereo_avx2(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput) {
+    const WORD* input = (const WORD*)pInput;
+    const DWORD samples = dwFrames * KERNEL_CHANNELS;
+
+    DWORD i = 0;
+
+    for (; i + 16 <= samples; i += 16) {
+        _mm256_storeu_ps(&pOutput[i + 0], _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)&input[i + 0])));
+        _mm256_storeu_ps(&pOutput[i + 8], _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)&input[i + 8])));
+    }
+
+    kernel_convert_f16_stereo(&input[i], (samples - i) / KERNEL_CHANNELS, &pOutput[i]);
+}
+
+VOID DELTACALL kernel_resample_avx2(const FLOAT* pInput, DWORD dwInputFrames,
+    FLOAT* pOutput, DWORD dwOutputFrames, FLOAT fRatio, FLOAT fPhase) {
+    if (dwInputFrames == 0) {
+        return;
+    }
+
+    const DWORD last = dwInputFrames - 1;
+
+    const __m128i limit = _mm_set1_epi32((INT)last);
+    const __m128i step = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128 ratio = _mm_set1_ps(fRatio);
+    const __m128 phase = _mm_set1_ps(fPhase);
+
+    // Spread four frame indexes over eight interleaved left and right sample offsets.
+    const __m256i duplicate = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+    const __m256i channel = _mm256_setr_epi32(0, 1, 0, 1, 0, 1, 0, 1);
+
+    DWORD i = 0;
+
+    for (; i + 4 <= dwOutputFrames; i += 4) {
+        const __m128 t = _mm_add_ps(phase,
+            _mm_mul_ps(_mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32((INT)i), step)), ratio));
+
+        const __m128i index = _mm_cvttps_epi32(t);
+        const __m128 fraction = _mm_sub_ps(t, _mm_cvtepi32_ps(index));
+
+        const __m128i i0 = _mm_min_epi32(index, limit);
+        const __m128i i1 = _mm_min_epi32(_mm_add_epi32(index, _mm_set1_epi32(1)), limit);
+
+        const __m256i o0 = _mm256_add_epi32(_mm256_slli_epi32(
+            _mm256_permutevar8x32_epi32(_mm256_castsi128_si256(i0), duplicate), 1), channel);
+        const __m256i o1 = _mm256_add_epi32(_mm256_slli_epi32(
+            _mm256_permutevar8x32_epi32(_mm256_castsi128_si256(i1), duplicate), 1), channel);
+
+        const __m256 f = _mm256_permutevar8x32_ps(_mm256_castps128_ps256(fraction), duplicate);
+
+        const __m256 y0 = _mm256_i32gather_ps(pInput, o0, sizeof(FLOAT));
+        const __m256 y1 = _mm256_i32gather_ps(pInput, o1, sizeof(FLOAT));
+
+        _mm256_storeu_ps(&pOutput[i * KERNEL_CHANNELS], _mm256_fmadd_ps(_mm256_sub_ps(y1, y0), f, y0));
+    }
+
+    for (; i < dwOutputFrames; i++) {
+        const FLOAT t = fPhase + i * fRatio;
+        const DWORD index = (DWORD)t;
+        const FLOAT fraction = t - index;
+
+        const DWORD i0 = min(index, last);
+        const DWORD i1 = min(index + 1, last);
+
+        for (DWORD c = 0; c < KERNEL_CHANNELS; c++) {
+            const FLOAT y0 = pInput[i0 * KERNEL_CHANNELS + c];
+            const FLOAT y1 = pInput[i1 * KERNEL_CHANNELS + c];
+
+            pOutput[i * KERNEL_CHANNELS + c] = y0 + (y1 - y0) * fraction;
+        }
+    }
+}
+
+VOID DELTACALL kernel_accumulate_avx2(const FLOAT* pInput, DWORD dwFrames,
+    FLOAT fLeft, FLOAT fRight, FLOAT* pOutput) {
+    const DWORD samples = KERNEL_PADDED_FRAMES(dwFrames) * KERNEL_CHANNELS;
+
+    const __m256 gain = _mm256_setr_ps(fLeft, fRight, fLeft, fRight, fLeft, fRight, fLeft, fRight);
+
+    for (DWORD i = 0; i < samples; i += 8) {
+        _mm256_store_ps(&pOutput[i],
+            _mm256_fmadd_ps(_mm256_load_ps(&pInput[i]), gain, _mm256_load_ps(&pOutput[i])));
+    }
+}
+
+VOID DELTACALL kernel_encode_u8_avx2(LPCVOID pInput, DWORD dwSamples, WORD* pOutput) {
+    const BYTE* input = (const BYTE*)pInput;
+
+    const __m256i bias = _mm256_set1_epi32(128);
+    const __m256 scale = _mm256_set1_ps(KERNEL_U8_SCALE);
+
+    DWORD i = 0;
+
+    for (; i + 8 <= dwSamples; i += 8) {
+        const __m256i v = _mm256_sub_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)&input[i])), bias);
+
+        _mm_storeu_si128((__m128i*)&pOutput[i],
+            _mm256_cvtps_ph(_mm256_mul_ps(_mm256_cvtepi32_ps(v), scale), _MM_FROUND_TO_NEAREST_INT));
+    }
+
+    kernel_encode_u8(&input[i], dwSamples - i, &pOutput[i]);
+}
+
+VOID DELTACALL kernel_encode_s16_avx2(LPCVOID pInput, DWORD dwSamples, WORD* pOutput) {
+    const SHORT* input = (const SHORT*)pInput;
+
+    const __m256 scale = _mm256_set1_ps(KERNEL_S16_SCALE);
+
+    DWORD i = 0;
+
+    for (; i + 8 <= dwSamples; i += 8) {
+        const __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)&input[i]));
+
+        _mm_storeu_si128((__m128i*)&pOutput[i],
+            _mm256_cvtps_ph(_mm256_mul_ps(_mm256_cvtepi32_ps(v), scale), _MM_FROUND_TO_NEAREST_INT));
+    }
+
+    kernel_encode_s16(&input[i], dwSamples - i, &pOutput[i]);
+}
+
+/* ---------------------------------------------------------------------- */
+
+#define KERNEL_VOICE_TIER               avx2
+#define KERNEL_VOICE_CONVERT_U8_MONO    kernel_convert_u8_mono_avx2
+#define KERNEL_VOICE_CONVERT_U8_STEREO  kernel_convert_u8_stereo_avx2
+#define KERNEL_VOICE_CONVERT_S16_MONO   kernel_convert_s16_mono_avx2
+#define KERNEL_VOICE_CONVERT_S16_STEREO kernel_convert_s16_stereo_avx2
+#define KERNEL_VOICE_CONVERT_F16_MONO   kernel_convert_f16_mono_avx2
+#define KERNEL_VOICE_CONVERT_F16_STEREO kernel_convert_f16_stereo_avx2
+#define KERNEL_VOICE_RESAMPLE           kernel_resample_avx2
+#define KERNEL_VOICE_ACCUMULATE         kernel_accumulate_avx2
+
+#include "kernel_voice.h"
+
+#endif
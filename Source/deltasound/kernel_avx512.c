@@ -0,0 +1,76 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "kernel.h"
+
+#if defined(_M_IX86) || defined(_M_X64)
+
+#include <immintrin.h>
+
+VOID DELTACALL kernel_convert_s16_stereo_avx512(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput) {
+    const SHORT* input = (const SHORT*)pInput;
+    const DWORD samples = dwFrames * KERNEL_CHANNELS;
+
+    const __m512 scale = _mm512_set1_ps(KERNEL_S16_SCALE);
+
+    DWORD i = 0;
+
+    for (; i + 32 <= samples; i += 32) {
+        const __m512i lo = _mm512_cvtepi16_epi32(_mm256_loadu_si256((const __m256i*)&input[i + 0]));
+        const __m512i hi = _mm512_cvtepi16_epi32(_mm256_loadu_si256((const __m256i*)&input[i + 16]));
+
+        _mm512_storeu_ps(&pOutput[i + 0], _mm512_mul_ps(_mm512_cvtepi32_ps(lo), scale));
+        _mm512_storeu_ps(&pOutput[i + 16], _mm512_mul_ps(_mm512_cvtepi32_ps(hi), scale));
+    }
+
+    kernel_convert_s16_stereo_avx2(&input[i], (samples - i) / KERNEL_CHANNELS, &pOutput[i]);
+}
+
+VOID DELTACALL kernel_accumulate_avx512(const FLOAT* pInput, DWORD dwFrames,
+    FLOAT fLeft, FLOAT fRight, FLOAT* pOutput) {
+    const DWORD samples = KERNEL_PADDED_FRAMES(dwFrames) * KERNEL_CHANNELS;
+
+    const __m512 gain = _mm512_setr4_ps(fLeft, fRight, fLeft, fRight);
+
+    for (DWORD i = 0; i < samples; i += 16) {
+        _mm512_store_ps(&pOutput[i],
+            _mm512_fmadd_ps(_mm512_load_ps(&pInput[i]), gain, _mm512_load_ps(&pOutput[i])));
+    }
+}
+
+/* ---------------------------------------------------------------------- */
+
+#define KERNEL_VOICE_TIER               avx512
+#define KERNEL_VOICE_CONVERT_U8_MONO    kernel_convert_u8_mono_avx2
+#define KERNEL_VOICE_CONVERT_U8_STEREO  kernel_convert_u8_stereo_avx2
+#define KERNEL_VOICE_CONVERT_S16_MONO   kernel_convert_s16_mono_avx2
+#define KERNEL_VOICE_CONVERT_S16_STEREO kernel_convert_s16_stereo_avx512
+#define KERNEL_VOICE_CONVERT_F16_MONO   kernel_convert_f16_mono_avx2
+#define KERNEL_VOICE_CONVERT_F16_STEREO kernel_convert_f16_stereo_avx2
+#define KERNEL_VOICE_RESAMPLE           kernel_resample_avx2
+#define KERNEL_VOICE_ACCUMULATE         kernel_accumulate_avx512
+
+#include "kernel_voice.h"
+
+#endif
@@ -0,0 +1,157 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "kernel.h"
+
+#if defined(_M_IX86) || defined(_M_X64)
+
+#include <emmintrin.h>
+
+VOID DELTACALL kernel_convert_u8_mono_sse2(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput) {
+    const BYTE* input = (const BYTE*)pInput;
+
+    const __m128i sign = _mm_set1_epi8((CHAR)0x80);
+    const __m128 scale = _mm_set1_ps(KERNEL_U8_SCALE);
+
+    DWORD i = 0;
+
+    for (; i + 8 <= dwFrames; i += 8) {
+        // Flipping the sign bit turns unsigned samples into signed samples centered at zero.
+        const __m128i v = _mm_xor_si128(_mm_loadl_epi64((const __m128i*)&input[i]), sign);
+        const __m128i w = _mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8);
+
+        const __m128 lo = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(w, w), 16)), scale);
+        const __m128 hi = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(w, w), 16)), scale);
+
+        FLOAT* output = &pOutput[i * KERNEL_CHANNELS];
+
+        _mm_storeu_ps(&output[0], _mm_unpacklo_ps(lo, lo));
+        _mm_storeu_ps(&output[4], _mm_unpackhi_ps(lo, lo));
+        _mm_storeu_ps(&output[8], _mm_unpacklo_ps(hi, hi));
+        _mm_storeu_ps(&output[12], _mm_unpackhi_ps(hi, hi));
+    }
+
+    kernel_convert_u8_mono(&input[i], dwFrames - i, &pOutput[i * KERNEL_CHANNELS]);
+}
+
+VOID DELTACALL kernel_convert_u8_stereo_sse2(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput) {
+    const BYTE* input = (const BYTE*)pInput;
+    const DWORD samples = dwFrames * KERNEL_CHANNELS;
+
+    const __m128i sign = _mm_set1_epi8((CHAR)0x80);
+    const __m128 scale = _mm_set1_ps(KERNEL_U8_SCALE);
+
+    DWORD i = 0;
+
+    for (; i + 16 <= samples; i += 16) {
+        const __m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i*)&input[i]), sign);
+
+        const __m128i lo = _mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8);
+        const __m128i hi = _mm_srai_epi16(_mm_unpackhi_epi8(v, v), 8);
+
+        _mm_storeu_ps(&pOutput[i + 0],
+            _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(lo, lo), 16)), scale));
+        _mm_storeu_ps(&pOutput[i + 4],
+            _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(lo, lo), 16)), scale));
+        _mm_storeu_ps(&pOutput[i + 8],
+            _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(hi, hi), 16)), scale));
+        _mm_storeu_ps(&pOutput[i + 12],
+            _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(hi, hi), 16)), scale));
+    }
+
+    kernel_convert_u8_stereo(&input[i], (samples - i) / KERNEL_CHANNELS, &pOutput[i]);
+}
+
+VOID DELTACALL kernel_convert_s16_mono_sse2(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput) {
+    const SHORT* input = (const SHORT*)pInput;
+
+    const __m128 scale = _mm_set1_ps(KERNEL_S16_SCALE);
+
+    DWORD i = 0;
+
+    for (; i + 8 <= dwFrames; i += 8) {
+        const __m128i v = _mm_loadu_si128((const __m128i*)&input[i]);
+
+        const __m128 lo = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16)), scale);
+        const __m128 hi = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16)), scale);
+
+        FLOAT* output = &pOutput[i * KERNEL_CHANNELS];
+
+        _mm_storeu_ps(&output[0], _mm_unpacklo_ps(lo, lo));
+        _mm_storeu_ps(&output[4], _mm_unpackhi_ps(lo, lo));
+        _mm_storeu_ps(&output[8], _mm_unpacklo_ps(hi, hi));
+        _mm_storeu_ps(&output[12], _mm_unpackhi_ps(hi, hi));
+    }
+
+    kernel_convert_s16_mono(&input[i], dwFrames - i, &pOutput[i * KERNEL_CHANNELS]);
+}
+
+VOID DELTACALL kernel_convert_s16_stereo_sse2(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput) {
+    const SHORT* input = (const SHORT*)pInput;
+    const DWORD samples = dwFrames * KERNEL_CHANNELS;
+
+    const __m128 scale = _mm_set1_ps(KERNEL_S16_SCALE);
+
+    DWORD i = 0;
+
+    for (; i + 8 <= samples; i += 8) {
+        const __m128i v = _mm_loadu_si128((const __m128i*)&input[i]);
+
+        _mm_storeu_ps(&pOutput[i + 0],
+            _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16)), scale));
+        _mm_storeu_ps(&pOutput[i + 4],
+            _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16)), scale));
+    }
+
+    kernel_convert_s16_stereo(&input[i], (samples - i) / KERNEL_CHANNELS, &pOutput[i]);
+}
+
+VOID DELTACALL kernel_accumulate_sse2(const FLOAT* pInput, DWORD dwFrames,
+    FLOAT fLeft, FLOAT fRight, FLOAT* pOutput) {
+    const DWORD samples = KERNEL_PADDED_FRAMES(dwFrames) * KERNEL_CHANNELS;
+
+    const __m128 gain = _mm_setr_ps(fLeft, fRight, fLeft, fRight);
+
+    for (DWORD i = 0; i < samples; i += 4) {
+        const __m128 v = _mm_mul_ps(_mm_load_ps(&pInput[i]), gain);
+
+        _mm_store_ps(&pOutput[i], _mm_add_ps(_mm_load_ps(&pOutput[i]), v));
+    }
+}
+
+/* ---------------------------------------------------------------------- */
+
+#define KERNEL_VOICE_TIER               sse2
+#define KERNEL_VOICE_CONVERT_U8_MONO    kernel_convert_u8_mono_sse2
+#define KERNEL_VOICE_CONVERT_U8_STEREO  kernel_convert_u8_stereo_sse2
+#define KERNEL_VOICE_CONVERT_S16_MONO   kernel_convert_s16_mono_sse2
+#define KERNEL_VOICE_CONVERT_S16_STEREO kernel_convert_s16_stereo_sse2
+#define KERNEL_VOICE_CONVERT_F16_MONO   kernel_convert_f16_mono
+#define KERNEL_VOICE_CONVERT_F16_STEREO kernel_convert_f16_stereo
+#define KERNEL_VOICE_RESAMPLE           kernel_resample
+#define KERNEL_VOICE_ACCUMULATE         kernel_accumulate_sse2
+
+#include "kernel_voice.h"
+
+#endif
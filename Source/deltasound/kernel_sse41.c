@@ -0,0 +1,129 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "kernel.h"
+
+#if defined(_M_IX86) || defined(_M_X64)
+
+#include <smmintrin.h>
+
+VOID DELTACALL kernel_convert_u8_mono_sse41(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput) {
+    const BYTE* input = (const BYTE*)pInput;
+
+    const __m128i bias = _mm_set1_epi32(128);
+    const __m128 scale = _mm_set1_ps(KERNEL_U8_SCALE);
+
+    DWORD i = 0;
+
+    for (; i + 4 <= dwFrames; i += 4) {
+        const __m128i v = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(*(const INT*)&input[i]));
+        const __m128 f = _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(v, bias)), scale);
+
+        FLOAT* output = &pOutput[i * KERNEL_CHANNELS];
+
+        _mm_storeu_ps(&output[0], _mm_unpacklo_ps(f, f));
+        _mm_storeu_ps(&output[4], _mm_unpackhi_ps(f, f));
+    }
+
+    kernel_convert_u8_mono(&input[i], dwFrames - i, &pOutput[i * KERNEL_CHANNELS]);
+}
+
+VOID DELTACALL kernel_convert_u8_stereo_sse41(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput) {
+    const BYTE* input = (const BYTE*)pInput;
+    const DWORD samples = dwFrames * KERNEL_CHANNELS;
+
+    const __m128i bias = _mm_set1_epi32(128);
+    const __m128 scale = _mm_set1_ps(KERNEL_U8_SCALE);
+
+    DWORD i = 0;
+
+    for (; i + 8 <= samples; i += 8) {
+        const __m128i v = _mm_loadl_epi64((const __m128i*)&input[i]);
+
+        const __m128i lo = _mm_sub_epi32(_mm_cvtepu8_epi32(v), bias);
+        const __m128i hi = _mm_sub_epi32(_mm_cvtepu8_epi32(_mm_srli_si128(v, 4)), bias);
+
+        _mm_storeu_ps(&pOutput[i + 0], _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(&pOutput[i + 4], _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+
+    kernel_convert_u8_stereo(&input[i], (samples - i) / KERNEL_CHANNELS, &pOutput[i]);
+}
+
+VOID DELTACALL kernel_convert_s16_mono_sse41(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput) {
+    const SHORT* input = (const SHORT*)pInput;
+
+    const __m128 scale = _mm_set1_ps(KERNEL_S16_SCALE);
+
+    DWORD i = 0;
+
+    for (; i + 4 <= dwFrames; i += 4) {
+        const __m128i v = _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i*)&input[i]));
+        const __m128 f = _mm_mul_ps(_mm_cvtepi32_ps(v), scale);
+
+        FLOAT* output = &pOutput[i * KERNEL_CHANNELS];
+
+        _mm_storeu_ps(&output[0], _mm_unpacklo_ps(f, f));
+        _mm_storeu_ps(&output[4], _mm_unpackhi_ps(f, f));
+    }
+
+    kernel_convert_s16_mono(&input[i], dwFrames - i, &pOutput[i * KERNEL_CHANNELS]);
+}
+
+VOID DELTACALL kernel_convert_s16_stereo_sse41(LPCVOID pInput, DWORD dwFrames, FLOAT* pOutput) {
+    const SHORT* input = (const SHORT*)pInput;
+    const DWORD samples = dwFrames * KERNEL_CHANNELS;
+
+    const __m128 scale = _mm_set1_ps(KERNEL_S16_SCALE);
+
+    DWORD i = 0;
+
+    for (; i + 8 <= samples; i += 8) {
+        const __m128i v = _mm_loadu_si128((const __m128i*)&input[i]);
+
+        const __m128i lo = _mm_cvtepi16_epi32(v);
+        const __m128i hi = _mm_cvtepi16_epi32(_mm_srli_si128(v, 8));
+
+        _mm_storeu_ps(&pOutput[i + 0], _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(&pOutput[i + 4], _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+
+    kernel_convert_s16_stereo(&input[i], (samples - i) / KERNEL_CHANNELS, &pOutput[i]);
+}
+
+/* ---------------------------------------------------------------------- */
+
+#define KERNEL_VOICE_TIER               sse41
+#define KERNEL_VOICE_CONVERT_U8_MONO    kernel_convert_u8_mono_sse41
+#define KERNEL_VOICE_CONVERT_U8_STEREO  kernel_convert_u8_stereo_sse41
+#define KERNEL_VOICE_CONVERT_S16_MONO   kernel_convert_s16_mono_sse41
+#define KERNEL_VOICE_CONVERT_S16_STEREO kernel_convert_s16_stereo_sse41
+#define KERNEL_VOICE_CONVERT_F16_MONO   kernel_convert_f16_mono
+#define KERNEL_VOICE_CONVERT_F16_STEREO kernel_convert_f16_stereo
+#define KERNEL_VOICE_RESAMPLE           kernel_resample
+#define KERNEL_VOICE_ACCUMULATE         kernel_accumulate_sse2
+
+#include "kernel_voice.h"
+
+#endif
@@ -0,0 +1,86 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Instantiates the voice kernels and the voice table of a single tier, so it is included once per tier.
+// The including file defines KERNEL_VOICE_TIER, KERNEL_VOICE_CONVERT_U8_MONO, KERNEL_VOICE_CONVERT_U8_STEREO,
+// KERNEL_VOICE_CONVERT_S16_MONO, KERNEL_VOICE_CONVERT_S16_STEREO, KERNEL_VOICE_CONVERT_F16_MONO,
+// KERNEL_VOICE_CONVERT_F16_STEREO, KERNEL_VOICE_RESAMPLE and KERNEL_VOICE_ACCUMULATE.
+
+#define KERNEL_VOICE_CONCAT(NAME, TIER) NAME##_##TIER
+#define KERNEL_VOICE_EXPAND(NAME, TIER) KERNEL_VOICE_CONCAT(NAME, TIER)
+#define KERNEL_VOICE_NAME(NAME) KERNEL_VOICE_EXPAND(NAME, KERNEL_VOICE_TIER)
+
+#define KERNEL_VOICE_LIST(X) \
+    X(KERNEL_FORMAT_U8_MONO, u8_mono, KERNEL_VOICE_CONVERT_U8_MONO) \
+    X(KERNEL_FORMAT_U8_STEREO, u8_stereo, KERNEL_VOICE_CONVERT_U8_STEREO) \
+    X(KERNEL_FORMAT_S16_MONO, s16_mono, KERNEL_VOICE_CONVERT_S16_MONO) \
+    X(KERNEL_FORMAT_S16_STEREO, s16_stereo, KERNEL_VOICE_CONVERT_S16_STEREO) \
+    X(KERNEL_FORMAT_F16_MONO, f16_mono, KERNEL_VOICE_CONVERT_F16_MONO) \
+    X(KERNEL_FORMAT_F16_STEREO, f16_stereo, KERNEL_VOICE_CONVERT_F16_STEREO)
+
+#define KERNEL_VOICE_DEFINE(FORMAT, NAME, CONVERT) \
+    VOID DELTACALL KERNEL_VOICE_NAME(kernel_voice_##NAME##_copy)(LPCVOID pInput, DWORD dwInputFrames, \
+        FLOAT* pScratch, FLOAT* pOutput, DWORD dwOutputFrames, FLOAT fRatio, FLOAT fPhase, FLOAT fLeft, FLOAT fRight) { \
+        const DWORD frames = min(dwInputFrames, dwOutputFrames); \
+        CONVERT(pInput, frames, pScratch); \
+        kernel_pad(pScratch, frames); \
+        KERNEL_VOICE_ACCUMULATE(pScratch, frames, fLeft, fRight, pOutput); \
+    } \
+    VOID DELTACALL KERNEL_VOICE_NAME(kernel_voice_##NAME##_linear)(LPCVOID pInput, DWORD dwInputFrames, \
+        FLOAT* pScratch, FLOAT* pOutput, DWORD dwOutputFrames, FLOAT fRatio, FLOAT fPhase, FLOAT fLeft, FLOAT fRight) { \
+        FLOAT* resampled = &pScratch[KERNEL_PADDED_FRAMES(dwInputFrames) * KERNEL_CHANNELS]; \
+        CONVERT(pInput, dwInputFrames, pScratch); \
+        KERNEL_VOICE_RESAMPLE(pScratch, dwInputFrames, resampled, dwOutputFrames, fRatio, fPhase); \
+        kernel_pad(resampled, dwOutputFrames); \
+        KERNEL_VOICE_ACCUMULATE(resampled, dwOutputFrames, fLeft, fRight, pOutput); \
+    }
+
+#define KERNEL_VOICE_ENTRY(FORMAT, NAME, CONVERT) \
+    [FORMAT] = { \
+        [KERNEL_RESAMPLER_COPY] = KERNEL_VOICE_NAME(kernel_voice_##NAME##_copy), \
+        [KERNEL_RESAMPLER_LINEAR] = KERNEL_VOICE_NAME(kernel_voice_##NAME##_linear) \
+    },
+
+KERNEL_VOICE_LIST(KERNEL_VOICE_DEFINE)
+
+const LPKERNELVOICE KERNEL_VOICE_NAME(kernel_voices)[KERNEL_MAX_FORMAT_COUNT][KERNEL_MAX_RESAMPLER_COUNT] = {
+    KERNEL_VOICE_LIST(KERNEL_VOICE_ENTRY)
+};
+
+#undef KERNEL_VOICE_ENTRY
+#undef KERNEL_VOICE_DEFINE
+#undef KERNEL_VOICE_LIST
+#undef KERNEL_VOICE_NAME
+#undef KERNEL_VOICE_EXPAND
+#undef KERNEL_VOICE_CONCAT
+
+#undef KERNEL_VOICE_TIER
+#undef KERNEL_VOICE_CONVERT_U8_MONO
+#undef KERNEL_VOICE_CONVERT_U8_STEREO
+#undef KERNEL_VOICE_CONVERT_S16_MONO
+#undef KERNEL_VOICE_CONVERT_S16_STEREO
+#undef KERNEL_VOICE_CONVERT_F16_MONO
+#undef KERNEL_VOICE_CONVERT_F16_STEREO
+#undef KERNEL_VOICE_RESAMPLE
+#undef KERNEL_VOICE_ACCUMULATE
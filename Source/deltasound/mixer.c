@@ -31,14 +31,20 @@ SOFTWARE.
 
 #define STEREO              2
 
-#define BUFFERFREQUENCY(FREQUENCY, OVERRIDE) \
-    (OVERRIDE == DSBFREQUENCY_ORIGINAL ? FREQUENCY : OVERRIDE)
+// The widest frame a voice kernel reads, the samples of a 16-bit stereo buffer or of its half precision cache.
+#define MAX_FRAME_SIZE      (STEREO * sizeof(WORD))
+
+#define PADDED(X)           (((X) + KERNEL_ALIGNMENT - 1) & ~(KERNEL_ALIGNMENT - 1))
 
 typedef struct mb {
-    dsb* Instance;
+    dsb*            Instance;
+    dsbcb*          Cursor;
 
-    LPWAVEFORMATEX  Format;
-    DWORD           Frequency;
+    DWORD           Status;
+    DWORD           Flags;
+    DWORD           Alignment;
+    DWORD           Channels;
+    LPKERNELVOICE   Voice;
 
     DWORD           InFrames;
     DWORD           InActualFrames;
@@ -46,25 +52,28 @@ typedef struct mb {
     DWORD           MaxFrames;
 
     FLOAT           Ratio;
+    FLOAT           Phase;      // Input position of the first output frame
+    FLOAT           EndPhase;   // Input position of the first frame of the next period, past the consumed frames
+
+    FLOAT           Left;
+    FLOAT           Right;
 
     LPVOID          Input;
-    FLOAT* Intermediate;
-    FLOAT* Out;
 } mb;
 
 struct mixer {
     allocator*  Allocator;
+    kernel*     Kernel;
     arena*      Arena;
+    dstm*       Timing;
 };
 
-HRESULT DELTACALL mb_initialize(mb* pBuffer, dsb* pDSB, DWORD dwRequiredFrames, DWORD dwRequiredFrequency);
-
-HRESULT DELTACALL mixer_attenuate(mixer* pMix, mb* pBuffer, FLOAT fVolume, FLOAT fPan);
-HRESULT DELTACALL mixer_convert(mixer* self, mb* pBuffer);
-HRESULT DELTACALL mixer_resample(mixer* pMix, mb* pBuffer, DWORD dwFrequency);
+HRESULT DELTACALL mixer_measure(DWORD dwVoices, DWORD dwFrequency, DWORD dwRequiredFrames, LPDWORD pdwBytes);
+HRESULT DELTACALL mb_initialize(mb* pBuffer,
+    dsvt* pVoices, DWORD dwIndex, DWORD dwRequiredFrames, DWORD dwRequiredFrequency);
 
-HRESULT DELTACALL mixer_create(allocator* pAlloc, mixer** ppOut) {
-    if (pAlloc == NULL || ppOut == NULL) {
+HRESULT DELTACALL mixer_create(allocator* pAlloc, kernel* pKernel, dstm* pTiming, mixer** ppOut) {
+    if (pAlloc == NULL || pKernel == NULL || ppOut == NULL) {
         return E_INVALIDARG;
     }
 
@@ -73,6 +82,8 @@ HRESULT DELTACALL mixer_create(allocator* pAlloc, mixer** ppOut) {
 
     if (SUCCEEDED(hr = allocator_allocate(pAlloc, sizeof(mixer), &instance))) {
         instance->Allocator = pAlloc;
+        instance->Kernel = pKernel;
+        instance->Timing = pTiming;
 
         if (SUCCEEDED(hr = arena_create(pAlloc, &instance->Arena))) {
 
@@ -95,266 +106,263 @@ VOID DELTACALL mixer_release(mixer* self) {
     allocator_free(self->Allocator, self);
 }
 
-HRESULT DELTACALL mixer_mix(mixer* self, DWORD dwBuffers, dsb** ppBuffers,
-    PWAVEFORMATEXTENSIBLE pwfxFormat, DWORD dwRequiredFrames, LPVOID* pOutBuffer, LPDWORD pdwOutFrames) {
+HRESULT DELTACALL mixer_compact(mixer* self, LPDWORD pdwBytes) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    return arena_trim(self->Arena, pdwBytes);
+}
+
+HRESULT DELTACALL mixer_reserve(mixer* self, DWORD dwVoices, DWORD dwFrequency, DWORD dwRequiredFrames) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    HRESULT hr = S_OK;
+    DWORD bytes = 0;
+
+    if (SUCCEEDED(hr = mixer_measure(dwVoices, dwFrequency, dwRequiredFrames, &bytes))) {
+        hr = arena_reserve(self->Arena, bytes);
+    }
+
+    return hr;
+}
+
+HRESULT DELTACALL mixer_prepare(mixer* self,
+    DWORD dwVoices, DWORD dwFrequency, DWORD dwRequiredFrames, LPVOID* ppBlock) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    HRESULT hr = S_OK;
+    DWORD bytes = 0;
+
+    if (SUCCEEDED(hr = mixer_measure(dwVoices, dwFrequency, dwRequiredFrames, &bytes))) {
+        hr = arena_prepare(self->Arena, bytes, ppBlock);
+    }
+
+    return hr;
+}
+
+HRESULT DELTACALL mixer_swap(mixer* self, LPVOID* ppBlock) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    return arena_swap(self->Arena, ppBlock);
+}
+
+VOID DELTACALL mixer_discard(mixer* self, LPVOID pBlock) {
+    if (self == NULL) { return; }
+
+    arena_discard(self->Arena, pBlock);
+}
+
+HRESULT DELTACALL mixer_mix(mixer* self, dsvt* pVoices, DWORD dwVoices, LPDWORD pdwVoices,
+    PWAVEFORMATEXTENSIBLE pwfxFormat, DWORD dwRequiredFrames, LPVOID pOutput, LPDWORD pdwOutFrames) {
     if (self == NULL) {
         return E_POINTER;
     }
 
     if (pwfxFormat == NULL || dwRequiredFrames == 0
-        || dwBuffers == 0 || ppBuffers == NULL
-        || pOutBuffer == NULL || pdwOutFrames == NULL) {
+        || pVoices == NULL || dwVoices == 0 || pdwVoices == NULL
+        || pOutput == NULL || pdwOutFrames == NULL) {
         return E_INVALIDARG;
     }
 
     HRESULT hr = S_OK;
     mb* buffers = NULL;
+    LPKERNELOUTPUT write = NULL;
+
+    DSTM_START(mark);
+
+    // The mix is produced as IEEE, and written in the format of the device, integer samples of an exclusive stream included.
+    if (FAILED(hr = kernel_get_output(self->Kernel, pwfxFormat, &write))) {
+        return hr;
+    }
 
     if (FAILED(hr = arena_clear(self->Arena))) {
         return hr;
     }
 
-    if (FAILED(hr = arena_allocate(self->Arena, dwBuffers * sizeof(mb), &buffers))) {
+    if (FAILED(hr = arena_allocate_uninitialized(self->Arena, dwVoices * sizeof(mb), &buffers))) {
         return hr;
     }
 
     // TODO multi-threaded mixing ?
-    // TODO SIMD mixing!
 
     // Read the data from the user-defined buffers.
-    for (DWORD i = 0; i < dwBuffers; i++) {
+    for (DWORD i = 0; i < dwVoices; i++) {
         if (FAILED(hr = mb_initialize(&buffers[i],
-            ppBuffers[i], dwRequiredFrames, pwfxFormat->Format.nSamplesPerSec))) {
+            pVoices, pdwVoices[i], dwRequiredFrames, pwfxFormat->Format.nSamplesPerSec))) {
             return hr;
         }
 
-        const DWORD alignment = buffers[i].Format->nBlockAlign;
+        const DWORD alignment = buffers[i].Alignment;
         const DWORD length = buffers[i].InActualFrames * alignment;
+        const BOOL cache = buffers[i].Flags & DSVT_VOICE_CACHE;
+
+        // Cached buffers are read as IEEE half precision samples instead of PCM.
+        const DWORD size = cache
+            ? buffers[i].InActualFrames * buffers[i].Channels * sizeof(WORD) : length;
 
-        if (FAILED(hr = arena_allocate(self->Arena, length, &buffers[i].Input))) {
+        if (FAILED(hr = arena_allocate_uninitialized(self->Arena, size, &buffers[i].Input))) {
             return hr;
         }
 
         DWORD read = 0;
+        DWORD flags = (buffers[i].Status & DSBSTATUS_LOOPING) ? DSBCB_READ_LOOPING : DSBCB_READ_NONE;
 
-        if (FAILED(hr = dsbcb_read(ppBuffers[i]->Buffer, length, buffers[i].Input, &read,
-            (ppBuffers[i]->Status & DSBSTATUS_LOOPING) ? DSBCB_READ_LOOPING : DSBCB_READ_NONE))) {
+        if (cache) {
+            flags |= DSBCB_READ_CACHE;
+        }
+
+        if (FAILED(hr = dsbcb_read(buffers[i].Cursor, length, buffers[i].Input, &read, flags))) {
             return hr;
         }
 
         const DWORD frames = read / alignment;
 
+        // Only the output frames sampled before the end of the input are mixed.
         if (frames < buffers[i].InActualFrames) {
             buffers[i].InActualFrames = frames;
-            buffers[i].OutFrames = (DWORD)truncf(buffers[i].InActualFrames / buffers[i].Ratio);
+            buffers[i].OutFrames = min(buffers[i].OutFrames,
+                (DWORD)max(ceilf((frames - buffers[i].Phase) / buffers[i].Ratio), 0.0f));
         }
     }
 
-    // TODO. Assumption is that inputs are non-IEEE PCM.
+    DSTM_LAP(self->Timing, DSTM_READ, mark);
 
-    // Convert to IEEE, upmix/downmix audio to stereo.
-    for (DWORD i = 0; i < dwBuffers; i++) {
-        if (FAILED(hr = mixer_convert(self, &buffers[i]))) {
-            return hr;
-        }
-    }
-
-    // At this point all audio data is IEEE and stereo.
-    // Resample the audio to the requested audio frequency.
-    for (DWORD i = 0; i < dwBuffers; i++) {
-        if (FAILED(hr = mixer_resample(self, &buffers[i], pwfxFormat->Format.nSamplesPerSec))) {
-            return hr;
-        }
-    }
-
-    // Apply attenuation (volume and pan modifiers).
-    for (DWORD i = 0; i < dwBuffers; i++) {
-        if (FAILED(hr = mixer_attenuate(self, &buffers[i], ppBuffers[i]->Volume, ppBuffers[i]->Pan))) {
-            return hr;
-        }
-    }
-
-    // Find the longest buffer (in frames) in the mix.
+    // Find the longest buffer (in frames) in the mix, and the scratch space the longest voice needs.
     DWORD frames = 0;
+    DWORD scratch = 0;
 
-    for (DWORD i = 0; i < dwBuffers; i++) {
+    for (DWORD i = 0; i < dwVoices; i++) {
         if (frames < buffers[i].OutFrames) {
             frames = buffers[i].OutFrames;
         }
+
+        const DWORD required = KERNEL_PADDED_FRAMES(buffers[i].InActualFrames)
+            + KERNEL_PADDED_FRAMES(buffers[i].OutFrames);
+
+        if (scratch < required) {
+            scratch = required;
+        }
     }
 
     // Mix all sound buffers together.
+    // The voice kernels convert to IEEE stereo, resample to the requested frequency and attenuate.
     FLOAT* result = NULL;
+    FLOAT* intermediate = NULL;
 
-    if (FAILED(hr = arena_allocate(self->Arena, frames * STEREO * sizeof(FLOAT), &result))) {
+    if (FAILED(hr = arena_allocate(self->Arena, KERNEL_PADDED_FRAMES(frames) * STEREO * sizeof(FLOAT), &result))) {
         return hr;
     }
 
-    for (DWORD i = 0; i < frames; i++) {
-        FLOAT l = 0.0f, r = 0.0f;
-
-        for (DWORD k = 0; k < dwBuffers; k++) {
-            if (i < buffers[k].OutFrames) {
-                l += buffers[k].Out[i * STEREO + 0];
-                r += buffers[k].Out[i * STEREO + 1];
-            }
-        }
+    if (FAILED(hr = arena_allocate_uninitialized(self->Arena, scratch * STEREO * sizeof(FLOAT), &intermediate))) {
+        return hr;
+    }
 
-        result[i * STEREO + 0] = l;
-        result[i * STEREO + 1] = r;
+    for (DWORD i = 0; i < dwVoices; i++) {
+        buffers[i].Voice(buffers[i].Input, buffers[i].InActualFrames, intermediate,
+            result, buffers[i].OutFrames, buffers[i].Ratio, buffers[i].Phase, buffers[i].Left, buffers[i].Right);
     }
 
+    DSTM_LAP(self->Timing, DSTM_MIX, mark);
+
     // TODO I think we need to scale values to be within [-1, 1] range.
 
-    // Convert audio data to requested wave format.
-    if (pwfxFormat->Format.wFormatTag != WAVE_FORMAT_EXTENSIBLE
-        && IsEqualGUID(&pwfxFormat->SubFormat, &KSDATAFORMAT_SUBTYPE_IEEE_FLOAT)) {
-        // TODO
-        return E_NOTIMPL;
-    }
+    // Convert audio data to requested wave format, the output holds no more than the required frames.
+    const DWORD written = min(frames, dwRequiredFrames);
 
-    for (DWORD i = 0; i < dwBuffers; i++) {
-        DWORD status = DSBSTATUS_NONE;
+    write(result, written, pwfxFormat->Format.nChannels, pOutput);
 
-        if (SUCCEEDED(hr = dsb_get_status(ppBuffers[i], &status))) {
-            if (status & DSBSTATUS_PLAYING) {
-                dsb_update_current_position(ppBuffers[i],
-                    buffers[i].InFrames * ppBuffers[i]->Format->nBlockAlign);
-            }
+    DSTM_LAP(self->Timing, DSTM_OUTPUT, mark);
+
+    // The voices that reach their end leave the table, so the positions are updated through the buffers.
+    for (DWORD i = 0; i < dwVoices; i++) {
+        if (buffers[i].Status & DSBSTATUS_PLAYING) {
+            dsb_update_current_position(buffers[i].Instance, pVoices,
+                buffers[i].InFrames * buffers[i].Alignment, buffers[i].EndPhase);
         }
     }
 
-    *pOutBuffer = result;
-    *pdwOutFrames = min(frames, dwRequiredFrames);
+    DSTM_LAP(self->Timing, DSTM_NOTIFY, mark);
+
+    *pdwOutFrames = written;
 
     return hr;
 }
 
 /* ---------------------------------------------------------------------- */
 
-FLOAT linear_interpolate(FLOAT v1, FLOAT v2, FLOAT t) {
-    return v1 * (1.0f - t) + v2 * t;
-}
-
-FLOAT DELTACALL convert_to_float(DWORD dwBits, LPVOID pValue) {
-    if (dwBits == 8) {
-        return ((FLOAT)(*(PBYTE)pValue) - 128.0f) / 128.0f;
-    }
-    else if (dwBits == 16) {
-        return  (FLOAT)(*(PSHORT)pValue) / 32768.0f;
-    }
-
-    return 0.0f;
-}
-
-HRESULT DELTACALL mb_initialize(mb* self,
-    dsb* pDSB, DWORD dwRequiredFrames, DWORD dwRequiredFrequency) {
-    if (self == NULL) {
-        return E_POINTER;
-    }
-
-    if (pDSB == NULL || dwRequiredFrames == 0 || dwRequiredFrequency == 0) {
+HRESULT DELTACALL mixer_measure(DWORD dwVoices, DWORD dwFrequency, DWORD dwRequiredFrames, LPDWORD pdwBytes) {
+    if (dwFrequency == 0) {
         return E_INVALIDARG;
     }
 
-    self->Instance = pDSB;
-    self->Format = pDSB->Format;
+    // The reservation covers a mix of the voices all playing at the highest frequency,
+    // so that the arena never grows while the device renders.
+    const DWORD64 input = (DWORD64)dwRequiredFrames * DSBFREQUENCY_MAX / dwFrequency + 1;
+    const DWORD64 output = (DWORD64)dwRequiredFrames + 1;
 
-    self->Frequency =
-        BUFFERFREQUENCY(self->Format->nSamplesPerSec, self->Instance->Frequency);
+    const DWORD64 bytes = PADDED((DWORD64)dwVoices * sizeof(mb))
+        + dwVoices * PADDED(input * MAX_FRAME_SIZE)
+        + PADDED(KERNEL_PADDED_FRAMES(output) * STEREO * sizeof(FLOAT))
+        + PADDED((KERNEL_PADDED_FRAMES(input) + KERNEL_PADDED_FRAMES(output)) * STEREO * sizeof(FLOAT));
 
-    self->Ratio = (FLOAT)self->Frequency / (FLOAT)dwRequiredFrequency;
-
-    self->InFrames = (DWORD)truncf(self->Ratio * dwRequiredFrames);
-    self->InActualFrames = (DWORD)roundf(self->Ratio * dwRequiredFrames);
-    self->OutFrames = (DWORD)roundf(self->InActualFrames / self->Ratio);
-    self->MaxFrames = dwRequiredFrames;
-
-    return S_OK;
-}
-
-HRESULT DELTACALL mixer_attenuate(mixer* self, mb* pBuffer, FLOAT fVolume, FLOAT fPan) {
-    if (self == NULL) {
-        return E_POINTER;
+    if (MAXDWORD < bytes) {
+        return E_OUTOFMEMORY;
     }
 
-    if (pBuffer == NULL
-        || _isnan(fVolume) || fVolume < 0.0f || fVolume > 1.0f
-        || _isnan(fPan) || fPan < -1.0f || fPan > 1.0f) {
-        return E_INVALIDARG;
-    }
-
-    if (fVolume != 1.0f && fPan != 0.0f) {
-        // Positive pan = attenuation of left channel.
-        const FLOAT l = fVolume * (fPan > 0.0f ? (1.0f - fPan) : 1.0f);
-
-        // Negative pan = attenuation of right channel.
-        const FLOAT r = fVolume * (fPan < 0.0f ? (1.0f + fPan) : 1.0f);
-
-        for (DWORD i = 0; i < pBuffer->OutFrames; i++) {
-            pBuffer->Out[i * STEREO + 0] *= l;
-            pBuffer->Out[i * STEREO + 1] *= r;
-        }
-    }
+    *pdwBytes = (DWORD)bytes;
 
     return S_OK;
 }
 
-HRESULT DELTACALL mixer_convert(mixer* self, mb* pBuffer) {
+HRESULT DELTACALL mb_initialize(mb* self,
+    dsvt* pVoices, DWORD dwIndex, DWORD dwRequiredFrames, DWORD dwRequiredFrequency) {
     if (self == NULL) {
         return E_POINTER;
     }
 
-    if (pBuffer == NULL) {
+    if (pVoices == NULL || pVoices->Count <= dwIndex || dwRequiredFrames == 0 || dwRequiredFrequency == 0) {
         return E_INVALIDARG;
     }
 
-    const DWORD bits = pBuffer->Format->wBitsPerSample;
+    // The render thread mixes the snapshot of the buffer state kept in the voice table,
+    // it never waits for the API threads to finish their updates.
+    self->Instance = pVoices->Buffers[dwIndex];
+    self->Cursor = pVoices->Cursors[dwIndex];
+    self->Status = pVoices->Status[dwIndex];
+    self->Flags = pVoices->Flags[dwIndex];
+    self->Alignment = pVoices->Alignments[dwIndex];
+    self->Channels = pVoices->Channels[dwIndex];
+    self->Voice = pVoices->Voices[dwIndex];
 
-    if (bits != 8 && bits != 16) {
+    if (self->Voice == NULL) {
         return E_NOTIMPL;
     }
 
-    const DWORD bytes = bits >> 3;
-    const DWORD channels = pBuffer->Format->nChannels;
+    self->Ratio = (FLOAT)pVoices->Frequencies[dwIndex] / (FLOAT)dwRequiredFrequency;
 
-    if (channels != 1 && channels != 2) {
-        return E_NOTIMPL;
-    }
+    // The fraction of an input frame left over by the previous period is where the interpolation resumes,
+    // so that the periods join without a step and the short periods of a low latency endpoint keep the pitch.
+    // The phase is stored back only when the position of the buffer moves by the consumed frames.
+    const FLOAT advance = pVoices->Phases[dwIndex] + self->Ratio * dwRequiredFrames;
 
-    HRESULT hr = S_OK;
-    const DWORD length = pBuffer->InActualFrames * STEREO * sizeof(FLOAT);
+    self->Phase = pVoices->Phases[dwIndex];
+    self->InFrames = (DWORD)truncf(advance);
+    self->EndPhase = advance - self->InFrames;
 
-    if (FAILED(hr = arena_allocate(self->Arena, length, &pBuffer->Intermediate))) {
-        return hr;
-    }
-
-    ZeroMemory(pBuffer->Intermediate, length);
-
-    DWORD offset = 0;
-
-    for (DWORD i = 0; i < pBuffer->InActualFrames; i++) {
-        if (channels == 1) {
-            const FLOAT v =
-                convert_to_float(bits, (LPVOID)((size_t)pBuffer->Input + offset));
-
-            pBuffer->Intermediate[i * STEREO + 0] = v;
-            pBuffer->Intermediate[i * STEREO + 1] = v;
-
-            offset += bytes;
-        }
-        else {
-            const FLOAT v1 =
-                convert_to_float(bits, (LPVOID)((size_t)pBuffer->Input + offset + 0));
-            const FLOAT v2 =
-                convert_to_float(bits, (LPVOID)((size_t)pBuffer->Input + offset + bytes));
+    // The last output frames interpolate towards the first frame of the next period.
+    self->InActualFrames = self->InFrames + 1;
+    self->OutFrames = dwRequiredFrames;
+    self->MaxFrames = dwRequiredFrames;
 
-            pBuffer->Intermediate[i * STEREO + 0] = v1;
-            pBuffer->Intermediate[i * STEREO + 1] = v2;
-
-            offset += bytes * channels;
-        }
-    }
+    self->Left = pVoices->Left[dwIndex];
+    self->Right = pVoices->Right[dwIndex];
 
     return S_OK;
 }
@@ -400,48 +408,3 @@ Algorithm Steps (General Outline):
     Conversion to Target Format:
     Convert the processed floating-point samples back to the desired PCM integer format and bit depth.
 */
-
-HRESULT DELTACALL mixer_resample(mixer* self, mb* pBuffer, DWORD dwFrequency) {
-    if (self == NULL) {
-        return E_POINTER;
-    }
-
-    if (pBuffer == NULL || dwFrequency == 0) {
-        return E_INVALIDARG;
-    }
-
-    if (pBuffer->Frequency == dwFrequency) {
-        // TODO better way of handling stuff. Just return won't do.
-    }
-
-    HRESULT hr = S_OK;
-    const DWORD frames = pBuffer->OutFrames;
-
-    if (FAILED(hr = arena_allocate(self->Arena,
-        frames * STEREO * sizeof(FLOAT), &pBuffer->Out))) {
-        return hr;
-    }
-
-    for (DWORD i = 0; i < frames; i++) {
-        for (DWORD j = 0; j < STEREO; j++) {
-            const FLOAT t = i * pBuffer->Ratio;
-
-            DWORD index0 = (DWORD)t;
-            DWORD index1 = index0 + 1;
-
-            // Handle edge case for the last sample.
-            if (index1 >= frames) {
-                index1 = frames - 1;
-                index0 = index1 - 1;
-            }
-
-            // Perform linear interpolation.
-            const FLOAT y0 = pBuffer->Intermediate[index0 * STEREO + j];
-            const FLOAT y1 = pBuffer->Intermediate[index1 * STEREO + j];
-
-            pBuffer->Out[i * STEREO + j] = linear_interpolate(y0, y1, t - index0);
-        }
-    }
-
-    return S_OK;
-}
@@ -24,12 +24,24 @@ SOFTWARE.
 
 #pragma once
 
-#include "dsb.h"
+#include "dstm.h"
+#include "dsvt.h"
+#include "kernel.h"
 
 typedef struct mixer mixer;
 
-HRESULT DELTACALL mixer_create(allocator* pAlloc, mixer** ppOut);
+// The stages of every mix are timed into the histograms, when given.
+HRESULT DELTACALL mixer_create(allocator* pAlloc, kernel* pKernel, dstm* pTiming, mixer** ppOut);
 VOID DELTACALL mixer_release(mixer* pMix);
 
-HRESULT DELTACALL mixer_mix(mixer* self, DWORD dwBuffers, dsb** ppBuffers,
-    PWAVEFORMATEXTENSIBLE pwfxFormat, DWORD dwRequiredFrames, LPVOID* pOutBuffer, LPDWORD pdwOutBufferBytes);
+HRESULT DELTACALL mixer_compact(mixer* pMix, LPDWORD pdwBytes);
+HRESULT DELTACALL mixer_reserve(mixer* pMix, DWORD dwVoices, DWORD dwFrequency, DWORD dwRequiredFrames);
+
+// The reservation for more voices is prepared on another thread and swapped in by the render thread, see arena_prepare.
+HRESULT DELTACALL mixer_prepare(mixer* pMix, DWORD dwVoices, DWORD dwFrequency, DWORD dwRequiredFrames, LPVOID* ppBlock);
+HRESULT DELTACALL mixer_swap(mixer* pMix, LPVOID* ppBlock);
+VOID DELTACALL mixer_discard(mixer* pMix, LPVOID pBlock);
+
+// Mixes the voices and writes up to dwRequiredFrames frames of the format straight into the output, usually the endpoint buffer.
+HRESULT DELTACALL mixer_mix(mixer* pMix, dsvt* pVoices, DWORD dwVoices, LPDWORD pdwVoices,
+    PWAVEFORMATEXTENSIBLE pwfxFormat, DWORD dwRequiredFrames, LPVOID pOutput, LPDWORD pdwOutFrames);
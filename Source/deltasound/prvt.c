@@ -24,8 +24,10 @@ SOFTWARE.
 
 #include "deltasound.h"
 #include "device_info.h"
+#include "dsdevice.h"
 #include "intfc.h"
 #include "prvt.h"
+#include "rtc.h"
 #include "uuid.h"
 
 #include <mmddk.h>
@@ -60,6 +62,11 @@ HRESULT DELTACALL prvt_enumerate_devices_ansi(prvt* pPrvt,
 HRESULT DELTACALL prvt_enumerate_devices_wide(prvt* pPrvt,
     PDSPROPERTY_DIRECTSOUNDDEVICE_ENUMERATE_W_DATA pPropertyData, ULONG ulDataLength, PULONG pulBytesReturned);
 
+HRESULT DELTACALL prvt_get_device_statistics(prvt* pPrvt,
+    PDSPROPERTY_DELTASOUND_DEVICE_DATA pPropertyData, ULONG ulDataLength, PULONG pulBytesReturned);
+HRESULT DELTACALL prvt_get_memory_statistics(prvt* pPrvt,
+    PDSPROPERTY_DELTASOUND_MEMORY_DATA pPropertyData, ULONG ulDataLength, PULONG pulBytesReturned);
+
 HRESULT DELTACALL prvt_create(allocator* pAlloc, REFIID riid, prvt** ppOut) {
     if (pAlloc == NULL || riid == NULL || ppOut == NULL) {
         return E_INVALIDARG;
@@ -202,6 +209,16 @@ HRESULT DELTACALL prvt_get(prvt* self,
                 (PDSPROPERTY_DIRECTSOUNDDEVICE_ENUMERATE_W_DATA)pPropertyData, ulDataLength, pulBytesReturned);
         }
     }
+    else if (IsEqualGUID(&DSPROPSETID_DeltaSound, rguidPropSet)) {
+        switch (ulId) {
+        case DSPROPERTY_DELTASOUND_DEVICE:
+            return prvt_get_device_statistics(self,
+                (PDSPROPERTY_DELTASOUND_DEVICE_DATA)pPropertyData, ulDataLength, pulBytesReturned);
+        case DSPROPERTY_DELTASOUND_MEMORY:
+            return prvt_get_memory_statistics(self,
+                (PDSPROPERTY_DELTASOUND_MEMORY_DATA)pPropertyData, ulDataLength, pulBytesReturned);
+        }
+    }
 
     return E_INVALIDARG;
 }
@@ -250,6 +267,16 @@ HRESULT DELTACALL prvt_query_support(prvt* self,
 
         return E_PROP_ID_UNSUPPORTED;
     }
+    else if (IsEqualGUID(&DSPROPSETID_DeltaSound, rguidPropSet)) {
+        switch (ulId) {
+        case DSPROPERTY_DELTASOUND_DEVICE:
+        case DSPROPERTY_DELTASOUND_MEMORY:
+            *pulTypeSupport = KSPROPERTY_SUPPORT_GET;
+            return S_OK;
+        }
+
+        return E_PROP_ID_UNSUPPORTED;
+    }
 
     return E_PROP_SET_UNSUPPORTED;
 }
@@ -958,3 +985,98 @@ HRESULT DELTACALL prvt_enumerate_devices_wide(prvt* self,
 
     return hr;
 }
+
+HRESULT DELTACALL prvt_get_device_statistics(prvt* self,
+    PDSPROPERTY_DELTASOUND_DEVICE_DATA pPropertyData, ULONG ulDataLength, PULONG pulBytesReturned) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (pPropertyData == NULL || ulDataLength < sizeof(DSPROPERTY_DELTASOUND_DEVICE_DATA)) {
+        return E_INVALIDARG;
+    }
+
+    HRESULT hr = S_OK;
+
+    device_info info;
+    ZeroMemory(&info, sizeof(device_info));
+
+    if (IsEqualGUID(&GUID_NULL, &pPropertyData->DeviceId)
+        || IsEqualGUID(&DSDEVID_DefaultPlayback, &pPropertyData->DeviceId)) {
+        hr = device_info_get_default_device(DEVICETYPE_RENDER, DEVICEKIND_MULTIMEDIA, &info);
+    }
+    else if (IsEqualGUID(&DSDEVID_DefaultVoicePlayback, &pPropertyData->DeviceId)) {
+        hr = device_info_get_default_device(DEVICETYPE_RENDER, DEVICEKIND_COMMUNICATION, &info);
+    }
+    else {
+        hr = device_info_get_device(DEVICETYPE_RENDER, &pPropertyData->DeviceId, &info);
+    }
+
+    if (FAILED(hr)) {
+        return DSERR_NODRIVER;
+    }
+
+    dsdevice* device = NULL;
+
+    // Only the devices a DirectSound object keeps open have statistics, none is opened for them.
+    if (deltasound_find_device(self->Instance, &info, &device) != S_OK) {
+        return DSERR_NODRIVER;
+    }
+
+    CopyMemory(&pPropertyData->DeviceId, &info.ID, sizeof(GUID));
+
+    pPropertyData->Latency = 0;
+    pPropertyData->Underruns = 0;
+    pPropertyData->Reclaimed = (DWORD64)device->Reclaimed;
+    pPropertyData->Periods = 0;
+    pPropertyData->MedianPeriod = 0;
+    pPropertyData->MaxPeriod = 0;
+
+    dsdevice_get_latency(device, &pPropertyData->Latency, &pPropertyData->Underruns);
+
+    {
+        dstm_histogram histogram;
+
+        if (SUCCEEDED(dsdevice_get_timing(device, DSTM_RENDER, &histogram)) && histogram.Frequency != 0) {
+            pPropertyData->Periods = histogram.Count;
+            pPropertyData->MedianPeriod = dstm_get_quantile(&histogram, 500) * 1000000 / histogram.Frequency;
+            pPropertyData->MaxPeriod = histogram.Max * 1000000 / histogram.Frequency;
+        }
+    }
+
+    deltasound_release_device(self->Instance, device);
+
+    if (pulBytesReturned != NULL) {
+        *pulBytesReturned = sizeof(DSPROPERTY_DELTASOUND_DEVICE_DATA);
+    }
+
+    return S_OK;
+}
+
+HRESULT DELTACALL prvt_get_memory_statistics(prvt* self,
+    PDSPROPERTY_DELTASOUND_MEMORY_DATA pPropertyData, ULONG ulDataLength, PULONG pulBytesReturned) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (pPropertyData == NULL || ulDataLength < sizeof(DSPROPERTY_DELTASOUND_MEMORY_DATA)) {
+        return E_INVALIDARG;
+    }
+
+    HRESULT hr = S_OK;
+    allocator_stats stats;
+
+    if (SUCCEEDED(hr = allocator_get_stats(self->Instance->Allocator, &stats))) {
+        pPropertyData->LiveBytes = stats.LiveBytes;
+        pPropertyData->PeakBytes = stats.PeakBytes;
+        pPropertyData->Allocations = stats.Allocations;
+        pPropertyData->Frees = stats.Frees;
+        pPropertyData->Violations = rtc_get_violation_count();
+
+        if (pulBytesReturned != NULL) {
+            *pulBytesReturned = sizeof(DSPROPERTY_DELTASOUND_MEMORY_DATA);
+        }
+    }
+
+    return hr;
+}
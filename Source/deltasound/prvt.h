@@ -29,6 +29,28 @@ SOFTWARE.
 typedef struct deltasound deltasound;
 typedef struct intfc intfc;
 
+// The diagnostics of DeltaSound, in a property set of its own next to the one of the devices.
+#define DSPROPERTY_DELTASOUND_DEVICE    0
+#define DSPROPERTY_DELTASOUND_MEMORY    1
+
+typedef struct DSPROPERTY_DELTASOUND_DEVICE_DATA {
+    GUID        DeviceId;       // Of an open render endpoint, the default one when null
+    DWORD       Latency;        // In milliseconds, queued ahead of the endpoint
+    DWORD64     Underruns;
+    DWORD64     Reclaimed;      // In bytes, released by compaction
+    DWORD64     Periods;        // Timed, none unless the build measures the render timing
+    DWORD64     MedianPeriod;   // In microseconds
+    DWORD64     MaxPeriod;      // In microseconds
+} DSPROPERTY_DELTASOUND_DEVICE_DATA, *PDSPROPERTY_DELTASOUND_DEVICE_DATA;
+
+typedef struct DSPROPERTY_DELTASOUND_MEMORY_DATA {
+    DWORD64     LiveBytes;
+    DWORD64     PeakBytes;
+    DWORD64     Allocations;
+    DWORD64     Frees;
+    DWORD64     Violations;     // Of the realtime rules by the render threads, counted in debug builds
+} DSPROPERTY_DELTASOUND_MEMORY_DATA, *PDSPROPERTY_DELTASOUND_MEMORY_DATA;
+
 typedef struct prvt {
     allocator*          Allocator;
     IID                 ID;
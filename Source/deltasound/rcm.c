@@ -24,14 +24,31 @@ SOFTWARE.
 
 #include "rcm.h"
 
+#define RCM_LAZY_THRESHOLD      (1024 * 1024)
+#define RCM_GRANULE_SIZE        (64 * 1024)
+#define RCM_GRANULE_BITS        32
+
+#define PADDED(X)   (((X) + ALLOCATOR_SAMPLE_ALIGNMENT - 1) & ~(ALLOCATOR_SAMPLE_ALIGNMENT - 1))
+#define GRANULES(X) (((X) + RCM_GRANULE_SIZE - 1) / RCM_GRANULE_SIZE)
+
+#define ISCOMMITTED(SELF, GRANULE) \
+    (ReadNoFence(&(SELF)->Committed[(GRANULE) / RCM_GRANULE_BITS]) & (LONG)(1U << ((GRANULE) % RCM_GRANULE_BITS)))
+
+// The buffer is aligned and padded to the sample alignment, the padding is not part of its size.
+// Large buffers only reserve their address space, the granules are committed as they are written,
+// and the ones that were never committed read as zeroes.
 typedef struct rcm {
-    allocator*  Allocator;
-    LONG        RefCount;
+    allocator*      Allocator;
+    LONG            RefCount;
 
-    LPVOID      Buffer;
-    DWORD       Size;
+    LPVOID          Buffer;
+    DWORD           Size;
+
+    volatile LONG*  Committed;
 } rcm;
 
+HRESULT DELTACALL rcm_reserve(rcm* pMem, DWORD dwBytes);
+
 HRESULT DELTACALL rcm_create(allocator* pAlloc, DWORD dwBytes, rcm** ppOut) {
     if (pAlloc == NULL || ppOut == NULL) {
         return E_INVALIDARG;
@@ -43,7 +60,12 @@ HRESULT DELTACALL rcm_create(allocator* pAlloc, DWORD dwBytes, rcm** ppOut) {
     if (SUCCEEDED(hr = allocator_allocate(pAlloc, sizeof(rcm), &instance))) {
         instance->Allocator = pAlloc;
 
-        if (SUCCEEDED(hr = allocator_allocate(pAlloc, dwBytes, &instance->Buffer))) {
+        if (PADDED(dwBytes) < dwBytes) {
+            hr = E_OUTOFMEMORY;
+        }
+        else if (SUCCEEDED(hr = RCM_LAZY_THRESHOLD <= dwBytes
+            ? rcm_reserve(instance, dwBytes)
+            : allocator_allocate_aligned(pAlloc, PADDED(dwBytes), ALLOCATOR_SAMPLE_ALIGNMENT, &instance->Buffer))) {
             instance->RefCount = 1;
             instance->Size = dwBytes;
 
@@ -61,7 +83,14 @@ HRESULT DELTACALL rcm_create(allocator* pAlloc, DWORD dwBytes, rcm** ppOut) {
 VOID DELTACALL rcm_release(rcm* self) {
     if (self == NULL) { return; }
 
-    allocator_free(self->Allocator, self->Buffer);
+    if (self->Committed != NULL) {
+        VirtualFree(self->Buffer, 0, MEM_RELEASE);
+        allocator_free(self->Allocator, (LPVOID)self->Committed);
+    }
+    else {
+        allocator_free_aligned(self->Allocator, self->Buffer);
+    }
+
     allocator_free(self->Allocator, self);
 }
 
@@ -120,3 +149,119 @@ HRESULT DELTACALL rcm_get_length(rcm* self, LPDWORD pdwBytes) {
 
     return S_OK;
 }
+
+HRESULT DELTACALL rcm_get_references(rcm* self, LPDWORD pdwCount) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (pdwCount == NULL) {
+        return E_INVALIDARG;
+    }
+
+    *pdwCount = (DWORD)self->RefCount;
+
+    return S_OK;
+}
+
+HRESULT DELTACALL rcm_commit(rcm* self, DWORD dwOffset, DWORD dwBytes) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (self->Size < dwOffset || self->Size - dwOffset < dwBytes) {
+        return E_INVALIDARG;
+    }
+
+    if (self->Committed == NULL || dwBytes == 0) {
+        return S_OK;
+    }
+
+    const DWORD last = (dwOffset + dwBytes - 1) / RCM_GRANULE_SIZE;
+
+    // Consecutive granules that are not committed yet are committed together.
+    for (DWORD i = dwOffset / RCM_GRANULE_SIZE; i <= last; i++) {
+        if (ISCOMMITTED(self, i)) {
+            continue;
+        }
+
+        DWORD count = 1;
+
+        while (i + count <= last && !ISCOMMITTED(self, i + count)) {
+            count++;
+        }
+
+        if (VirtualAlloc((LPVOID)((size_t)self->Buffer + (size_t)i * RCM_GRANULE_SIZE),
+            (SIZE_T)count * RCM_GRANULE_SIZE, MEM_COMMIT, PAGE_READWRITE) == NULL) {
+            return E_OUTOFMEMORY;
+        }
+
+        for (DWORD k = i; k < i + count; k++) {
+            InterlockedOr(&self->Committed[k / RCM_GRANULE_BITS], (LONG)(1U << (k % RCM_GRANULE_BITS)));
+        }
+
+        i += count - 1;
+    }
+
+    return S_OK;
+}
+
+HRESULT DELTACALL rcm_read(rcm* self, DWORD dwOffset, DWORD dwBytes, LPVOID pData) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (pData == NULL || self->Size < dwOffset || self->Size - dwOffset < dwBytes) {
+        return E_INVALIDARG;
+    }
+
+    if (self->Committed == NULL) {
+        CopyMemory(pData, (LPVOID)((size_t)self->Buffer + dwOffset), dwBytes);
+        return S_OK;
+    }
+
+    DWORD offset = 0;
+
+    while (offset < dwBytes) {
+        const DWORD position = dwOffset + offset;
+        const DWORD granule = position / RCM_GRANULE_SIZE;
+        const DWORD bytes = min(dwBytes - offset, (granule + 1) * RCM_GRANULE_SIZE - position);
+
+        if (ISCOMMITTED(self, granule)) {
+            CopyMemory((LPVOID)((size_t)pData + offset), (LPVOID)((size_t)self->Buffer + position), bytes);
+        }
+        else {
+            ZeroMemory((LPVOID)((size_t)pData + offset), bytes);
+        }
+
+        offset += bytes;
+    }
+
+    return S_OK;
+}
+
+/* ---------------------------------------------------------------------- */
+
+HRESULT DELTACALL rcm_reserve(rcm* self, DWORD dwBytes) {
+    const DWORD granules = GRANULES(dwBytes);
+
+    HRESULT hr = S_OK;
+    LPVOID committed = NULL;
+
+    if (FAILED(hr = allocator_allocate(self->Allocator,
+        (granules + RCM_GRANULE_BITS - 1) / RCM_GRANULE_BITS * sizeof(LONG), &committed))) {
+        return hr;
+    }
+
+    // The reservation is granule aligned, so it satisfies the sample alignment as well.
+    self->Buffer = VirtualAlloc(NULL, (SIZE_T)granules * RCM_GRANULE_SIZE, MEM_RESERVE, PAGE_READWRITE);
+
+    if (self->Buffer == NULL) {
+        allocator_free(self->Allocator, committed);
+        return E_OUTOFMEMORY;
+    }
+
+    self->Committed = (volatile LONG*)committed;
+
+    return S_OK;
+}
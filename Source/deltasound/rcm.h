@@ -36,3 +36,7 @@ HRESULT DELTACALL rcm_remove_ref(rcm* pMem);
 
 HRESULT DELTACALL rcm_get_data(rcm* pMem, LPVOID* ppData);
 HRESULT DELTACALL rcm_get_length(rcm* pMem, LPDWORD pdwBytes);
+HRESULT DELTACALL rcm_get_references(rcm* pMem, LPDWORD pdwCount);
+
+HRESULT DELTACALL rcm_commit(rcm* pMem, DWORD dwOffset, DWORD dwBytes);
+HRESULT DELTACALL rcm_read(rcm* pMem, DWORD dwOffset, DWORD dwBytes, LPVOID pData);
@@ -0,0 +1,96 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "rtc.h"
+
+#include <intrin.h>
+#include <stdio.h>
+
+#undef EnterCriticalSection
+
+#define MAX_REPORT_LENGTH   256
+
+static __declspec(thread) DWORD Depth;
+
+static volatile LONG64 Violations;
+
+VOID DELTACALL rtc_enter(VOID) {
+    Depth++;
+}
+
+VOID DELTACALL rtc_leave(VOID) {
+    if (Depth != 0) {
+        Depth--;
+    }
+}
+
+DWORD DELTACALL rtc_suspend(VOID) {
+    const DWORD depth = Depth;
+
+    Depth = 0;
+
+    return depth;
+}
+
+VOID DELTACALL rtc_resume(DWORD dwDepth) {
+    Depth = dwDepth;
+}
+
+VOID DELTACALL rtc_check(LPCSTR pszOperation, LPCVOID pCaller) {
+    if (Depth == 0) {
+        return;
+    }
+
+    InterlockedIncrement64(&Violations);
+
+    // The report is formatted on the stack, so that it does not allocate or lock by itself.
+    CHAR line[MAX_REPORT_LENGTH];
+    HMODULE module = NULL;
+
+    if (pCaller != NULL && GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS
+        | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, (LPCSTR)pCaller, &module)) {
+        snprintf(line, MAX_REPORT_LENGTH, "DeltaSound: %s in a real-time section, from module 0x%p + 0x%zx\n",
+            pszOperation, (LPVOID)module, (size_t)pCaller - (size_t)module);
+    }
+    else {
+        snprintf(line, MAX_REPORT_LENGTH, "DeltaSound: %s in a real-time section, from 0x%p\n",
+            pszOperation, pCaller);
+    }
+
+    OutputDebugStringA(line);
+
+    if (IsDebuggerPresent()) {
+        DebugBreak();
+    }
+}
+
+VOID DELTACALL rtc_enter_critical_section(LPCRITICAL_SECTION pLock) {
+    rtc_check("Lock", _ReturnAddress());
+
+    EnterCriticalSection(pLock);
+}
+
+DWORD64 DELTACALL rtc_get_violation_count(VOID) {
+    return (DWORD64)Violations;
+}
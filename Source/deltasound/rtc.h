@@ -0,0 +1,46 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "base.h"
+
+// The real-time checker reports the allocations and, in debug builds, the locks
+// made by a thread while it is inside a real-time section, such as a render period.
+// A report is written to the debugger output, and breaks into the debugger when one is attached.
+
+VOID DELTACALL rtc_enter(VOID);
+VOID DELTACALL rtc_leave(VOID);
+
+DWORD DELTACALL rtc_suspend(VOID);
+VOID DELTACALL rtc_resume(DWORD dwDepth);
+
+VOID DELTACALL rtc_check(LPCSTR pszOperation, LPCVOID pCaller);
+VOID DELTACALL rtc_enter_critical_section(LPCRITICAL_SECTION pLock);
+
+DWORD64 DELTACALL rtc_get_violation_count(VOID);
+
+#ifdef _DEBUG
+#define EnterCriticalSection(X)     rtc_enter_critical_section(X)
+#endif
@@ -0,0 +1,150 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "rtp.h"
+
+#include <avrt.h>
+
+#include <float.h>
+#include <stdio.h>
+
+#define MAX_REPORT_LENGTH   256
+
+const static LPCSTR rtp_tasks[] = {
+    NULL,           // CONFIG_MMCSS_TASK_NONE
+    "Pro Audio",    // CONFIG_MMCSS_TASK_PRO_AUDIO
+    "Games"         // CONFIG_MMCSS_TASK_GAMES
+};
+
+const static AVRT_PRIORITY rtp_priorities[] = {
+    AVRT_PRIORITY_LOW,      // CONFIG_MMCSS_PRIORITY_LOW
+    AVRT_PRIORITY_NORMAL,   // CONFIG_MMCSS_PRIORITY_NORMAL
+    AVRT_PRIORITY_HIGH,     // CONFIG_MMCSS_PRIORITY_HIGH
+    AVRT_PRIORITY_CRITICAL  // CONFIG_MMCSS_PRIORITY_CRITICAL
+};
+
+const static LPCSTR rtp_priority_names[] = {
+    "low", "normal", "high", "critical"
+};
+
+VOID DELTACALL rtp_report(rtp* pPolicy, const config* pConfig, LPCSTR pszThread);
+
+HRESULT DELTACALL rtp_enter(rtp* self, const config* pConfig, LPCSTR pszThread) {
+    if (self == NULL || pConfig == NULL || pszThread == NULL) {
+        return E_POINTER;
+    }
+
+    ZeroMemory(self, sizeof(rtp));
+
+    if (pConfig->MmcssTask < _countof(rtp_tasks) && rtp_tasks[pConfig->MmcssTask] != NULL) {
+        self->Task = AvSetMmThreadCharacteristicsA(rtp_tasks[pConfig->MmcssTask], &self->TaskIndex);
+
+        if (self->Task == NULL) {
+            self->TaskError = GetLastError();
+        }
+        else if (pConfig->MmcssPriority < _countof(rtp_priorities)) {
+            AvSetMmThreadPriority(self->Task, rtp_priorities[pConfig->MmcssPriority]);
+        }
+    }
+
+    // Without the MMCSS registration, e.g. with the service stopped, the thread raises its own priority.
+    if (self->Task == NULL) {
+        SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+    }
+
+    if (pConfig->Affinity != 0) {
+        if (SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)pConfig->Affinity) != 0) {
+            self->Affinity = pConfig->Affinity;
+        }
+    }
+
+    if (pConfig->FlushDenormals) {
+        UINT control = 0;
+
+        if (_controlfp_s(&self->Control, 0, 0) == 0 && _controlfp_s(&control, _DN_FLUSH, _MCW_DN) == 0) {
+            self->FlushDenormals = TRUE;
+        }
+    }
+
+    rtp_report(self, pConfig, pszThread);
+
+    return S_OK;
+}
+
+VOID DELTACALL rtp_leave(rtp* self) {
+    if (self == NULL) {
+        return;
+    }
+
+    if (self->FlushDenormals) {
+        UINT control = 0;
+
+        _controlfp_s(&control, self->Control, _MCW_DN);
+
+        self->FlushDenormals = FALSE;
+    }
+
+    if (self->Task != NULL) {
+        AvRevertMmThreadCharacteristics(self->Task);
+
+        self->Task = NULL;
+    }
+}
+
+/* ---------------------------------------------------------------------- */
+
+VOID DELTACALL rtp_report(rtp* self, const config* pConfig, LPCSTR pszThread) {
+    CHAR scheduling[MAX_REPORT_LENGTH];
+    CHAR affinity[MAX_REPORT_LENGTH];
+
+    if (self->Task != NULL) {
+        snprintf(scheduling, MAX_REPORT_LENGTH, "in the MMCSS task \"%s\" at %s priority",
+            rtp_tasks[pConfig->MmcssTask], pConfig->MmcssPriority < _countof(rtp_priority_names)
+            ? rtp_priority_names[pConfig->MmcssPriority] : rtp_priority_names[CONFIG_MMCSS_PRIORITY_NORMAL]);
+    }
+    else if (self->TaskError != 0) {
+        snprintf(scheduling, MAX_REPORT_LENGTH,
+            "at the time critical priority, the MMCSS registration failed with error %lu", self->TaskError);
+    }
+    else {
+        snprintf(scheduling, MAX_REPORT_LENGTH, "at the time critical priority");
+    }
+
+    if (self->Affinity != 0) {
+        snprintf(affinity, MAX_REPORT_LENGTH, "on processors 0x%llx", self->Affinity);
+    }
+    else if (pConfig->Affinity != 0) {
+        snprintf(affinity, MAX_REPORT_LENGTH, "on any processor, the mask 0x%llx was refused", pConfig->Affinity);
+    }
+    else {
+        snprintf(affinity, MAX_REPORT_LENGTH, "on any processor");
+    }
+
+    CHAR line[MAX_REPORT_LENGTH * 3];
+
+    snprintf(line, _countof(line), "DeltaSound: %s thread %s, %s, denormals %s\n",
+        pszThread, scheduling, affinity, self->FlushDenormals ? "flushed to zero" : "preserved");
+
+    OutputDebugStringA(line);
+}
@@ -0,0 +1,43 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include "config.h"
+
+// The real-time policy of a thread: the MMCSS task or the priority it runs at, the processors it runs on,
+// and whether it flushes denormal numbers to zero. The policy is applied by the thread itself,
+// and what was applied is written to the debugger output.
+
+typedef struct rtp {
+    HANDLE  Task;           // MMCSS registration, NULL when the thread runs at the time critical priority instead
+    DWORD   TaskIndex;
+    DWORD   TaskError;      // Error of the MMCSS registration, zero when it succeeded or was not requested
+    DWORD64 Affinity;       // None when zero
+    BOOL    FlushDenormals;
+    UINT    Control;        // Floating point control word before the denormals were flushed
+} rtp;
+
+HRESULT DELTACALL rtp_enter(rtp* pPolicy, const config* pConfig, LPCSTR pszThread);
+VOID DELTACALL rtp_leave(rtp* pPolicy);
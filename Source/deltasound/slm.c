@@ -0,0 +1,280 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "slm.h"
+
+#define DEFAULT_CAPACITY            8
+#define DEFAULT_CAPACITY_MULTIPLIER 2
+
+#define SLOT_NONE                   ((DWORD)-1)
+
+// The generation of a slot is odd while it holds an item, and is advanced on removal,
+// so handles to removed items never validate, even after their slot is reused.
+#define MAKEHANDLE(INDEX, GENERATION) (((DWORD64)(GENERATION) << 32) | (INDEX))
+#define HANDLEINDEX(X)                ((DWORD)(X))
+#define HANDLEGENERATION(X)           ((DWORD)((X) >> 32))
+
+typedef struct slot {
+    DWORD   Generation;
+    DWORD   Index;      // Dense index of the item, or the next free slot.
+} slot;
+
+struct slm {
+    allocator*          Allocator;
+    CRITICAL_SECTION    Lock;
+
+    DWORD               Count;
+    DWORD               Capacity;
+
+    LPVOID*             Items;  // Dense
+    LPDWORD             Owners; // Slot of each dense item
+
+    slot*               Slots;
+    DWORD               SlotCount;
+    DWORD               Free;
+};
+
+HRESULT DELTACALL slm_resize(slm* pMap);
+
+HRESULT DELTACALL slm_create(allocator* pAlloc, slm** ppOut) {
+    if (pAlloc == NULL || ppOut == NULL) {
+        return E_INVALIDARG;
+    }
+
+    HRESULT hr = S_OK;
+    slm* instance = NULL;
+
+    if (SUCCEEDED(hr = allocator_allocate(pAlloc, sizeof(slm), &instance))) {
+        instance->Allocator = pAlloc;
+
+        instance->Capacity = DEFAULT_CAPACITY;
+        instance->Free = SLOT_NONE;
+
+        if (SUCCEEDED(hr = allocator_allocate(pAlloc,
+            instance->Capacity * sizeof(LPVOID), (LPVOID*)&instance->Items))) {
+            if (SUCCEEDED(hr = allocator_allocate(pAlloc,
+                instance->Capacity * sizeof(DWORD), &instance->Owners))) {
+                if (SUCCEEDED(hr = allocator_allocate(pAlloc,
+                    instance->Capacity * sizeof(slot), &instance->Slots))) {
+                    InitializeCriticalSection(&instance->Lock);
+
+                    *ppOut = instance;
+
+                    return S_OK;
+                }
+
+                allocator_free(pAlloc, instance->Owners);
+            }
+
+            allocator_free(pAlloc, instance->Items);
+        }
+
+        allocator_free(pAlloc, instance);
+    }
+
+    return hr;
+}
+
+VOID DELTACALL slm_release(slm* self) {
+    if (self == NULL) { return; }
+
+    DeleteCriticalSection(&self->Lock);
+
+    allocator_free(self->Allocator, self->Slots);
+    allocator_free(self->Allocator, self->Owners);
+    allocator_free(self->Allocator, self->Items);
+    allocator_free(self->Allocator, self);
+}
+
+HRESULT DELTACALL slm_add_item(slm* self, LPVOID pItem, PDWORD64 pqwHandle) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (pItem == NULL || pqwHandle == NULL) {
+        return E_INVALIDARG;
+    }
+
+    EnterCriticalSection(&self->Lock);
+
+    if (self->Capacity < self->Count + 1) {
+        HRESULT hr = S_OK;
+        if (FAILED(hr = slm_resize(self))) {
+            LeaveCriticalSection(&self->Lock);
+            return hr;
+        }
+    }
+
+    DWORD index = self->Free;
+
+    if (index != SLOT_NONE) {
+        self->Free = self->Slots[index].Index;
+    }
+    else {
+        index = self->SlotCount;
+        self->SlotCount++;
+    }
+
+    slot* item = &self->Slots[index];
+
+    item->Generation++;
+    item->Index = self->Count;
+
+    self->Items[self->Count] = pItem;
+    self->Owners[self->Count] = index;
+
+    self->Count++;
+
+    *pqwHandle = MAKEHANDLE(index, item->Generation);
+
+    LeaveCriticalSection(&self->Lock);
+
+    return S_OK;
+}
+
+HRESULT DELTACALL slm_get_item(slm* self, DWORD64 qwHandle, LPVOID* ppItem) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (ppItem == NULL) {
+        return E_INVALIDARG;
+    }
+
+    HRESULT hr = E_INVALIDARG;
+
+    EnterCriticalSection(&self->Lock);
+
+    const DWORD index = HANDLEINDEX(qwHandle);
+
+    if (index < self->SlotCount
+        && self->Slots[index].Generation == HANDLEGENERATION(qwHandle)
+        && (self->Slots[index].Generation & 1)) {
+        *ppItem = self->Items[self->Slots[index].Index];
+
+        hr = S_OK;
+    }
+
+    LeaveCriticalSection(&self->Lock);
+
+    return hr;
+}
+
+HRESULT DELTACALL slm_get_item_at(slm* self, DWORD dwIndex, LPVOID* ppItem) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    if (self->Count < dwIndex + 1 || ppItem == NULL) {
+        return E_INVALIDARG;
+    }
+
+    EnterCriticalSection(&self->Lock);
+
+    *ppItem = self->Items[dwIndex];
+
+    LeaveCriticalSection(&self->Lock);
+
+    return S_OK;
+}
+
+HRESULT DELTACALL slm_remove_item(slm* self, DWORD64 qwHandle, LPVOID* ppItem) {
+    if (self == NULL) {
+        return E_POINTER;
+    }
+
+    HRESULT hr = E_INVALIDARG;
+
+    EnterCriticalSection(&self->Lock);
+
+    const DWORD index = HANDLEINDEX(qwHandle);
+
+    if (index < self->SlotCount
+        && self->Slots[index].Generation == HANDLEGENERATION(qwHandle)
+        && (self->Slots[index].Generation & 1)) {
+        slot* item = &self->Slots[index];
+
+        const DWORD position = item->Index;
+        const DWORD last = self->Count - 1;
+
+        if (ppItem != NULL) {
+            *ppItem = self->Items[position];
+        }
+
+        // The last item takes the place of the removed one, so the items stay dense.
+        if (position != last) {
+            self->Items[position] = self->Items[last];
+            self->Owners[position] = self->Owners[last];
+
+            self->Slots[self->Owners[position]].Index = position;
+        }
+
+        self->Count--;
+
+        item->Generation++;
+        item->Index = self->Free;
+
+        self->Free = index;
+
+        hr = S_OK;
+    }
+
+    LeaveCriticalSection(&self->Lock);
+
+    return hr;
+}
+
+DWORD DELTACALL slm_get_count(slm* self) {
+    return self == NULL ? 0 : self->Count;
+}
+
+/* ---------------------------------------------------------------------- */
+
+HRESULT DELTACALL slm_resize(slm* self) {
+    HRESULT hr = S_OK;
+
+    const DWORD capacity = max(self->Capacity, 1) * DEFAULT_CAPACITY_MULTIPLIER;
+
+    if (FAILED(hr = allocator_reallocate(self->Allocator,
+        self->Items, capacity * sizeof(LPVOID), (LPVOID*)&self->Items))) {
+        return hr;
+    }
+
+    if (FAILED(hr = allocator_reallocate(self->Allocator,
+        self->Owners, capacity * sizeof(DWORD), (LPVOID*)&self->Owners))) {
+        return hr;
+    }
+
+    if (FAILED(hr = allocator_reallocate(self->Allocator,
+        self->Slots, capacity * sizeof(slot), (LPVOID*)&self->Slots))) {
+        return hr;
+    }
+
+    // New slots start with an even generation, that is, empty.
+    ZeroMemory(&self->Slots[self->Capacity], (capacity - self->Capacity) * sizeof(slot));
+
+    self->Capacity = capacity;
+
+    return hr;
+}
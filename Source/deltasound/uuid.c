@@ -35,6 +35,9 @@ const CLSID CLSID_IMMDeviceEnumerator =
 const IID IID_IAudioClient =
 { 0x1CB9AD4C, 0xDBFA, 0x4C32, { 0xB1, 0x78, 0xC2, 0xF5, 0x68, 0xA7, 0x03, 0xB2 } };
 
+const IID IID_IAudioClient3 =
+{ 0x7ED4EE07, 0x8E67, 0x4CD4, { 0x8C, 0x1A, 0x2B, 0x7A, 0x59, 0x87, 0xAD, 0x42 } };
+
 const IID IID_IAudioRenderClient =
 { 0xF294ACFC, 0x3146, 0x4483, { 0xA7, 0xBF, 0xAD, 0xDC, 0xA7, 0xC2, 0x60, 0xE2 } };
 
@@ -50,8 +53,14 @@ const IID IID_IMMDeviceEnumerator =
 const GUID KSDATAFORMAT_SUBTYPE_IEEE_FLOAT =
 { 0x00000003, 0x0000, 0x0010, { 0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71 } };
 
+const GUID KSDATAFORMAT_SUBTYPE_PCM =
+{ 0x00000001, 0x0000, 0x0010, { 0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71 } };
+
 const GUID DSPROPSETID_DirectSoundDevice =
 { 0x84624F82, 0x25EC, 0x11D1, { 0xA4, 0xD8, 0x00, 0xC0, 0x4F, 0xC2, 0x8A, 0xCA } };
 
+const GUID DSPROPSETID_DeltaSound =
+{ 0xA7B81E37, 0x2CA0, 0x464C, { 0xAD, 0xF7, 0xAD, 0x9C, 0x3F, 0x7A, 0x3D, 0xFD } };
+
 const IID IID_IMMEndpoint =
 { 0x1BE09788, 0x6894, 0x4089, { 0x85, 0x86, 0x9A, 0x2A, 0x6C, 0x26, 0x5A, 0xC5 } };
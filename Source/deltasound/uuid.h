@@ -28,7 +28,10 @@ SOFTWARE.
 
 extern const CLSID CLSID_IMMDeviceEnumerator;
 extern const IID IID_IAudioClient;
+extern const IID IID_IAudioClient3;
 extern const IID IID_IAudioRenderClient;
 extern const IID IID_IAudioStreamVolume;
 extern const IID IID_IDirectSoundPrivate;
 extern const IID IID_IMMDeviceEnumerator;
+
+extern const GUID DSPROPSETID_DeltaSound;
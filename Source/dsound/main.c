@@ -42,7 +42,13 @@ BOOL WINAPI DllMain(HINSTANCE hinstDLL, DWORD fdwReason, LPVOID lpvReserved) {
     case DLL_PROCESS_ATTACH: {
         DisableThreadLibraryCalls(hinstDLL);
 
-        if (SUCCEEDED(allocator_create(&alc))) {
+        config settings;
+        config_initialize(&settings);
+
+        const DWORD flags = (settings.SlabAllocator ? ALLOCATOR_CREATE_SLAB : ALLOCATOR_CREATE_NONE)
+            | (settings.AllocatorTracking ? ALLOCATOR_CREATE_TRACK : ALLOCATOR_CREATE_NONE);
+
+        if (SUCCEEDED(allocator_create(flags, &alc))) {
             if (SUCCEEDED(deltasound_create(alc, &delta))) {
                 return TRUE;
             }
@@ -64,6 +70,11 @@ BOOL WINAPI DllMain(HINSTANCE hinstDLL, DWORD fdwReason, LPVOID lpvReserved) {
         if (lpvReserved == NULL) {
             cleanup();
         }
+        else {
+            // The process is terminating, so nothing is released,
+            // but whatever is still allocated is reported.
+            allocator_dump(alc);
+        }
 
         break;
     }
@@ -40,6 +40,10 @@ const GUID KSDATAFORMAT_SUBTYPE_IEEE_FLOAT = {
     0x0000003, 0x0000, 0x0010, { 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 }
 };
 
+const GUID DSPROPSETID_DeltaSound = {
+    0xA7B81E37, 0x2CA0, 0x464C, { 0xAD, 0xF7, 0xAD, 0x9C, 0x3F, 0x7A, 0x3D, 0xFD }
+};
+
 LPDIRECTSOUNDCREATE GetDirectSoundCreate(HMODULE module) {
     if (module == NULL) {
         return NULL;
@@ -64,6 +68,55 @@ LPFNGETCLASSOBJECT GetDllGetClassObject(HMODULE module) {
     return (LPFNGETCLASSOBJECT)GetProcAddress(module, "DllGetClassObject");
 }
 
+LPKSPROPERTYSET GetDeltaSoundPropertySet(HMODULE module) {
+    LPFNGETCLASSOBJECT gco = GetDllGetClassObject(module);
+
+    if (gco == NULL) {
+        return NULL;
+    }
+
+    LPCLASSFACTORY cf = NULL;
+    LPKSPROPERTYSET ksp = NULL;
+
+    if (SUCCEEDED(gco(&CLSID_DirectSoundPrivate, &IID_IClassFactory, &cf))) {
+        if (SUCCEEDED(IClassFactory_CreateInstance(cf, NULL, &IID_IKsPropertySet, &ksp))) {
+            ULONG support = 0;
+
+            if (FAILED(IKsPropertySet_QuerySupport(ksp, &DSPROPSETID_DeltaSound, DSPROPERTY_DELTASOUND_MEMORY, &support))
+                || !(support & KSPROPERTY_SUPPORT_GET)) {
+                RELEASE(ksp);
+            }
+        }
+    }
+
+    RELEASE(cf);
+
+    return ksp;
+}
+
+HRESULT GetDeltaSoundMemory(HMODULE module, PDSPROPERTY_DELTASOUND_MEMORY_DATA pData) {
+    if (pData == NULL) {
+        return E_POINTER;
+    }
+
+    LPKSPROPERTYSET ksp = GetDeltaSoundPropertySet(module);
+
+    if (ksp == NULL) {
+        return E_NOTIMPL;
+    }
+
+    ZeroMemory(pData, sizeof(DSPROPERTY_DELTASOUND_MEMORY_DATA));
+
+    ULONG length = 0;
+
+    const HRESULT hr = IKsPropertySet_Get(ksp, &DSPROPSETID_DeltaSound, DSPROPERTY_DELTASOUND_MEMORY,
+        NULL, 0, pData, sizeof(DSPROPERTY_DELTASOUND_MEMORY_DATA), &length);
+
+    RELEASE(ksp);
+
+    return hr;
+}
+
 HRESULT InitializeWaveFormat(LPWAVEFORMATEX self, DWORD dwChannels, DWORD dwFrequency, DWORD dwBits) {
     if (self == NULL) {
         return E_POINTER;
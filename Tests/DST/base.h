@@ -49,12 +49,40 @@ const extern DWORD BufferPlayFlags[BUFFER_PLAY_FLAGS_COUNT];
 const extern IID IID_IDirectSoundPrivate;
 const extern GUID KSDATAFORMAT_SUBTYPE_IEEE_FLOAT;
 
+// The diagnostics DeltaSound reports through the private property set, the system DirectSound has none.
+const extern GUID DSPROPSETID_DeltaSound;
+
+#define DSPROPERTY_DELTASOUND_DEVICE    0
+#define DSPROPERTY_DELTASOUND_MEMORY    1
+
+typedef struct DSPROPERTY_DELTASOUND_DEVICE_DATA {
+    GUID        DeviceId;
+    DWORD       Latency;
+    DWORD64     Underruns;
+    DWORD64     Reclaimed;
+    DWORD64     Periods;
+    DWORD64     MedianPeriod;
+    DWORD64     MaxPeriod;
+} DSPROPERTY_DELTASOUND_DEVICE_DATA, *PDSPROPERTY_DELTASOUND_DEVICE_DATA;
+
+typedef struct DSPROPERTY_DELTASOUND_MEMORY_DATA {
+    DWORD64     LiveBytes;
+    DWORD64     PeakBytes;
+    DWORD64     Allocations;
+    DWORD64     Frees;
+    DWORD64     Violations;
+} DSPROPERTY_DELTASOUND_MEMORY_DATA, *PDSPROPERTY_DELTASOUND_MEMORY_DATA;
+
 typedef IReferenceClock* LPREFERENCECLOCK;
 
 LPDIRECTSOUNDCREATE GetDirectSoundCreate(HMODULE module);
 LPDIRECTSOUNDCAPTURECREATE GetDirectSoundCaptureCreate(HMODULE module);
 LPFNGETCLASSOBJECT GetDllGetClassObject(HMODULE module);
 
+// Returns the private property set of the module when it reports the DeltaSound diagnostics, NULL otherwise.
+LPKSPROPERTYSET GetDeltaSoundPropertySet(HMODULE module);
+HRESULT GetDeltaSoundMemory(HMODULE module, PDSPROPERTY_DELTASOUND_MEMORY_DATA pData);
+
 HRESULT InitializeWaveFormat(LPWAVEFORMATEX pwfxFormat, DWORD dwChannels, DWORD dwFrequency, DWORD dwBits);
 
 HRESULT InitializeDirectSoundBufferDesc(LPDSBUFFERDESC pDSBD,
@@ -27,6 +27,8 @@ SOFTWARE.
 #include "base.h"
 
 BOOL TestDirectSoundBasics(HMODULE a, HMODULE b);
+BOOL TestDirectSoundChurn(HMODULE a, HMODULE b);
+BOOL TestDirectSoundVoices(HMODULE a, HMODULE b);
 BOOL TestDirectSoundCompact(HMODULE a, HMODULE b);
 BOOL TestDirectSoundCreate(HMODULE a, HMODULE b);
 BOOL TestDirectSoundCreateSoundBufferPrimary(HMODULE a, HMODULE b);
@@ -37,4 +39,5 @@ BOOL TestDirectSoundDuplicateSecondaryNotify(HMODULE a, HMODULE b);
 BOOL TestDirectSoundEnumerateA(HMODULE a, HMODULE b);
 BOOL TestDirectSoundEnumerateW(HMODULE a, HMODULE b);
 BOOL TestDirectSoundGetCaps(HMODULE a, HMODULE b);
+BOOL TestDirectSoundHeadless(HMODULE a, HMODULE b);
 BOOL TestDirectSoundSetCooperativeLevel(HMODULE a, HMODULE b);
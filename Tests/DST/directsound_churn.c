@@ -0,0 +1,191 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdio.h>
+
+#include "directsound.h"
+#include "wnd.h"
+
+#define WINDOW_NAME "DirectSound Churn"
+
+#define CHURN_ITERATION_COUNT   1000
+#define CHURN_BUFFER_COUNT      16
+
+// Plays and stops a buffer and its duplicate, the duplicate plays on its own.
+static BOOL TestDirectSoundChurnPlay(LPDIRECTSOUNDBUFFER pDSB, LPDIRECTSOUNDBUFFER pDuplicate) {
+    DWORD status = 0, duplicate = 0;
+
+    if (FAILED(IDirectSoundBuffer_Play(pDSB, 0, 0, DSBPLAY_LOOPING))
+        || FAILED(IDirectSoundBuffer_GetStatus(pDSB, &status))
+        || FAILED(IDirectSoundBuffer_GetStatus(pDuplicate, &duplicate))) {
+        return FALSE;
+    }
+
+    if (!(status & DSBSTATUS_PLAYING) || (duplicate & DSBSTATUS_PLAYING)) {
+        return FALSE;
+    }
+
+    if (FAILED(IDirectSoundBuffer_Stop(pDSB))
+        || FAILED(IDirectSoundBuffer_GetStatus(pDSB, &status))) {
+        return FALSE;
+    }
+
+    return !(status & DSBSTATUS_PLAYING);
+}
+
+// Creates, duplicates, plays and releases buffers over and over. On DeltaSound the memory in use
+// must not grow past the first iteration, which warms up the caches, and no realtime rule may be broken.
+static BOOL TestDirectSoundChurnRun(HMODULE module, LPDIRECTSOUND pDS, LPDSBUFFERDESC pDesc, PLONGLONG pllTicks) {
+    LPDIRECTSOUNDBUFFER buffers[2 * CHURN_BUFFER_COUNT];
+    ZeroMemory(buffers, sizeof(buffers));
+
+    DSPROPERTY_DELTASOUND_MEMORY_DATA before, after;
+    ZeroMemory(&before, sizeof(DSPROPERTY_DELTASOUND_MEMORY_DATA));
+    ZeroMemory(&after, sizeof(DSPROPERTY_DELTASOUND_MEMORY_DATA));
+
+    BOOL measured = FALSE;
+
+    LARGE_INTEGER start, end;
+    QueryPerformanceCounter(&start);
+
+    BOOL result = TRUE;
+
+    for (int i = 0; i < CHURN_ITERATION_COUNT && result; i++) {
+        for (int k = 0; k < CHURN_BUFFER_COUNT; k++) {
+            if (FAILED(IDirectSound_CreateSoundBuffer(pDS, pDesc, &buffers[2 * k], NULL))
+                || FAILED(IDirectSound_DuplicateSoundBuffer(pDS, buffers[2 * k], &buffers[2 * k + 1]))) {
+                result = FALSE;
+                break;
+            }
+        }
+
+        if (result && !TestDirectSoundChurnPlay(buffers[0], buffers[1])) {
+            result = FALSE;
+        }
+
+        for (int k = 0; k < 2 * CHURN_BUFFER_COUNT; k++) {
+            RELEASE(buffers[k]);
+        }
+
+        if (i == 0) {
+            measured = SUCCEEDED(GetDeltaSoundMemory(module, &before));
+        }
+    }
+
+    QueryPerformanceCounter(&end);
+
+    *pllTicks = end.QuadPart - start.QuadPart;
+
+    if (result && measured) {
+        if (FAILED(GetDeltaSoundMemory(module, &after))) {
+            return FALSE;
+        }
+
+        if (before.LiveBytes < after.LiveBytes || before.Violations != after.Violations) {
+            return FALSE;
+        }
+    }
+
+    return result;
+}
+
+BOOL TestDirectSoundChurn(HMODULE a, HMODULE b) {
+    if (a == NULL || b == NULL) {
+        return FALSE;
+    }
+
+    if (!RegisterWindowClass(WINDOW_NAME)) {
+        return FALSE;
+    }
+
+    LPDIRECTSOUNDCREATE dsca = GetDirectSoundCreate(a);
+    LPDIRECTSOUNDCREATE dscb = GetDirectSoundCreate(b);
+
+    if (dsca == NULL || dscb == NULL) {
+        return FALSE;
+    }
+
+    LPDIRECTSOUND dsa = NULL, dsb = NULL;
+
+    const HRESULT ra = dsca(NULL, &dsa, NULL);
+    const HRESULT rb = dscb(NULL, &dsb, NULL);
+
+    if (ra != rb) {
+        return FALSE;
+    }
+
+    BOOL result = TRUE;
+
+    HWND wa = InitWindow(WINDOW_NAME);
+    HWND wb = InitWindow(WINDOW_NAME);
+
+    if (wa == NULL || wb == NULL || dsa == NULL || dsb == NULL) {
+        result = FALSE;
+        goto exit;
+    }
+
+    if (FAILED(IDirectSound_SetCooperativeLevel(dsa, wa, DSSCL_PRIORITY))
+        || FAILED(IDirectSound_SetCooperativeLevel(dsb, wb, DSSCL_PRIORITY))) {
+        result = FALSE;
+        goto exit;
+    }
+
+    WAVEFORMATEX format;
+    InitializeWaveFormat(&format, 2, 22050, 16);
+
+    DSBUFFERDESC desc;
+    InitializeDirectSoundBufferDesc(&desc,
+        DSBCAPS_CTRLFREQUENCY | DSBCAPS_CTRLPAN | DSBCAPS_CTRLVOLUME | DSBCAPS_CTRLPOSITIONNOTIFY,
+        format.nAvgBytesPerSec / 10, &format);
+
+    LONGLONG ta = 0, tb = 0;
+
+    if (!TestDirectSoundChurnRun(a, dsa, &desc, &ta) || !TestDirectSoundChurnRun(b, dsb, &desc, &tb)) {
+        result = FALSE;
+        goto exit;
+    }
+
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+
+    printf("%.3f ms vs %.3f ms\t",
+        1000.0 * (double)ta / (double)frequency.QuadPart,
+        1000.0 * (double)tb / (double)frequency.QuadPart);
+
+exit:
+    if (wa != NULL) {
+        DestroyWindow(wa);
+    }
+
+    if (wb != NULL) {
+        DestroyWindow(wb);
+    }
+
+    UnregisterClassA(WINDOW_NAME, GetModuleHandleA(NULL));
+
+    RELEASE(dsa);
+    RELEASE(dsb);
+
+    return result;
+}
@@ -0,0 +1,292 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdio.h>
+
+#include "directsound.h"
+#include "synth.h"
+#include "wnd.h"
+
+#define WINDOW_NAME "DirectSound Headless"
+
+#define HEADLESS_MODULE_NAME    "deltasound_headless.dll"
+#define HEADLESS_VARIABLE_COUNT 2
+#define HEADLESS_EVENT_COUNT    3
+#define HEADLESS_SECONDS        1
+#define HEADLESS_TIMEOUT        10000   // In milliseconds
+
+// DeltaSound reads its settings once, when it is loaded, so a copy of it is loaded with these set.
+// It then renders to no endpoint on the virtual clock, faster than real time and the same on every machine.
+static const LPCSTR HeadlessVariables[HEADLESS_VARIABLE_COUNT][2] = {
+    { "DELTASOUND_BACKEND", "null" },
+    { "DELTASOUND_VIRTUAL_CLOCK", "1" }
+};
+
+static HMODULE LoadHeadlessModule(HMODULE module, LPSTR pszPath) {
+    CHAR source[MAX_PATH];
+    CHAR folder[MAX_PATH];
+
+    if (GetModuleFileNameA(module, source, MAX_PATH) == 0
+        || GetTempPathA(MAX_PATH, folder) == 0
+        || snprintf(pszPath, MAX_PATH, "%s%s", folder, HEADLESS_MODULE_NAME) >= MAX_PATH) {
+        return NULL;
+    }
+
+    if (!CopyFileA(source, pszPath, FALSE)) {
+        return NULL;
+    }
+
+    for (int i = 0; i < HEADLESS_VARIABLE_COUNT; i++) {
+        SetEnvironmentVariableA(HeadlessVariables[i][0], HeadlessVariables[i][1]);
+    }
+
+    HMODULE instance = LoadLibraryA(pszPath);
+
+    for (int i = 0; i < HEADLESS_VARIABLE_COUNT; i++) {
+        SetEnvironmentVariableA(HeadlessVariables[i][0], NULL);
+    }
+
+    if (instance == NULL) {
+        DeleteFileA(pszPath);
+    }
+
+    return instance;
+}
+
+// Plays a second of a wave to its end, and checks the notifications, the positions and the diagnostics of the device.
+static BOOL TestDirectSoundHeadlessRun(HMODULE module, HWND wnd) {
+    LPDIRECTSOUNDCREATE dsc = GetDirectSoundCreate(module);
+
+    if (dsc == NULL) {
+        return FALSE;
+    }
+
+    BOOL result = FALSE;
+
+    LPDIRECTSOUND ds = NULL;
+    LPDIRECTSOUNDBUFFER dsb = NULL;
+    LPDIRECTSOUNDNOTIFY dsn = NULL;
+    LPKSPROPERTYSET ksp = NULL;
+
+    LPVOID wave = NULL;
+    DWORD wave_length = 0;
+
+    HANDLE events[HEADLESS_EVENT_COUNT];
+    ZeroMemory(events, sizeof(events));
+
+    for (int i = 0; i < HEADLESS_EVENT_COUNT; i++) {
+        if ((events[i] = CreateEventA(NULL, FALSE, FALSE, NULL)) == NULL) {
+            goto exit;
+        }
+    }
+
+    if (FAILED(dsc(NULL, &ds, NULL))
+        || FAILED(IDirectSound_SetCooperativeLevel(ds, wnd, DSSCL_PRIORITY))) {
+        goto exit;
+    }
+
+    WAVEFORMATEX format;
+    InitializeWaveFormat(&format, 2, 22050, 16);
+
+    if (!Synthesise(&format, 440.0f, (FLOAT)HEADLESS_SECONDS, &wave, &wave_length)) {
+        goto exit;
+    }
+
+    DSBUFFERDESC desc;
+    InitializeDirectSoundBufferDesc(&desc, DSBCAPS_CTRLPOSITIONNOTIFY | DSBCAPS_GLOBALFOCUS, wave_length, &format);
+
+    if (FAILED(IDirectSound_CreateSoundBuffer(ds, &desc, &dsb, NULL))) {
+        goto exit;
+    }
+
+    {
+        LPVOID a1 = NULL, a2 = NULL;
+        DWORD l1 = 0, l2 = 0;
+
+        if (FAILED(IDirectSoundBuffer_Lock(dsb, 0, 0, &a1, &l1, &a2, &l2, DSBLOCK_ENTIREBUFFER))) {
+            goto exit;
+        }
+
+        CopyMemory(a1, wave, min(l1, wave_length));
+
+        if (FAILED(IDirectSoundBuffer_Unlock(dsb, a1, l1, a2, l2))) {
+            goto exit;
+        }
+    }
+
+    const DWORD half = wave_length / (2 * format.nBlockAlign) * format.nBlockAlign;
+
+    DSBPOSITIONNOTIFY positions[HEADLESS_EVENT_COUNT] = {
+        { half, events[0] },
+        { wave_length - format.nBlockAlign, events[1] },
+        { DSBPN_OFFSETSTOP, events[2] }
+    };
+
+    if (FAILED(IDirectSoundBuffer_QueryInterface(dsb, &IID_IDirectSoundNotify, &dsn))
+        || FAILED(IDirectSoundNotify_SetNotificationPositions(dsn, HEADLESS_EVENT_COUNT, positions))) {
+        goto exit;
+    }
+
+    const ULONGLONG start = GetTickCount64();
+
+    if (FAILED(IDirectSoundBuffer_Play(dsb, 0, 0, 0))) {
+        goto exit;
+    }
+
+    DWORD play = 0, write = 0, status = 0;
+
+    if (WaitForSingleObject(events[0], HEADLESS_TIMEOUT) != WAIT_OBJECT_0) {
+        goto exit;
+    }
+
+    // The position is read before the status, a cursor short of the notification is only allowed once the buffer ended.
+    if (FAILED(IDirectSoundBuffer_GetCurrentPosition(dsb, &play, &write))
+        || FAILED(IDirectSoundBuffer_GetStatus(dsb, &status))) {
+        goto exit;
+    }
+
+    if (play < half && (status & DSBSTATUS_PLAYING)) {
+        goto exit;
+    }
+
+    if (WaitForSingleObject(events[1], HEADLESS_TIMEOUT) != WAIT_OBJECT_0
+        || WaitForSingleObject(events[2], HEADLESS_TIMEOUT) != WAIT_OBJECT_0) {
+        goto exit;
+    }
+
+    // On the virtual clock the wave plays out faster than real time.
+    if (HEADLESS_SECONDS * 1000 <= GetTickCount64() - start) {
+        goto exit;
+    }
+
+    // A buffer that played to its end stops and rewinds.
+    if (FAILED(IDirectSoundBuffer_GetStatus(dsb, &status))
+        || FAILED(IDirectSoundBuffer_GetCurrentPosition(dsb, &play, &write))) {
+        goto exit;
+    }
+
+    if ((status & DSBSTATUS_PLAYING) || play != 0) {
+        goto exit;
+    }
+
+    if ((ksp = GetDeltaSoundPropertySet(module)) == NULL) {
+        goto exit;
+    }
+
+    {
+        DSPROPERTY_DELTASOUND_DEVICE_DATA device;
+        ZeroMemory(&device, sizeof(DSPROPERTY_DELTASOUND_DEVICE_DATA));
+
+        DSPROPERTY_DELTASOUND_MEMORY_DATA memory;
+        ZeroMemory(&memory, sizeof(DSPROPERTY_DELTASOUND_MEMORY_DATA));
+
+        ULONG length = 0;
+
+        if (FAILED(IKsPropertySet_Get(ksp, &DSPROPSETID_DeltaSound, DSPROPERTY_DELTASOUND_DEVICE,
+            NULL, 0, &device, sizeof(DSPROPERTY_DELTASOUND_DEVICE_DATA), &length))
+            || FAILED(IKsPropertySet_Get(ksp, &DSPROPSETID_DeltaSound, DSPROPERTY_DELTASOUND_MEMORY,
+                NULL, 0, &memory, sizeof(DSPROPERTY_DELTASOUND_MEMORY_DATA), &length))) {
+            goto exit;
+        }
+
+        if (IsEqualGUID(&GUID_NULL, &device.DeviceId) || memory.Violations != 0) {
+            goto exit;
+        }
+
+        printf("%lu ms latency, %llu underrun(s)\t", device.Latency, device.Underruns);
+    }
+
+    result = TRUE;
+
+exit:
+    RELEASE(ksp);
+    RELEASE(dsn);
+    RELEASE(dsb);
+    RELEASE(ds);
+
+    for (int i = 0; i < HEADLESS_EVENT_COUNT; i++) {
+        if (events[i] != NULL) {
+            CloseHandle(events[i]);
+        }
+    }
+
+    if (wave != NULL) {
+        free(wave);
+    }
+
+    return result;
+}
+
+BOOL TestDirectSoundHeadless(HMODULE a, HMODULE b) {
+    if (a == NULL || b == NULL) {
+        return FALSE;
+    }
+
+    if (!RegisterWindowClass(WINDOW_NAME)) {
+        return FALSE;
+    }
+
+    BOOL result = TRUE;
+    HWND wnd = InitWindow(WINDOW_NAME);
+
+    if (wnd == NULL) {
+        result = FALSE;
+        goto exit;
+    }
+
+    // Only DeltaSound has the settings, the system DirectSound is left out.
+    HMODULE modules[2] = { a, b };
+
+    for (size_t i = 0; i < _countof(modules) && result; i++) {
+        LPKSPROPERTYSET ksp = GetDeltaSoundPropertySet(modules[i]);
+
+        if (ksp == NULL) {
+            continue;
+        }
+
+        RELEASE(ksp);
+
+        CHAR path[MAX_PATH];
+        HMODULE module = LoadHeadlessModule(modules[i], path);
+
+        if (module == NULL) {
+            result = FALSE;
+            break;
+        }
+
+        result = TestDirectSoundHeadlessRun(module, wnd);
+
+        FreeLibrary(module);
+        DeleteFileA(path);
+    }
+
+exit:
+    if (wnd != NULL) {
+        DestroyWindow(wnd);
+    }
+
+    UnregisterClassA(WINDOW_NAME, GetModuleHandleA(NULL));
+
+    return result;
+}
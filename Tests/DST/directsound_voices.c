@@ -0,0 +1,281 @@
+/*
+MIT License
+
+Copyright (c) 2025 Eugene Kirian
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdio.h>
+
+#include "directsound.h"
+#include "synth.h"
+#include "wnd.h"
+
+#define WINDOW_NAME "DirectSound Voices"
+
+#define VOICE_COUNT                 512
+#define VOICE_PLAY_SECONDS          5
+#define VOICE_ADVANCE_MILLISECONDS  250     // Not a whole number of loops at any of the frequencies
+
+static ULONGLONG GetProcessCpuTime(VOID) {
+    FILETIME creation, exit, kernel, user;
+
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        return 0;
+    }
+
+    ULARGE_INTEGER k, u;
+
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+
+    return k.QuadPart + u.QuadPart;
+}
+
+// Checks that every voice plays, and that its play cursor moves.
+static BOOL TestDirectSoundVoicesPlaying(LPDIRECTSOUNDBUFFER* pBuffers) {
+    DWORD positions[VOICE_COUNT];
+
+    for (int i = 0; i < VOICE_COUNT; i++) {
+        DWORD status = 0, write = 0;
+
+        if (FAILED(IDirectSoundBuffer_GetStatus(pBuffers[i], &status))
+            || FAILED(IDirectSoundBuffer_GetCurrentPosition(pBuffers[i], &positions[i], &write))) {
+            return FALSE;
+        }
+
+        if (!(status & DSBSTATUS_PLAYING)) {
+            return FALSE;
+        }
+    }
+
+    Sleep(VOICE_ADVANCE_MILLISECONDS);
+
+    for (int i = 0; i < VOICE_COUNT; i++) {
+        DWORD play = 0, write = 0;
+
+        if (FAILED(IDirectSoundBuffer_GetCurrentPosition(pBuffers[i], &play, &write))) {
+            return FALSE;
+        }
+
+        if (play == positions[i]) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+// Plays many voices of the same wave at once, and measures the processor time the process spends meanwhile.
+// On DeltaSound the render thread must not break a realtime rule, however many voices it mixes.
+static BOOL TestDirectSoundVoicesRun(HMODULE module, LPDIRECTSOUND pDS, LPDSBUFFERDESC pDesc,
+    LPVOID pWave, DWORD dwWaveLength, PULONGLONG pullTime) {
+    LPDIRECTSOUNDBUFFER buffers[VOICE_COUNT];
+    ZeroMemory(buffers, sizeof(buffers));
+
+    DSPROPERTY_DELTASOUND_MEMORY_DATA before, after;
+    ZeroMemory(&before, sizeof(DSPROPERTY_DELTASOUND_MEMORY_DATA));
+    ZeroMemory(&after, sizeof(DSPROPERTY_DELTASOUND_MEMORY_DATA));
+
+    const BOOL measured = SUCCEEDED(GetDeltaSoundMemory(module, &before));
+
+    BOOL result = FALSE;
+
+    if (FAILED(IDirectSound_CreateSoundBuffer(pDS, pDesc, &buffers[0], NULL))) {
+        return FALSE;
+    }
+
+    LPVOID a1 = NULL, a2 = NULL;
+    DWORD l1 = 0, l2 = 0;
+
+    if (FAILED(IDirectSoundBuffer_Lock(buffers[0], 0, 0, &a1, &l1, &a2, &l2, DSBLOCK_ENTIREBUFFER))) {
+        goto exit;
+    }
+
+    CopyMemory(a1, pWave, min(l1, dwWaveLength));
+
+    if (FAILED(IDirectSoundBuffer_Unlock(buffers[0], a1, l1, a2, l2))) {
+        goto exit;
+    }
+
+    // Every voice gets its own volume, pan and frequency, so that none of them can share the work of another.
+    for (int i = 1; i < VOICE_COUNT; i++) {
+        if (FAILED(IDirectSound_DuplicateSoundBuffer(pDS, buffers[0], &buffers[i]))) {
+            goto exit;
+        }
+    }
+
+    for (int i = 0; i < VOICE_COUNT; i++) {
+        if (FAILED(IDirectSoundBuffer_SetVolume(buffers[i], -5000 - (i % 16) * 100))
+            || FAILED(IDirectSoundBuffer_SetPan(buffers[i], (i % 21 - 10) * 1000))
+            || FAILED(IDirectSoundBuffer_SetFrequency(buffers[i], pDesc->lpwfxFormat->nSamplesPerSec + (i % 32) * 100))) {
+            goto exit;
+        }
+    }
+
+    const ULONGLONG start = GetProcessCpuTime();
+
+    for (int i = 0; i < VOICE_COUNT; i++) {
+        if (FAILED(IDirectSoundBuffer_Play(buffers[i], 0, 0, DSBPLAY_LOOPING))) {
+            goto exit;
+        }
+    }
+
+    Sleep(VOICE_PLAY_SECONDS * 1000);
+
+    *pullTime = GetProcessCpuTime() - start;
+
+    if (!TestDirectSoundVoicesPlaying(buffers)) {
+        goto exit;
+    }
+
+    for (int i = 0; i < VOICE_COUNT; i++) {
+        DWORD status = 0;
+
+        if (FAILED(IDirectSoundBuffer_Stop(buffers[i]))
+            || FAILED(IDirectSoundBuffer_GetStatus(buffers[i], &status))
+            || (status & DSBSTATUS_PLAYING)) {
+            goto exit;
+        }
+    }
+
+    if (measured) {
+        if (FAILED(GetDeltaSoundMemory(module, &after)) || before.Violations != after.Violations) {
+            goto exit;
+        }
+    }
+
+    result = TRUE;
+
+exit:
+    for (int i = VOICE_COUNT - 1; i >= 0; i--) {
+        RELEASE(buffers[i]);
+    }
+
+    return result;
+}
+
+BOOL TestDirectSoundVoices(HMODULE a, HMODULE b) {
+    if (a == NULL || b == NULL) {
+        return FALSE;
+    }
+
+    if (!RegisterWindowClass(WINDOW_NAME)) {
+        return FALSE;
+    }
+
+    LPDIRECTSOUNDCREATE dsca = GetDirectSoundCreate(a);
+    LPDIRECTSOUNDCREATE dscb = GetDirectSoundCreate(b);
+
+    if (dsca == NULL || dscb == NULL) {
+        return FALSE;
+    }
+
+    LPDIRECTSOUND dsa = NULL, dsb = NULL;
+
+    const HRESULT ra = dsca(NULL, &dsa, NULL);
+    const HRESULT rb = dscb(NULL, &dsb, NULL);
+
+    if (ra != rb) {
+        return FALSE;
+    }
+
+    BOOL result = TRUE;
+    LPVOID wave = NULL;
+
+    HWND wa = InitWindow(WINDOW_NAME);
+    HWND wb = InitWindow(WINDOW_NAME);
+
+    if (wa == NULL || wb == NULL || dsa == NULL || dsb == NULL) {
+        result = FALSE;
+        goto exit;
+    }
+
+    if (FAILED(IDirectSound_SetCooperativeLevel(dsa, wa, DSSCL_PRIORITY))
+        || FAILED(IDirectSound_SetCooperativeLevel(dsb, wb, DSSCL_PRIORITY))) {
+        result = FALSE;
+        goto exit;
+    }
+
+    WAVEFORMATEX format;
+    InitializeWaveFormat(&format, 2, 22050, 16);
+
+    DWORD wave_length = 0;
+
+    if (!Synthesise(&format, 440.0f, 1.0f /* seconds */, &wave, &wave_length)) {
+        result = FALSE;
+        goto exit;
+    }
+
+    DSBUFFERDESC desc;
+    InitializeDirectSoundBufferDesc(&desc,
+        DSBCAPS_CTRLFREQUENCY | DSBCAPS_CTRLPAN | DSBCAPS_CTRLVOLUME | DSBCAPS_GLOBALFOCUS,
+        wave_length, &format);
+
+    ULONGLONG ta = 0, tb = 0;
+
+    ShowWindow(wa, SW_SHOW);
+    UpdateWindow(wa);
+
+    if (!TestDirectSoundVoicesRun(a, dsa, &desc, wave, wave_length, &ta)) {
+        result = FALSE;
+    }
+
+    ShowWindow(wa, SW_HIDE);
+    UpdateWindow(wa);
+
+    ShowWindow(wb, SW_SHOW);
+    UpdateWindow(wb);
+
+    if (result && !TestDirectSoundVoicesRun(b, dsb, &desc, wave, wave_length, &tb)) {
+        result = FALSE;
+    }
+
+    ShowWindow(wb, SW_HIDE);
+    UpdateWindow(wb);
+
+    if (result) {
+        // Processor time is counted in 100 nanosecond units.
+        printf("%.3f ms vs %.3f ms per second\t",
+            (double)ta / (10000.0 * VOICE_PLAY_SECONDS), (double)tb / (10000.0 * VOICE_PLAY_SECONDS));
+    }
+
+exit:
+    if (wave != NULL) {
+        free(wave);
+    }
+
+    if (wa != NULL) {
+        DestroyWindow(wa);
+    }
+
+    if (wb != NULL) {
+        DestroyWindow(wb);
+    }
+
+    UnregisterClassA(WINDOW_NAME, GetModuleHandleA(NULL));
+
+    RELEASE(dsa);
+    RELEASE(dsb);
+
+    return result;
+}
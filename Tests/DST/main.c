@@ -117,6 +117,10 @@ int main(int argc, char** argv) {
     TEST(DirectSoundDuplicateSecondaryNotify);
     // TODO duplicate with spatial buffers
 
+    TEST(DirectSoundChurn);
+    TEST(DirectSoundVoices);
+    TEST(DirectSoundHeadless);
+
     TEST(DirectSoundCaptureCreate);
     TEST(DirectSoundCaptureBasics);
 